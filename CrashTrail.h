@@ -0,0 +1,175 @@
+#pragma once
+/**
+ * @file CrashTrail.h
+ * @brief Brødkrummer fra core1 i no-init RAM – overlever watchdog-reset.
+ *
+ * Core1 skriver ved hvert trin i loop1() hvor den er (CrumbStage), seneste
+ * I2C-operation (CrumbI2C) og millis(). Den aktuelle position står altid i
+ * cur; trinene i 1 Hz-tick'et lægges desuden i en ring på CRASHTRAIL_SIZE
+ * krummer, så forløbet op til et hæng kan ses.
+ *
+ * Data ligger i sektionen .uninitialized_data, som hverken nulstilles eller
+ * initialiseres ved boot. Efter et watchdog-reset er RAM intakt, og core0
+ * skriver i setup() krummerne til hardware.log (crashTrailDump) før core1
+ * starter igen. Magic + gyldige index afgør om indholdet er brugbart (efter
+ * strømsvigt er RAM tilfældigt).
+ *
+ * Kun core1 skriver (volatile, så lagringen sker i programrækkefølge);
+ * core0 læser kun ved boot mens core1 venter.
+ */
+
+#include <Arduino.h>
+#include <cstdint>
+
+#define CRASHTRAIL_SIZE   32            // Potens af 2
+#define CRASHTRAIL_MAGIC  0xC0DECAFEu
+
+static_assert((CRASHTRAIL_SIZE & (CRASHTRAIL_SIZE - 1)) == 0, "CRASHTRAIL_SIZE skal være en potens af 2");
+
+enum CrumbStage : uint8_t {
+    STAGE_NONE,
+    STAGE_LOOP,         // Start af loop1 (timere)
+    STAGE_TICK,         // 1 Hz tick begynder
+    STAGE_VEML,         // VEML7700 læsning
+    STAGE_VEML_RESET,   // Wire reset efter læsefejl
+    STAGE_AUTOINIT,     // automatik->initFromNow
+    STAGE_BMP280,       // BMP280 læsning
+    STAGE_BMP_RESET,    // Wire1 reset efter dårlige læsninger
+    STAGE_HISTORY,      // Sensorhistorik
+    STAGE_SWITCH,       // HW-kontakt / tvungen on
+    STAGE_AUTOMATIK,    // automatik->update (param_mutex)
+    STAGE_CPUTEMP,      // analogReadTemp
+    STAGE_LYS_MUTEX,    // lys_mutex sektion (slider fra web)
+    STAGE_PUBLISH,      // publishStatus
+    STAGE_COUNT
+};
+
+enum CrumbI2C : uint8_t {
+    I2C_NONE,
+    I2C_VEML_READLUX,
+    I2C_VEML_BEGIN,
+    I2C_BMP_TEMP,
+    I2C_BMP_PRESSURE,
+    I2C_BMP_BEGIN,
+    I2C_BUS_RECOVER,
+    I2C_COUNT
+};
+
+inline const char* crumbStageName(uint8_t s) {
+    static const char* const names[STAGE_COUNT] = {
+        "none", "loop", "tick", "veml", "veml_reset", "autoinit", "bmp280", "bmp_reset",
+        "history", "switch", "automatik", "cputemp", "lys_mutex", "publish"};
+    return s < STAGE_COUNT ? names[s] : "?";
+}
+
+inline const char* crumbI2CName(uint8_t op) {
+    static const char* const names[I2C_COUNT] = {
+        "none", "veml_readlux", "veml_begin", "bmp_temp", "bmp_pressure", "bmp_begin", "bus_recover"};
+    return op < I2C_COUNT ? names[op] : "?";
+}
+
+struct Crumb {
+    uint32_t ms;        // millis() på core1
+    uint8_t  stage;     // CrumbStage
+    uint8_t  i2c;       // Seneste CrumbI2C på dette tidspunkt
+    uint16_t tick;      // Tick-nummer (lave 16 bit) – grupperer krummer pr. sekund
+};
+
+/** Ligger i .uninitialized_data: ingen initialisering (trivial type uden default-værdier). */
+struct CrashTrailData {
+    uint32_t magic;
+    uint32_t head;              // Næste plads i ring (tæller)
+    uint32_t tickEpoch;         // UTC ved seneste tick
+    uint32_t tickMs;            // millis() ved seneste tick
+    uint16_t tick;
+    uint8_t  i2c;               // Seneste I2C-operation
+    uint8_t  reserved;
+    Crumb    cur;               // Aktuel position (også uden for tick)
+    Crumb    ring[CRASHTRAIL_SIZE];
+};
+
+extern volatile CrashTrailData crashTrail;
+
+/** Nulstil (core0 ved boot efter evt. dump, før core1 starter). */
+inline void crashTrailReset() {
+    crashTrail.head = 0;
+    crashTrail.tick = 0;
+    crashTrail.tickEpoch = 0;
+    crashTrail.tickMs = 0;
+    crashTrail.i2c = I2C_NONE;
+    crashTrail.cur.ms = 0;
+    crashTrail.cur.stage = STAGE_NONE;
+    crashTrail.cur.i2c = I2C_NONE;
+    crashTrail.cur.tick = 0;
+    crashTrail.magic = CRASHTRAIL_MAGIC;
+}
+
+/** Indeholder RAM et gyldigt spor fra forrige kørsel? */
+inline bool crashTrailValid() {
+    return crashTrail.magic == CRASHTRAIL_MAGIC && crashTrail.cur.stage < STAGE_COUNT &&
+           crashTrail.i2c < I2C_COUNT && crashTrail.head != 0;
+}
+
+/** Core1: aktuel position (kun cur – til trin der gentages hver 5 ms). */
+inline void crumbAt(CrumbStage s) {
+    crashTrail.cur.ms = millis();
+    crashTrail.cur.i2c = crashTrail.i2c;
+    crashTrail.cur.tick = crashTrail.tick;
+    crashTrail.cur.stage = s;
+}
+
+/** Core1: aktuel position + krumme i ringen. */
+inline void crumb(CrumbStage s) {
+    crumbAt(s);
+    uint32_t h = crashTrail.head;
+    volatile Crumb& c = crashTrail.ring[h & (CRASHTRAIL_SIZE - 1)];
+    c.ms = crashTrail.cur.ms;
+    c.stage = s;
+    c.i2c = crashTrail.i2c;
+    c.tick = crashTrail.tick;
+    crashTrail.head = h + 1;
+}
+
+/** Core1: lige før en I2C-transaktion. */
+inline void crumbI2C(CrumbI2C op) {
+    crashTrail.i2c = op;
+    crashTrail.cur.i2c = op;
+    crashTrail.cur.ms = millis();
+}
+
+/** Core1: nyt 1 Hz tick (UTC bruges til at tidsstemple krummerne ved dump). */
+inline void crumbTick(uint32_t epoch) {
+    crashTrail.tick++;
+    crashTrail.tickEpoch = epoch;
+    crashTrail.tickMs = millis();
+    crumb(STAGE_TICK);
+}
+
+/**
+ * @brief Skriv sporet til log via write(text, epoch): først én linje med hvor core1
+ *        stod, derefter ringens krummer (ældste først) tidsstemplet med UTC.
+ */
+template <typename Write>
+void crashTrailDump(Write write) {
+    char line[112];
+    auto epochAt = [](uint32_t ms) -> uint32_t {
+        if (crashTrail.tickEpoch == 0) return 0;
+        int32_t d = (int32_t)(ms - crashTrail.tickMs);
+        return crashTrail.tickEpoch + d / 1000;
+    };
+
+    uint32_t cms = crashTrail.cur.ms;
+    snprintf(line, sizeof(line), "CRASHTRAIL core1 stod i stage=%s i2c=%s (%lu ms efter tick %u)",
+             crumbStageName(crashTrail.cur.stage), crumbI2CName(crashTrail.cur.i2c),
+             (unsigned long)(cms - crashTrail.tickMs), (unsigned)crashTrail.cur.tick);
+    write(line, epochAt(cms));
+
+    uint32_t head = crashTrail.head;
+    uint32_t n = head < CRASHTRAIL_SIZE ? head : CRASHTRAIL_SIZE;
+    for (uint32_t i = head - n; i != head; i++) {
+        const volatile Crumb& c = crashTrail.ring[i & (CRASHTRAIL_SIZE - 1)];
+        snprintf(line, sizeof(line), "CRASHTRAIL tick=%u ms=%lu stage=%s i2c=%s", (unsigned)c.tick,
+                 (unsigned long)c.ms, crumbStageName(c.stage), crumbI2CName(c.i2c));
+        write(line, epochAt(c.ms));
+    }
+}
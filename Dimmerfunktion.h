@@ -136,6 +136,10 @@ public:
             startSoftStart(nyvaerdi);
         } else if (nyvaerdi < aktuelprocentvaerdi) {
             startSoftSluk(nyvaerdi);
+        } else {
+            // Allerede på målet: stop en igangværende rampe mod et tidligere mål
+            softstart_aktiv = false;
+            softsluk_aktiv = false;
         }
     }
 
@@ -0,0 +1,76 @@
+#pragma once
+/**
+ * @file EpochClock.h
+ * @brief UTC-ur delt mellem cores: NTP-epoch + millis() ved sync.
+ *
+ * Core0 kalder set() ved hver vellykket NTP-sync. Begge cores kan kalde now(),
+ * som fremskriver med millis() – tiden er derfor aktuel hvert sekund, også
+ * mellem NTP-opdateringer (NTPClient synkroniserer kun hvert 60. sekund).
+ * Delingen sker via SeqLock, så ingen af cores venter på en mutex.
+ */
+
+#include <Arduino.h>
+#include <ctime>
+#include <cstdio>
+
+#include "SeqLock.h"
+
+class EpochClock {
+public:
+    /** Sæt ny UTC-epoch (core0, efter NTP-sync). */
+    void set(uint32_t utcEpoch) {
+        Base b{utcEpoch, millis()};
+        base.publish(b);
+    }
+
+    /** Aktuel UTC-epoch, 0 hvis tiden endnu ikke er sat. */
+    uint32_t now() const {
+        Base b;
+        if (!base.read(b) || b.epoch == 0) return 0;
+        return b.epoch + (millis() - b.ms) / 1000;
+    }
+
+    /** Aktuel UTC i millisekunder (til event-tidsstempler), 0 hvis tiden endnu ikke er sat. */
+    uint64_t nowMs() const {
+        Base b;
+        if (!base.read(b) || b.epoch == 0) return 0;
+        return (uint64_t)b.epoch * 1000u + (uint32_t)(millis() - b.ms);
+    }
+
+    bool valid() const { return now() != 0; }
+
+    /**
+     * Epoch → "YYYY-MM-DD HH:MM:SS" i lokal tid (TZ). Tom streng for 0.
+     * Felterne klampes til deres cifre, så char[20] altid rækker (uint32 epoch slutter i 2106).
+     */
+    static void formatLocal(uint32_t epoch, char* buf, size_t size) {
+        if (size == 0) return;
+        buf[0] = '\0';
+        if (epoch == 0) return;
+        time_t t = (time_t)epoch;
+        tm ti;
+        if (!localtime_r(&t, &ti)) return;
+        snprintf(buf, size, "%04u-%02u-%02u %02u:%02u:%02u",
+                 (unsigned)(ti.tm_year + 1900) % 10000u, (unsigned)(ti.tm_mon + 1) % 100u,
+                 (unsigned)ti.tm_mday % 100u, (unsigned)ti.tm_hour % 100u,
+                 (unsigned)ti.tm_min % 100u, (unsigned)ti.tm_sec % 100u);
+    }
+
+    /** Epoch → lokal dato som YYYYMMDD (fx 20261017). 0 for epoch 0. */
+    static uint32_t localDay(uint32_t epoch) {
+        if (epoch == 0) return 0;
+        time_t t = (time_t)epoch;
+        tm ti;
+        if (!localtime_r(&t, &ti)) return 0;
+        return (uint32_t)(ti.tm_year + 1900) * 10000u + (uint32_t)(ti.tm_mon + 1) * 100u + (uint32_t)ti.tm_mday;
+    }
+
+private:
+    struct Base {
+        uint32_t epoch;     // UTC ved sync
+        uint32_t ms;        // millis() ved sync
+    };
+    SeqLock<Base> base;
+};
+
+extern EpochClock epochClock;
@@ -0,0 +1,114 @@
+#pragma once
+/**
+ * @file EventRecord.h
+ * @brief Log-event koder, binært record-format (/events.bin) og tekstformatering.
+ *
+ * Fælles for firmware og værktøjer på PC (tools/eventdump.cpp) – kun standard C++.
+ *
+ * lyslogstate er både EventRing-koden (core1 → core0) og koden i filformatet,
+ * så værdierne er faste: nye koder tilføjes kun i enden.
+ *
+ * /events.bin er en række EventRecord på 12 bytes (little endian, ingen header).
+ * magic gør det muligt at opdage og springe over en halvt skrevet record.
+ * eventText() giver samme tekst som tekstloggene, så en dekoder kan genskabe
+ * nataktiv.log / pir.log / hardware.log linje for linje.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstddef>
+
+/** Event koder – EventRing (core1 → core0) og /events.bin. Værdierne må ikke ændres. */
+enum lyslogstate : uint8_t {
+    nataktivfalse     = 0,  // Nat → dag overgang
+    nataktivtrue      = 1,  // Dag → nat overgang
+    pir1_detection    = 2,  // PIR1 aktiveret
+    pir2_detection    = 3,  // PIR2 aktiveret
+    hwsw_on           = 4,  // Hardware switch ON
+    swsw_on           = 5,  // Software switch ON (fra web)
+    hwsw_off          = 6,  // Hardware switch OFF
+    swsw_off          = 7,  // Software switch OFF (fra web)
+    wdt_reset         = 8,  // Watchdog forårsagede reboot
+    i2c_reset_wire    = 9,  // VEML7700 I2C bus reset (Wire/I2C0), arg = antal resets
+    i2c_reset_wire1   = 10, // BMP280 I2C bus reset (Wire1/I2C1), arg = antal resets
+    astro_log_request = 11, // Request til core0 om at logge astro-data for i dag (logges ikke selv)
+    wifi_reconnect    = 12, // WiFi genforbundet, arg = IPv4 (første oktet i laveste byte)
+    boot_reboot       = 13, // Reboot fra firmware, arg = BootReason
+    event_dropped     = 14, // EventRing var fuld, arg = antal tabte events
+    LYSLOG_EVENT_COUNT
+};
+
+/** Årsag til boot_reboot (arg). */
+enum BootReason : uint8_t {
+    BOOT_WIFI_NOT_FOUND = 0
+};
+
+#define EVENT_RECORD_MAGIC 0xA5
+
+struct EventRecord {
+    uint32_t epoch;         // UTC sekunder
+    uint16_t ms;            // 0-999
+    uint8_t  code;          // lyslogstate
+    uint8_t  magic;         // EVENT_RECORD_MAGIC
+    uint32_t arg;
+};
+static_assert(sizeof(EventRecord) == 12, "EventRecord skal være 12 bytes");
+
+/** Hvilken tekstlog et event hører til (og hvilket log-flag der styrer det). */
+enum LogFileId : uint8_t { LOG_NAT, LOG_PIR, LOG_HW, LOG_NONE };
+
+inline LogFileId eventLogFile(uint8_t code) {
+    switch (code) {
+        case nataktivfalse:
+        case nataktivtrue:     return LOG_NAT;
+        case pir1_detection:
+        case pir2_detection:
+        case hwsw_on:
+        case swsw_on:
+        case hwsw_off:
+        case swsw_off:         return LOG_PIR;
+        case wdt_reset:
+        case i2c_reset_wire:
+        case i2c_reset_wire1:
+        case wifi_reconnect:
+        case boot_reboot:
+        case event_dropped:    return LOG_HW;
+        default:               return LOG_NONE;
+    }
+}
+
+inline const char* bootReasonName(uint32_t r) {
+    switch (r) {
+        case BOOT_WIFI_NOT_FOUND: return "WIFI_NOT_FOUND";
+        default:                  return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief Event-tekst som i tekstloggene (uden tidsstempel), fx "pir 1_ACTIVATED".
+ * @return Længde (som snprintf); buf er "" for ukendte koder.
+ */
+inline int eventText(uint8_t code, uint32_t arg, char* buf, size_t size) {
+    switch (code) {
+        case nataktivfalse:   return snprintf(buf, size, "NAT_AKTIV_OFF");
+        case nataktivtrue:    return snprintf(buf, size, "NAT_AKTIV_ON");
+        case pir1_detection:  return snprintf(buf, size, "pir 1_ACTIVATED");
+        case pir2_detection:  return snprintf(buf, size, "pir 2_ACTIVATED");
+        case hwsw_on:         return snprintf(buf, size, "Kontakt on_ACTIVATED");
+        case swsw_on:         return snprintf(buf, size, "Software on_ACTIVATED");
+        case hwsw_off:        return snprintf(buf, size, "Kontakt off_ACTIVATED");
+        case swsw_off:        return snprintf(buf, size, "Software off_ACTIVATED");
+        case wdt_reset:       return snprintf(buf, size, "WATCHDOG_RESET");
+        case i2c_reset_wire:  return snprintf(buf, size, "I2C_RESET_Wire");
+        case i2c_reset_wire1: return snprintf(buf, size, "I2C_RESET_Wire1");
+        case wifi_reconnect:
+            return snprintf(buf, size, "WIFI_RECONNECT %u.%u.%u.%u",
+                            (unsigned)(arg & 0xFF), (unsigned)((arg >> 8) & 0xFF),
+                            (unsigned)((arg >> 16) & 0xFF), (unsigned)(arg >> 24));
+        case boot_reboot:     return snprintf(buf, size, "BOOT_REBOOT %s", bootReasonName(arg));
+        case event_dropped:   return snprintf(buf, size, "EVENT_DROPPED %lu", (unsigned long)arg);
+        default:
+            if (size) buf[0] = '\0';
+            return 0;
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+/**
+ * @file EventRing.h
+ * @brief Lock-free SPSC ring til events fra core1 til core0 (tidsstempel + argument).
+ *
+ * Core1 er eneste producent og core0 eneste forbruger. Hvert event er en
+ * LysEvent på 16 bytes med UTC-tid i ms taget på core1 i det øjeblik det sker,
+ * så loggen viser hvornår PIR/I2C-eventet skete – ikke hvornår core0 nåede det.
+ *
+ * Hardware-FIFO'en (8 ord) bruges kun som dørklokke: postEvent() skubber
+ * EVENT_DOORBELL uden at vente, og én dørklokke får core0 til at tømme hele
+ * ringen. En tabt dørklokke betyder derfor intet. Er ringen fuld, tælles
+ * eventet i dropped() i stedet for at forsvinde sporløst.
+ *
+ * EVENT_RING_SIZE er en potens af 2 (index = tæller & maske). RP2040 har ingen
+ * data-cache, så head/tail behøver ikke ligge på hver sin cache-linje; records
+ * er 8-byte justerede og kopieres som én blok.
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include <cstdint>
+
+#include "EpochClock.h"
+
+#define EVENT_RING_SIZE 64              // Potens af 2
+#define EVENT_DOORBELL  0xE7E7E700u     // FIFO-ord: "ringen har data"
+
+static_assert((EVENT_RING_SIZE & (EVENT_RING_SIZE - 1)) == 0, "EVENT_RING_SIZE skal være en potens af 2");
+
+struct LysEvent {
+    uint64_t epochMs;       // UTC i ms da eventet skete (0 = tid ukendt)
+    uint16_t event;         // lyslogstate
+    uint16_t reserved;
+    uint32_t arg;           // Event-specifikt (fx antal I2C-resets)
+};
+static_assert(sizeof(LysEvent) == 16, "LysEvent skal være 16 bytes");
+
+class EventRing {
+public:
+    /** Producent (core1). Returnerer false og tæller drop hvis ringen er fuld. */
+    bool push(uint16_t event, uint32_t arg, uint64_t epochMs) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t t = tail.load(std::memory_order_acquire);
+        if (h - t >= EVENT_RING_SIZE) {
+            drops.store(drops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        LysEvent& e = buf[h & (EVENT_RING_SIZE - 1)];
+        e.epochMs = epochMs;
+        e.event = event;
+        e.reserved = 0;
+        e.arg = arg;
+        head.store(h + 1, std::memory_order_release);
+        if (h + 1 - t > high) high = h + 1 - t;
+        return true;
+    }
+
+    /** Forbruger (core0). false hvis ringen er tom. */
+    bool pop(LysEvent& out) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        uint32_t h = head.load(std::memory_order_acquire);
+        if (t == h) return false;
+        out = buf[t & (EVENT_RING_SIZE - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Antal events tabt fordi ringen var fuld (siden boot). */
+    uint32_t dropped() const { return drops.load(std::memory_order_relaxed); }
+
+    /** Højeste fyldning set af producenten. */
+    uint32_t highWater() const { return high; }
+
+private:
+    alignas(8) LysEvent buf[EVENT_RING_SIZE];
+    std::atomic<uint32_t> head{0};      // Skrives kun af core1
+    std::atomic<uint32_t> tail{0};      // Skrives kun af core0
+    std::atomic<uint32_t> drops{0};     // Skrives kun af core1
+    volatile uint32_t high = 0;         // Skrives kun af core1
+};
+
+extern EventRing eventRing;
+
+/** Post event fra core1: tidsstempel nu, ring + dørklokke (blokerer aldrig). */
+inline void postEvent(uint16_t event, uint32_t arg = 0) {
+    eventRing.push(event, arg, epochClock.nowMs());
+    rp2040.fifo.push_nb(EVENT_DOORBELL);
+}
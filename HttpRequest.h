@@ -0,0 +1,338 @@
+#pragma once
+/**
+ * @file HttpRequest.h
+ * @brief Allokeringsfri HTTP request-parser + compile-time route-tabel.
+ *
+ * HttpRequest tokeniserer request-linjen (metode, path, query) direkte i
+ * forbindelsens faste header-buffer (se WebServerEngine). Alle felter er
+ * slices (pointer + længde) ind i bufferen – der oprettes ingen String.
+ *
+ * Routing sker via FNV-1a hash af path i en switch. Hash-værdierne beregnes
+ * compile-time (constexpr), så to routes med samme hash giver compilerfejl
+ * (duplicate case), og prisen er den samme uanset header-størrelse.
+ */
+
+#include <Arduino.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+/** Del af request-bufferen (ikke NUL-termineret). */
+struct HttpSlice {
+    const char* p = nullptr;
+    uint16_t len = 0;
+
+    bool empty() const { return len == 0; }
+
+    bool eq(const char* s) const {
+        size_t n = strlen(s);
+        return n == len && memcmp(p, s, n) == 0;
+    }
+
+    /** Søg efter needle i slicen. Returnerer offset eller -1. */
+    int find(const char* needle) const {
+        size_t n = strlen(needle);
+        if (n == 0 || n > len) return -1;
+        for (uint16_t i = 0; i + n <= len; i++) {
+            if (memcmp(p + i, needle, n) == 0) return i;
+        }
+        return -1;
+    }
+
+    /** Som find(), men uden hensyn til store/små bogstaver (header-værdier). */
+    int findNoCase(const char* needle) const {
+        size_t n = strlen(needle);
+        if (n == 0 || n > len) return -1;
+        for (uint16_t i = 0; i + n <= len; i++) {
+            if (strncasecmp(p + i, needle, n) == 0) return i;
+        }
+        return -1;
+    }
+};
+
+// ------------------ FNV-1a hash (compile-time + runtime) ------------------
+constexpr uint32_t fnv1a(const char* s, uint32_t h = 2166136261u) {
+    return *s ? fnv1a(s + 1, (h ^ (uint8_t)*s) * 16777619u) : h;
+}
+
+inline uint32_t fnv1aSlice(const char* s, uint16_t len) {
+    uint32_t h = 2166136261u;
+    for (uint16_t i = 0; i < len; i++) h = (h ^ (uint8_t)s[i]) * 16777619u;
+    return h;
+}
+
+enum HttpMethod : uint8_t { METHOD_OTHER, METHOD_GET, METHOD_POST };
+
+// ------------------ Route-tabel ------------------
+// X(id, metode, path) – én linje pr. endpoint.
+#define WEB_ROUTES(X) \
+    X(ROOT,           METHOD_GET,  "/")                 \
+    X(INDEX,          METHOD_GET,  "/index.htm")        \
+    X(ON,             METHOD_GET,  "/on.htm")           \
+    X(OFF,            METHOD_GET,  "/off.htm")          \
+    X(STATUS,         METHOD_GET,  "/status.htm")       \
+    X(STATUSJSON,     METHOD_GET,  "/statusjson.htm")   \
+    X(EVENTS,         METHOD_GET,  "/events")           \
+    X(FAVICON,        METHOD_GET,  "/favicon.ico")      \
+    X(OPSAETNING,     METHOD_GET,  "/opsaetning.htm")   \
+    X(OPSAETDATA,     METHOD_GET,  "/opsaetdata.htm")   \
+    X(OPSAETCSS,      METHOD_GET,  "/opsaetning.css")   \
+    X(OPSAETJS,       METHOD_GET,  "/opsaetning.js")    \
+    X(LOGCONFIG,      METHOD_GET,  "/logconfig.htm")    \
+    X(GEMLOGCONFIG,   METHOD_GET,  "/gemlogconfig.htm") \
+    X(FILEBROWSER,    METHOD_GET,  "/filebrowser.htm")  \
+    X(DIRLIST,        METHOD_GET,  "/dirlist")          \
+    X(DOWNLOAD,       METHOD_GET,  "/download")         \
+    X(DELETE,         METHOD_GET,  "/delete")           \
+    X(APILOG,         METHOD_GET,  "/api/log")          \
+    X(APILOGTAIL,     METHOD_GET,  "/api/log/tail")     \
+    X(HISTORY,        METHOD_GET,  "/history")          \
+    X(APISCHEDULE,    METHOD_GET,  "/api/schedule")     \
+    X(DEBUGTIMING,    METHOD_GET,  "/debug/timing")     \
+    X(METRICS,        METHOD_GET,  "/metrics")          \
+    X(UPLOAD,         METHOD_POST, "/upload")
+
+enum WebRoute : uint8_t {
+    ROUTE_NONE,
+#define WEB_ROUTE_ENUM(id, m, path) ROUTE_##id,
+    WEB_ROUTES(WEB_ROUTE_ENUM)
+#undef WEB_ROUTE_ENUM
+    ROUTE_COUNT
+};
+
+/** Slå path op i route-tabellen. O(1): én hash + én memcmp. */
+inline WebRoute lookupRoute(const HttpSlice& path, HttpMethod& expectedMethod) {
+    const char* expect = nullptr;
+    WebRoute r = ROUTE_NONE;
+    switch (fnv1aSlice(path.p, path.len)) {
+#define WEB_ROUTE_CASE(id, m, pth) \
+        case fnv1a(pth): r = ROUTE_##id; expect = pth; expectedMethod = m; break;
+        WEB_ROUTES(WEB_ROUTE_CASE)
+#undef WEB_ROUTE_CASE
+        default: return ROUTE_NONE;
+    }
+    return path.eq(expect) ? r : ROUTE_NONE;
+}
+
+/** Path for en route (til debug/metrics). */
+inline const char* routePath(WebRoute r) {
+    switch (r) {
+#define WEB_ROUTE_NAME(id, m, pth) case ROUTE_##id: return pth;
+        WEB_ROUTES(WEB_ROUTE_NAME)
+#undef WEB_ROUTE_NAME
+        default: return "other";
+    }
+}
+
+// ------------------ Request ------------------
+class HttpRequest {
+public:
+    HttpMethod method = METHOD_OTHER;
+    HttpSlice  path;
+    HttpSlice  query;
+    bool       http11 = false;
+
+    const uint8_t* body = nullptr;   // Body-bytes modtaget sammen med headeren
+    uint16_t       bodyLen = 0;
+
+    /**
+     * @brief Tokenisér request-linje og header-område i buf (ingen kopiering).
+     * @param buf Header-buffer (skal leve mens requesten behandles).
+     * @param len Antal bytes i buf.
+     * @param headerEnd Index lige efter "\r\n\r\n".
+     * @return false ved ugyldig request-linje.
+     */
+    bool parse(const char* buf, uint16_t len, uint16_t headerEnd) {
+        base = buf;
+        hdrEnd = headerEnd;
+        body = (const uint8_t*)buf + headerEnd;
+        bodyLen = (uint16_t)(len - headerEnd);
+
+        const char* end = buf + headerEnd;
+        const char* p = buf;
+
+        // Metode
+        const char* sp = (const char*)memchr(p, ' ', end - p);
+        if (!sp) return false;
+        HttpSlice m{p, (uint16_t)(sp - p)};
+        method = m.eq("GET") ? METHOD_GET : (m.eq("POST") ? METHOD_POST : METHOD_OTHER);
+        p = sp + 1;
+
+        // Target: path [? query]
+        const char* lineEnd = (const char*)memchr(p, '\r', end - p);
+        if (!lineEnd) return false;
+        const char* tEnd = (const char*)memchr(p, ' ', lineEnd - p);
+        if (!tEnd) tEnd = lineEnd;
+
+        // Path slutter ved '?', ' ' eller '&' (ældre UI kalder fx "/on.htm&")
+        const char* q = p;
+        while (q < tEnd && *q != '?' && *q != '&') q++;
+        path = HttpSlice{p, (uint16_t)(q - p)};
+        if (q < tEnd && *q == '?') {
+            query = HttpSlice{q + 1, (uint16_t)(tEnd - q - 1)};
+        } else {
+            query = HttpSlice{};
+        }
+
+        HttpSlice ver{tEnd + 1, (uint16_t)(tEnd < lineEnd ? lineEnd - tEnd - 1 : 0)};
+        http11 = ver.eq("HTTP/1.1");
+
+        hdrStart = (uint16_t)(lineEnd + 2 - buf);
+        return path.len > 0 && path.p[0] == '/';
+    }
+
+    /** Rå query-værdi for key (ikke dekodet). */
+    bool queryValue(const char* key, HttpSlice& out) const {
+        size_t klen = strlen(key);
+        const char* p = query.p;
+        const char* end = query.p + query.len;
+        while (p && p < end) {
+            const char* amp = (const char*)memchr(p, '&', end - p);
+            const char* pairEnd = amp ? amp : end;
+            const char* eq = (const char*)memchr(p, '=', pairEnd - p);
+            const char* kEnd = eq ? eq : pairEnd;
+            if ((size_t)(kEnd - p) == klen && memcmp(p, key, klen) == 0) {
+                out.p = eq ? eq + 1 : pairEnd;
+                out.len = (uint16_t)(pairEnd - out.p);
+                return true;
+            }
+            p = amp ? amp + 1 : nullptr;
+        }
+        return false;
+    }
+
+    bool hasQuery(const char* key) const {
+        HttpSlice v;
+        return queryValue(key, v);
+    }
+
+    bool queryEq(const char* key, const char* value) const {
+        HttpSlice v;
+        return queryValue(key, v) && v.eq(value);
+    }
+
+    /**
+     * @brief URL-dekodet query-værdi ('+' → mellemrum, %XX) i out.
+     *        Ledende/efterstillede mellemrum fjernes.
+     */
+    bool queryParam(const char* key, char* out, size_t outSize) const {
+        if (outSize == 0) return false;
+        out[0] = '\0';
+        HttpSlice v;
+        if (!queryValue(key, v)) return false;
+        urlDecode(v, out, outSize);
+        trim(out);
+        return true;
+    }
+
+    bool queryInt(const char* key, int& out) const {
+        char tmp[16];
+        if (!copyValue(key, tmp, sizeof(tmp))) return false;
+        out = (int)strtol(tmp, nullptr, 10);
+        return true;
+    }
+
+    bool queryLong(const char* key, long& out) const {
+        char tmp[16];
+        if (!copyValue(key, tmp, sizeof(tmp))) return false;
+        out = strtol(tmp, nullptr, 10);
+        return true;
+    }
+
+    bool queryFloat(const char* key, float& out) const {
+        char tmp[24];
+        if (!copyValue(key, tmp, sizeof(tmp))) return false;
+        out = strtof(tmp, nullptr);
+        return true;
+    }
+
+    /** Header-værdi (navn matches case-insensitivt). */
+    bool header(const char* name, HttpSlice& out) const {
+        size_t nlen = strlen(name);
+        const char* p = base + hdrStart;
+        const char* end = base + hdrEnd;
+        while (p < end) {
+            const char* eol = (const char*)memchr(p, '\r', end - p);
+            if (!eol || eol == p) break;
+            if ((size_t)(eol - p) > nlen && p[nlen] == ':' && strncasecmp(p, name, nlen) == 0) {
+                const char* v = p + nlen + 1;
+                while (v < eol && *v == ' ') v++;
+                out.p = v;
+                out.len = (uint16_t)(eol - v);
+                return true;
+            }
+            p = eol + 2;
+        }
+        return false;
+    }
+
+    /** Content-Length header som tal (-1 hvis mangler). */
+    long contentLength() const {
+        HttpSlice v;
+        if (!header("Content-Length", v)) return -1;
+        char tmp[16];
+        size_t n = v.len < sizeof(tmp) - 1 ? v.len : sizeof(tmp) - 1;
+        memcpy(tmp, v.p, n);
+        tmp[n] = '\0';
+        return strtol(tmp, nullptr, 10);
+    }
+
+    /**
+     * @brief Ønsker klienten at genbruge forbindelsen?
+     *        HTTP/1.1: ja, medmindre "Connection: close". HTTP/1.0: kun ved "Connection: keep-alive".
+     */
+    bool wantsKeepAlive() const {
+        HttpSlice v;
+        bool has = header("Connection", v);
+        if (http11) return !(has && v.findNoCase("close") >= 0);
+        return has && v.findNoCase("keep-alive") >= 0;
+    }
+
+    static void urlDecode(const HttpSlice& v, char* out, size_t outSize) {
+        size_t o = 0;
+        for (uint16_t i = 0; i < v.len && o + 1 < outSize; i++) {
+            char c = v.p[i];
+            if (c == '+') {
+                c = ' ';
+            } else if (c == '%' && i + 2 < v.len) {
+                int hi = hexVal(v.p[i + 1]);
+                int lo = hexVal(v.p[i + 2]);
+                if (hi >= 0 && lo >= 0) {
+                    c = (char)((hi << 4) | lo);
+                    i += 2;
+                }
+            }
+            out[o++] = c;
+        }
+        out[o] = '\0';
+    }
+
+private:
+    const char* base = nullptr;
+    uint16_t hdrStart = 0;
+    uint16_t hdrEnd = 0;
+
+    bool copyValue(const char* key, char* out, size_t outSize) const {
+        HttpSlice v;
+        if (!queryValue(key, v)) return false;
+        size_t n = v.len < outSize - 1 ? v.len : outSize - 1;
+        memcpy(out, v.p, n);
+        out[n] = '\0';
+        return true;
+    }
+
+    static int hexVal(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    static void trim(char* s) {
+        size_t n = strlen(s);
+        while (n > 0 && s[n - 1] == ' ') s[--n] = '\0';
+        size_t start = 0;
+        while (s[start] == ' ') start++;
+        if (start > 0) memmove(s, s + start, n - start + 1);
+    }
+};
@@ -0,0 +1,147 @@
+#pragma once
+/**
+ * @file LoopTiming.h
+ * @brief Let instrumentering af loop1(): varighed pr. sektion med min/max/p99-histogram.
+ *
+ * TIMING_SCOPE(VEML) lægger et ScopedTiming-objekt i blokken; det læser RP2040's
+ * 1 MHz timer (time_us_32(), samme tæller som time_us_64) ved start og slut og
+ * lægger varigheden i sektionens histogram. Bucket b dækker [2^(b-1), 2^b) µs,
+ * så 24 faste buckets spænder fra < 1 µs til over 4 s (watchdog er 3 s).
+ *
+ * Core1 samler i sin egen tabel og publicerer den én gang i sekundet via
+ * SeqLock; /debug/timing læser kopien uden at forstyrre core1. ?reset=1 beder
+ * core1 nulstille ved næste publicering.
+ *
+ * Kompileres med -DLYS_TIMING=0 bliver TIMING_SCOPE/TIMING_PUBLISH til ingenting,
+ * og LoopTiming findes ikke – ingen RAM og ingen instruktioner i loop1().
+ */
+
+#include <atomic>
+#include <cstdint>
+
+#include "SeqLock.h"
+
+#ifndef LYS_TIMING
+#define LYS_TIMING 1
+#endif
+
+#define TIMING_BUCKETS 24
+
+// X(id, navn) – én linje pr. målt sektion
+#define TIMING_SECTIONS(X)               \
+    X(LOOP1,     "loop1_tick")           \
+    X(VEML,      "veml_readlux")         \
+    X(BMP280,    "bmp280_read")          \
+    X(AUTOMATIK, "automatik_update")     \
+    X(LYS_MUTEX, "lys_mutex")            \
+    X(CPUTEMP,   "analogreadtemp")       \
+    X(PUBLISH,   "publish_status")
+
+enum TimingSection : uint8_t {
+#define TIMING_SECTION_ENUM(id, name) TIMING_##id,
+    TIMING_SECTIONS(TIMING_SECTION_ENUM)
+#undef TIMING_SECTION_ENUM
+    TIMING_COUNT
+};
+
+inline const char* timingSectionName(uint8_t s) {
+    switch (s) {
+#define TIMING_SECTION_NAME(id, name) case TIMING_##id: return name;
+        TIMING_SECTIONS(TIMING_SECTION_NAME)
+#undef TIMING_SECTION_NAME
+        default: return "?";
+    }
+}
+
+/** Øvre grænse (µs, eksklusiv) for bucket b. */
+inline uint32_t timingBucketLimit(uint8_t b) {
+    return (b + 1 >= TIMING_BUCKETS) ? 0xFFFFFFFFu : (1u << b);
+}
+
+struct TimingStats {
+    uint32_t count = 0;
+    uint32_t minUs = 0;
+    uint32_t maxUs = 0;
+    uint64_t sumUs = 0;
+    uint32_t buckets[TIMING_BUCKETS] = {};
+
+    void add(uint32_t us) {
+        if (count == 0 || us < minUs) minUs = us;
+        if (us > maxUs) maxUs = us;
+        count++;
+        sumUs += us;
+        uint8_t b = us ? (uint8_t)(32 - __builtin_clz(us)) : 0;
+        buckets[b < TIMING_BUCKETS ? b : TIMING_BUCKETS - 1]++;
+    }
+
+    /** Percentil (fx 990 = p99) som bucket-grænse, højst maxUs. */
+    uint32_t percentileUs(uint16_t permille) const {
+        if (count == 0) return 0;
+        uint64_t want = ((uint64_t)count * permille + 999) / 1000;
+        uint64_t seen = 0;
+        for (uint8_t b = 0; b < TIMING_BUCKETS; b++) {
+            seen += buckets[b];
+            if (seen >= want) {
+                uint32_t lim = timingBucketLimit(b);
+                return lim < maxUs ? lim : maxUs;
+            }
+        }
+        return maxUs;
+    }
+};
+
+struct TimingTable {
+    uint32_t    sinceMs = 0;        // millis() ved sidste nulstilling
+    TimingStats s[TIMING_COUNT];
+};
+
+#if LYS_TIMING
+#include "hardware/timer.h"
+
+class LoopTiming {
+public:
+    /** Core1: læg én måling i sektionens histogram. */
+    void record(uint8_t section, uint32_t us) { local.s[section].add(us); }
+
+    /** Core1 (1 Hz): publicér tabellen; nulstil først hvis core0 har bedt om det. */
+    void publish(uint32_t nowMs) {
+        if (resetReq.exchange(false, std::memory_order_acquire)) {
+            local = TimingTable();
+            local.sinceMs = nowMs;
+        }
+        snap.publish(local);
+    }
+
+    /** Core0: seneste publicerede tabel. */
+    bool read(TimingTable& out) const { return snap.read(out); }
+
+    /** Core0: nulstil ved næste publish(). */
+    void requestReset() { resetReq.store(true, std::memory_order_release); }
+
+private:
+    TimingTable local;
+    SeqLock<TimingTable> snap;
+    std::atomic<bool> resetReq{false};
+};
+
+extern LoopTiming loopTiming;
+
+/** Måler blokkens varighed (konstruktør → destruktør). */
+class ScopedTiming {
+public:
+    explicit ScopedTiming(uint8_t section) : section(section), t0(time_us_32()) {}
+    ~ScopedTiming() { loopTiming.record(section, time_us_32() - t0); }
+
+private:
+    uint8_t  section;
+    uint32_t t0;
+};
+
+#define TIMING_CAT2(a, b) a##b
+#define TIMING_CAT(a, b) TIMING_CAT2(a, b)
+#define TIMING_SCOPE(id)     ScopedTiming TIMING_CAT(timingScope_, __LINE__)(TIMING_##id)
+#define TIMING_PUBLISH(ms)   loopTiming.publish(ms)
+#else
+#define TIMING_SCOPE(id)     do {} while (0)
+#define TIMING_PUBLISH(ms)   do {} while (0)
+#endif
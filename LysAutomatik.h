@@ -3,9 +3,12 @@
 #include <Arduino.h>
 #include <ctime>
 
-#include "AstroSun.h"
 #include "Dimmerfunktion.h"
 #include "LysParam.h"
+#include "LysModeStrategy.h"
+#include "LysSchedule.h"
+#include "StatusSnapshot.h"
+#include "EventRing.h"
 
 class LysAutomatik {
 private:
@@ -22,67 +25,38 @@ private:
     long timerE = 0;
 
     bool nataktiv = false;
+    int  levelA = 0;                // Aktuelt A-niveau (segment-modes: vindende segments niveau)
 
     long natdagdelayTimer = 0;
     long dagNatDelayTimer = 0;
     bool lastLuxOver = true;
 
-    int cachedY = -1, cachedM = -1, cachedD = -1;
-    AstroTimes cachedAstro;
+    DaySchedule schedule;           // Oversat dagsplan (Klokken/Astro)
+    uint32_t scheduleRev = 0;       // lysparamRev da planen blev oversat
 
-    static int toSec(int h, int m, int s = 0) { return h * 3600 + m * 60 + s; }
-    static int toMin(int h, int m) { return h * 60 + m; }
-
-    static bool inRangeSec(int nowSec, int startSec, int endSec) {
-        if (startSec == endSec) return true;
-        if (startSec < endSec)  return (nowSec >= startSec && nowSec < endSec);
-        return (nowSec >= startSec || nowSec < endSec);
-    }
-
-    static bool inRangeMin(int nowMin, int startMin, int endMin) {
-        if (startMin == endMin) return true;
-        if (startMin < endMin)  return (nowMin >= startMin && nowMin < endMin);
-        return (nowMin >= startMin || nowMin < endMin);
-    }
-
-    static int wrapMin(int m) {
-        while (m < 0) m += 1440;
-        while (m >= 1440) m -= 1440;
-        return m;
-    }
-
-    static bool toLocalTm(time_t t, tm& out) {
-        return localtime_r(&t, &out) != nullptr;
-    }
-
-    void ensureAstroCached(time_t ntpTid) {
-        tm ti;
-        if (!toLocalTm(ntpTid, ti)) return;
-        int y = ti.tm_year + 1900;
-        int m = ti.tm_mon + 1;
-        int d = ti.tm_mday;
-        if (y != cachedY || m != cachedM || d != cachedD || !cachedAstro.valid()) {
-            cachedAstro = AstroSun::computeLocalTimes(y, m, d, param.astroLat, param.astroLon);
-            cachedY = y; cachedM = m; cachedD = d;
+    /** Lokalt sekund fra midnat; planen forankres/oversættes kun ved dato-, DST- eller param-skift. */
+    bool localSec(time_t ntpTid, int& nowSec) {
+        bool changed = (scheduleRev != lysparamRev);
+        if (changed || !schedule.covers(ntpTid)) {
+            schedule.refresh(param, ntpTid, changed);
+            scheduleRev = lysparamRev;
         }
-    }
-
-    bool getAstroRiseSetMin(time_t ntpTid, int& sunriseMin, int& sunsetMin) {
-        ensureAstroCached(ntpTid);
-        if (!cachedAstro.valid()) return false;
-        sunriseMin = wrapMin(cachedAstro.sunriseMin + param.astroSunriseOffsetMin);
-        sunsetMin  = wrapMin(cachedAstro.sunsetMin  + param.astroSunsetOffsetMin);
+        if (!schedule.valid()) return false;
+        nowSec = schedule.secOf(ntpTid);
         return true;
     }
 
-    bool isSegmentMode() const {
-        return (param.styringsvalg == "Klokken" || param.styringsvalg == "Astro");
+    /** Dagsplanens entry for ntpTid, nullptr hvis lokal tid ikke kan bestemmes. */
+    const ScheduleEntry* entryAt(time_t ntpTid) {
+        int nowSec = 0;
+        if (!localSec(ntpTid, nowSec)) return nullptr;
+        return &schedule.at(nowSec);
     }
 
     void setNataktiv(bool newVal) {
         if (nataktiv == newVal) return;
         nataktiv = newVal;
-        if (param.lognataktiv) rp2040.fifo.push_nb(nataktiv ? nataktivtrue : nataktivfalse);
+        if (param.lognataktiv) postEvent(nataktiv ? nataktivtrue : nataktivfalse);
     }
 
     void resetLuxTimers() {
@@ -91,106 +65,40 @@ private:
         lastLuxOver = true;
     }
 
-    static int effectiveNightWday(int wday, int nowSec) {
-        if (wday < 0 || wday > 6) return wday;
-        if (nowSec < toSec(12, 0, 0)) return (wday + 6) % 7;
-        return wday;
-    }
-
-    // ---------- Segment (Klokken) ----------
-    bool klokWantAAndEnd(time_t ntpTid, int& outEndSec) {
-        tm timeinfo;
-        if (!toLocalTm(ntpTid, timeinfo)) {
-            outEndSec = toSec(param.slutKlokkeTimer, param.slutKlokkeMinutter, 0);
+    // ---------- Segment router (valg af kolonne: Mode::wantA) ----------
+    template <class Mode>
+    bool segmentWantAAndEnd(time_t ntpTid, int& outEndSec, int& outLevel) {
+        const ScheduleEntry* e = entryAt(ntpTid);
+        if (!e) {
+            outEndSec = DaySchedule::seg1EndSec(param);
+            outLevel = param.pwmA;
             return true;
         }
-        int nowSec = toSec(timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-        int wday = timeinfo.tm_wday;
-        auto dayAllowed = [&](uint8_t mask) -> bool {
-            if (wday < 0 || wday > 6) return true;
-            return (mask & (1u << wday)) != 0;
-        };
-        const int seg1End = toSec(param.slutKlokkeTimer, param.slutKlokkeMinutter, 0);
-        bool wantA;
-        if (seg1End < toSec(12, 0, 0)) {
-            wantA = (nowSec >= toSec(12, 0, 0)) || (nowSec < seg1End);
-        } else {
-            wantA = (nowSec < seg1End);
-        }
-        if (param.seg2Enabled && dayAllowed(param.seg2WeekMask)) {
-            int s2Start = toSec(param.seg2StartTimer, param.seg2StartMinutter, 0);
-            int s2End   = toSec(param.seg2SlutTimer,  param.seg2SlutMinutter,  0);
-            if (inRangeSec(nowSec, s2Start, s2End)) { outEndSec = s2End; return true; }
-        }
-        if (param.seg3Enabled && dayAllowed(param.seg3WeekMask)) {
-            int s3Start = toSec(param.seg3StartTimer, param.seg3StartMinutter, 0);
-            int s3End   = toSec(param.seg3SlutTimer,  param.seg3SlutMinutter,  0);
-            if (inRangeSec(nowSec, s3Start, s3End)) { outEndSec = s3End; return true; }
-        }
-        outEndSec = seg1End;
-        return wantA;
+        return Mode::wantA(*e, schedule.astroValid(), nataktiv, outEndSec, outLevel);
     }
 
-    // ---------- Segment (Astro) ----------
-    bool astroWantAAndEnd(time_t ntpTid, int& outEndSec) {
-        tm timeinfo;
-        if (!toLocalTm(ntpTid, timeinfo)) {
-            outEndSec = toSec(param.slutKlokkeTimer, param.slutKlokkeMinutter, 0);
-            return true;
-        }
-        int nowSec = toSec(timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-        int wdayEff = effectiveNightWday(timeinfo.tm_wday, nowSec);
-        auto dayAllowed = [&](uint8_t mask) -> bool {
-            if (wdayEff < 0 || wdayEff > 6) return true;
-            return (mask & (1u << wdayEff)) != 0;
-        };
-        int sunriseMin = 0, sunsetMin = 0;
-        if (!getAstroRiseSetMin(ntpTid, sunriseMin, sunsetMin)) {
-            return klokWantAAndEnd(ntpTid, outEndSec);
-        }
-        const int sunsetSec = sunsetMin * 60;
-        const int seg1End   = toSec(param.slutKlokkeTimer, param.slutKlokkeMinutter, 0);
-        bool wantA = inRangeSec(nowSec, sunsetSec, seg1End);
-        if (param.seg2Enabled && dayAllowed(param.seg2WeekMask)) {
-            int s2Start = toSec(param.seg2StartTimer, param.seg2StartMinutter, 0);
-            int s2End   = toSec(param.seg2SlutTimer,  param.seg2SlutMinutter,  0);
-            if (inRangeSec(nowSec, s2Start, s2End)) { outEndSec = s2End; return true; }
-        }
-        if (param.seg3Enabled && dayAllowed(param.seg3WeekMask)) {
-            int s3Start = toSec(param.seg3StartTimer, param.seg3StartMinutter, 0);
-            int s3End   = toSec(param.seg3SlutTimer,  param.seg3SlutMinutter,  0);
-            if (inRangeSec(nowSec, s3Start, s3End)) { outEndSec = s3End; return true; }
-        }
-        outEndSec = seg1End;
-        return wantA;
+    /** A-niveau: Tid bruger altid pwmA, segment-modes det aktive segments niveau. */
+    template <class Mode>
+    int levelOfA() const {
+        if constexpr (Mode::segments) return levelA;
+        else return param.pwmA;
     }
 
-    // ---------- Segment router ----------
-    // I astro-dag: hvis nataktiv (via lux) → brug klokken-logik (seg1End som slut)
-    // I astro-nat: brug astro-segmenter normalt
-    bool segmentWantAAndEnd(time_t ntpTid, int& outEndSec) {
-        if (param.styringsvalg == "Astro") {
-            int sunriseMin = 0, sunsetMin = 0;
-            if (getAstroRiseSetMin(ntpTid, sunriseMin, sunsetMin)) {
-                tm ti;
-                if (toLocalTm(ntpTid, ti)) {
-                    int nowMin = toMin(ti.tm_hour, ti.tm_min);
-                    bool astroNight = inRangeMin(nowMin, sunsetMin, sunriseMin);
-                    if (!astroNight && nataktiv) {
-                        // Astro-dag men nataktiv via lux → brug klokken-logik
-                        return klokWantAAndEnd(ntpTid, outEndSec);
-                    }
-                }
-            }
-            return astroWantAAndEnd(ntpTid, outEndSec);
-        }
-        return klokWantAAndEnd(ntpTid, outEndSec);
+    void enterA(time_t ntpTid, int endSec, int level) {
+        currentState = TIMER_A;
+        setTimerAToEnd(ntpTid, endSec);
+        levelA = level;
+        dimmer->setlysiprocentSoft(levelA);
+    }
+
+    void enterGlow() {
+        currentState = NIGHT_GLOW;
+        dimmer->setlysiprocentSoft(param.pwmG);
     }
 
     void setTimerAToEnd(time_t ntpTid, int endSec) {
-        tm timeinfo;
-        if (!toLocalTm(ntpTid, timeinfo)) return;
-        int nowSec = toSec(timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+        int nowSec = 0;
+        if (!localSec(ntpTid, nowSec)) return;
         timerA = endSec - nowSec;
         if (timerA < 0) timerA += 24L * 3600L;
         if (timerA > 12L * 3600L) timerA = 0;
@@ -232,18 +140,14 @@ private:
     // SIMPEL: astro-nat = nataktiv true ALTID
     //         astro-dag = lux styrer frit via updateLuxNat()
     void updateAstroMode(float lux, time_t ntpTid) {
-        int sunriseMin = 0, sunsetMin = 0;
-        if (!getAstroRiseSetMin(ntpTid, sunriseMin, sunsetMin)) {
+        const ScheduleEntry* e = entryAt(ntpTid);
+        if (!e) return;
+        if (!schedule.astroValid()) {
             updateLuxNat(lux);
             return;
         }
-        tm ti;
-        if (!toLocalTm(ntpTid, ti)) return;
-
-        int nowMin = toMin(ti.tm_hour, ti.tm_min);
-        bool astroNight = inRangeMin(nowMin, sunsetMin, sunriseMin);
 
-        if (astroNight) {
+        if (e->astroNight) {
             setNataktiv(true);
             resetLuxTimers();
         } else {
@@ -251,30 +155,23 @@ private:
         }
     }
 
-public:
-    LysAutomatik(LysParam& p, dimmerfunktion* d) : param(p), dimmer(d) {}
-
-    void initFromNow(float lux, time_t ntpTid) {
+    template <class Mode>
+    void initWith(float lux, time_t ntpTid) {
         currentState = OFF;
         slukActiveret = false;
         timerA = timerC = timerE = 0;
         resetLuxTimers();
 
-        if (param.styringsvalg == "Astro" && param.astroEnabled) {
-            int sunriseMin = 0, sunsetMin = 0;
-            if (getAstroRiseSetMin(ntpTid, sunriseMin, sunsetMin)) {
-                tm ti;
-                if (toLocalTm(ntpTid, ti)) {
-                    int nowMin = toMin(ti.tm_hour, ti.tm_min);
-                    bool astroNight = inRangeMin(nowMin, sunsetMin, sunriseMin);
-                    if (astroNight) {
-                        setNataktiv(true);
-                    } else {
-                        setNataktiv(lux < param.luxstartvaerdi);
-                        lastLuxOver = (lux >= param.luxstartvaerdi);
-                    }
-                } else {
+        if (Mode::astroNight(param)) {
+            const ScheduleEntry* e = entryAt(ntpTid);
+            if (!e) {
+                setNataktiv(true);
+            } else if (schedule.astroValid()) {
+                if (e->astroNight) {
                     setNataktiv(true);
+                } else {
+                    setNataktiv(lux < param.luxstartvaerdi);
+                    lastLuxOver = (lux >= param.luxstartvaerdi);
                 }
             } else {
                 setNataktiv(lux < param.luxstartvaerdi);
@@ -291,25 +188,19 @@ public:
             return;
         }
 
-        if (isSegmentMode()) {
-            int endSec = 0;
-            bool wantA = segmentWantAAndEnd(ntpTid, endSec);
-            if (wantA) {
-                currentState = TIMER_A;
-                setTimerAToEnd(ntpTid, endSec);
-                dimmer->setlysiprocentSoft(param.pwmA);
-            } else {
-                currentState = NIGHT_GLOW;
-                dimmer->setlysiprocentSoft(param.pwmG);
-            }
+        if constexpr (Mode::segments) {
+            int endSec = 0, level = 0;
+            if (segmentWantAAndEnd<Mode>(ntpTid, endSec, level)) enterA(ntpTid, endSec, level);
+            else enterGlow();
         } else {
-            startA(ntpTid);
+            startA<Mode>(ntpTid);
         }
     }
 
-    void update(float lux, bool pirEvent, time_t ntpTid) {
+    template <class Mode>
+    void updateWith(float lux, bool pirEvent, time_t ntpTid) {
         // 1) Nat/dag
-        if (param.styringsvalg == "Astro" && param.astroEnabled) {
+        if (Mode::astroNight(param)) {
             updateAstroMode(lux, ntpTid);
         } else {
             updateLuxNat(lux);
@@ -319,7 +210,7 @@ public:
         if (slukActiveret && nataktiv) {
             slukActiveret = false;
             switch (currentState) {
-                case TIMER_A:    dimmer->setlysiprocentSoft(param.pwmA); break;
+                case TIMER_A:    dimmer->setlysiprocentSoft(levelOfA<Mode>()); break;
                 case TIMER_C:    dimmer->setlysiprocentSoft(param.pwmC); break;
                 case TIMER_E:    dimmer->setlysiprocentSoft(param.pwmE); break;
                 case NIGHT_GLOW: dimmer->setlysiprocentSoft(param.pwmG); break;
@@ -333,35 +224,29 @@ public:
         if (nataktiv) {
             if (pirEvent) startC();
 
-            if (isSegmentMode()) {
-                int endSec = 0;
-                bool wantA = segmentWantAAndEnd(ntpTid, endSec);
+            if constexpr (Mode::segments) {
+                int endSec = 0, level = 0;
+                bool wantA = segmentWantAAndEnd<Mode>(ntpTid, endSec, level);
 
                 if (currentState == OFF) {
-                    if (wantA) {
-                        currentState = TIMER_A;
-                        setTimerAToEnd(ntpTid, endSec);
-                        dimmer->setlysiprocentSoft(param.pwmA);
-                    } else {
-                        currentState = NIGHT_GLOW;
-                        dimmer->setlysiprocentSoft(param.pwmG);
-                    }
+                    if (wantA) enterA(ntpTid, endSec, level);
+                    else enterGlow();
                 } else if (currentState == TIMER_A) {
                     if (!wantA) {
-                        currentState = NIGHT_GLOW;
-                        dimmer->setlysiprocentSoft(param.pwmG);
+                        enterGlow();
                     } else {
                         setTimerAToEnd(ntpTid, endSec);
+                        // Overlappende segment med andet niveau tager over
+                        if (level != levelA) {
+                            levelA = level;
+                            dimmer->setlysiprocentSoft(levelA);
+                        }
                     }
                 } else if (currentState == NIGHT_GLOW) {
-                    if (wantA) {
-                        currentState = TIMER_A;
-                        setTimerAToEnd(ntpTid, endSec);
-                        dimmer->setlysiprocentSoft(param.pwmA);
-                    }
+                    if (wantA) enterA(ntpTid, endSec, level);
                 }
             } else {
-                if (currentState == OFF) startA(ntpTid);
+                if (currentState == OFF) startA<Mode>(ntpTid);
             }
         } else {
             if (currentState != OFF) {
@@ -386,17 +271,10 @@ public:
             case TIMER_E:
                 if (timerA > 0) --timerA;
                 if (--timerE <= 0) {
-                    if (isSegmentMode()) {
-                        int endSec = 0;
-                        bool wantA = segmentWantAAndEnd(ntpTid, endSec);
-                        if (wantA) {
-                            currentState = TIMER_A;
-                            setTimerAToEnd(ntpTid, endSec);
-                            dimmer->setlysiprocentSoft(param.pwmA);
-                        } else {
-                            currentState = NIGHT_GLOW;
-                            dimmer->setlysiprocentSoft(param.pwmG);
-                        }
+                    if constexpr (Mode::segments) {
+                        int endSec = 0, level = 0;
+                        if (segmentWantAAndEnd<Mode>(ntpTid, endSec, level)) enterA(ntpTid, endSec, level);
+                        else enterGlow();
                     } else {
                         if (timerA > 0) resumeA();
                         else {
@@ -413,16 +291,37 @@ public:
         }
     }
 
+    template <class Mode>
     void startA(time_t ntpTid) {
         currentState = TIMER_A;
-        if (isSegmentMode()) {
+        if constexpr (Mode::segments) {
             int endSec = 0;
-            (void)segmentWantAAndEnd(ntpTid, endSec);
+            (void)segmentWantAAndEnd<Mode>(ntpTid, endSec, levelA);
             setTimerAToEnd(ntpTid, endSec);
         } else {
             timerA = param.timerA;
+            levelA = param.pwmA;
+        }
+        dimmer->setlysiprocentSoft(levelA);
+    }
+
+public:
+    LysAutomatik(LysParam& p, dimmerfunktion* d) : param(p), dimmer(d) {}
+
+    void initFromNow(float lux, time_t ntpTid) {
+        switch (param.styringsvalg) {
+            case MODE_KLOKKEN: initWith<ModeStrategy<MODE_KLOKKEN>>(lux, ntpTid); break;
+            case MODE_ASTRO:   initWith<ModeStrategy<MODE_ASTRO>>(lux, ntpTid); break;
+            default:           initWith<ModeStrategy<MODE_TID>>(lux, ntpTid); break;
+        }
+    }
+
+    void update(float lux, bool pirEvent, time_t ntpTid) {
+        switch (param.styringsvalg) {
+            case MODE_KLOKKEN: updateWith<ModeStrategy<MODE_KLOKKEN>>(lux, pirEvent, ntpTid); break;
+            case MODE_ASTRO:   updateWith<ModeStrategy<MODE_ASTRO>>(lux, pirEvent, ntpTid); break;
+            default:           updateWith<ModeStrategy<MODE_TID>>(lux, pirEvent, ntpTid); break;
         }
-        dimmer->setlysiprocentSoft(param.pwmA);
     }
 
     void startC() {
@@ -445,4 +344,15 @@ public:
     void forceOn()  { dimmer->taend(); }
     void forceOff() { dimmer->sluk(); slukActiveret = true; }
     bool getNataktiv() const { return nataktiv; }
+
+    /** Tilstand til StatusSnapshot. */
+    AutoState getAutoState() const {
+        switch (currentState) {
+            case TIMER_A:    return AUTO_TIMER_A;
+            case TIMER_C:    return AUTO_TIMER_C;
+            case TIMER_E:    return AUTO_TIMER_E;
+            case NIGHT_GLOW: return AUTO_NIGHT_GLOW;
+            default:         return AUTO_OFF;
+        }
+    }
 };
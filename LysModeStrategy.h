@@ -0,0 +1,58 @@
+#pragma once
+/**
+ * @file LysModeStrategy.h
+ * @brief Mode-strategier for LysAutomatik (Tid, Klokken, Astro).
+ *
+ * Hver mode er en specialisering af ModeStrategy<> med de punkter hvor modes
+ * adskiller sig:
+ *  - segments:    grundlys følger dagsplanen (true) eller timerA (false)
+ *  - astroNight(): nat/dag bestemmes af sol-tider (true) eller kun af lux
+ *  - wantA():     vælg grundlys/natglød, A-slut og A-niveau ud fra
+ *                 dagsplanens entry (kun segment-modes)
+ *
+ * LysAutomatik vælger strategi med én switch på param.styringsvalg pr. kald
+ * og kører sin fælles logik som template over strategien, så et tick hverken
+ * sammenligner strenge eller modes undervejs.
+ */
+
+#include "LysParam.h"
+#include "LysSchedule.h"
+
+template <LysMode M> struct ModeStrategy;
+
+/** Tid: lux styrer nat/dag; grundlys i timerA sekunder fra nattens start. */
+template <> struct ModeStrategy<MODE_TID> {
+    static constexpr bool segments = false;
+    static bool astroNight(const LysParam&) { return false; }
+};
+
+/** Klokken: lux styrer nat/dag; grundlys til seg1-slut + tillægssegmenter. */
+template <> struct ModeStrategy<MODE_KLOKKEN> {
+    static constexpr bool segments = true;
+    static bool astroNight(const LysParam&) { return false; }
+    static bool wantA(const ScheduleEntry& e, bool, bool, int& outEndSec, int& outLevel) {
+        outEndSec = e.klokEndSec;
+        outLevel = e.klokLevel;
+        return e.klokA;
+    }
+};
+
+/**
+ * Astro: astro-nat er altid nat (hvis astroEnabled), astro-dag styres af lux.
+ * I astro-dag med nataktiv (via lux) bruges klokken-logik (seg1End som slut);
+ * i astro-nat astro-segmenterne (uden sol-tider er astro-kolonnen = klokken).
+ */
+template <> struct ModeStrategy<MODE_ASTRO> {
+    static constexpr bool segments = true;
+    static bool astroNight(const LysParam& p) { return p.astroEnabled; }
+    static bool wantA(const ScheduleEntry& e, bool astroValid, bool nataktiv, int& outEndSec, int& outLevel) {
+        if (astroValid && !e.astroNight && nataktiv) {
+            outEndSec = e.klokEndSec;
+            outLevel = e.klokLevel;
+            return e.klokA;
+        }
+        outEndSec = e.astroEndSec;
+        outLevel = e.astroLevel;
+        return e.astroA;
+    }
+};
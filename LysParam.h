@@ -1,36 +1,120 @@
 /**
  * @file LysParam.h
- * @brief Konfigurationsparametre og log-event enum for lysautomatik.
+ * @brief Konfigurationsparametre for lysautomatik.
  *
  * LysParam indeholder alle justerbare parametre for lys-automatik, segmenter,
  * dimmer og astro-mode. Deles mellem core0 og core1 via param_mutex.
  *
- * lyslogstate enum bruges til FIFO-kommunikation (core1 → core0) for logning.
+ * LysParam er trivielt kopierbar (ingen String/heap): styringsmode er en enum,
+ * der kun oversættes til/fra tekst i Default.json og web-formularen.
+ *
+ * lyslogstate (log-event koder) ligger i EventRecord.h.
  */
 #pragma once
 #include <Arduino.h>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+#include <type_traits>
+
+#include "EventRecord.h"
+
+/** Styringsmode. Navnene (lysModeName) er dem der står i Default.json og formularen. */
+enum LysMode : uint8_t { MODE_TID, MODE_KLOKKEN, MODE_ASTRO, MODE_COUNT };
+
+inline const char* lysModeName(uint8_t m) {
+    static const char* const names[MODE_COUNT] = {"Tid", "Klokken", "Astro"};
+    return m < MODE_COUNT ? names[m] : "Tid";
+}
+
+/** "Tid" | "Klokken" | "Astro" → mode. false (out uændret) hvis navnet er ukendt. */
+inline bool parseLysMode(const char* s, LysMode& out) {
+    for (uint8_t m = 0; m < MODE_COUNT; m++) {
+        if (!strcmp(s, lysModeName(m))) {
+            out = (LysMode)m;
+            return true;
+        }
+    }
+    return false;
+}
+
+#define LYS_MAX_SEGMENTS 16     // Tillægssegmenter ud over segment 1
+#define SEG_LEVEL_PWMA   (-1)   // Segment-niveau: brug pwmA
+
+/** Forankring af et segments start/slut. */
+enum SegAnchor : uint8_t { ANCHOR_CLOCK, ANCHOR_SUNSET, ANCHOR_SUNRISE };
 
-/** FIFO event koder – sendes fra core1 til core0 for logning på SD-kort. */
-enum lyslogstate {
-    nataktivfalse,      // Nat → dag overgang
-    nataktivtrue,       // Dag → nat overgang
-    pir1_detection,     // PIR1 aktiveret
-    pir2_detection,     // PIR2 aktiveret
-    hwsw_on,            // Hardware switch ON
-    swsw_on,            // Software switch ON (fra web)
-    hwsw_off,           // Hardware switch OFF
-    swsw_off,           // Software switch OFF (fra web)
-    wdt_reset,          // Watchdog forårsagede reboot
-    i2c_reset_wire,     // VEML7700 I2C bus reset (Wire/I2C0)
-    i2c_reset_wire1,    // BMP280 I2C bus reset (Wire1/I2C1)
-    astro_log_request   // Request til core0 om at logge astro-data for i dag
+/** Start/slut for et segment: klokkeslæt, eller solnedgang/solopgang ± offset. */
+struct SegTime {
+    uint8_t anchor = ANCHOR_CLOCK;  // SegAnchor
+    int16_t min = 0;                // ANCHOR_CLOCK: minutter fra midnat (0–1439), ellers offset i minutter
 };
 
+/** Tillægssegment: grundlys fra start til slut på valgte ugedage. Ved overlap vinder laveste index. */
+struct LysSegment {
+    bool    enabled = false;
+    uint8_t weekMask = 0x7F;            // bit0=Søn .. bit6=Lør (0x7F = alle dage)
+    int8_t  level = SEG_LEVEL_PWMA;     // Lysniveau (%) i segmentet
+    SegTime start;
+    SegTime end;
+};
+
+/** SegTime → "HH:MM" | "solnedgang" | "solnedgang+15" | "solopgang-30" (Default.json og formularen). */
+inline void formatSegTime(char* buf, size_t size, const SegTime& t) {
+    if (t.anchor == ANCHOR_CLOCK) {
+        snprintf(buf, size, "%02d:%02d", t.min / 60, t.min % 60);
+        return;
+    }
+    const char* name = (t.anchor == ANCHOR_SUNSET) ? "solnedgang" : "solopgang";
+    if (t.min == 0) snprintf(buf, size, "%s", name);
+    else snprintf(buf, size, "%s%+d", name, (int)t.min);
+}
+
+/** Tekst → SegTime (formater som formatSegTime, "H:MM" og "HH.MM" accepteres). false hvis ugyldig. */
+inline bool parseSegTime(const char* s, SegTime& out) {
+    while (*s == ' ') s++;
+    SegTime t;
+    const char* rest = nullptr;
+    if (!strncasecmp(s, "solnedgang", 10))     { t.anchor = ANCHOR_SUNSET;  rest = s + 10; }
+    else if (!strncasecmp(s, "solopgang", 9))  { t.anchor = ANCHOR_SUNRISE; rest = s + 9; }
+
+    char* end;
+    if (rest) {
+        while (*rest == ' ') rest++;
+        long off = 0;
+        if (*rest) {
+            if (*rest != '+' && *rest != '-') return false;
+            off = strtol(rest, &end, 10);
+            if (end == rest || off < -720 || off > 720) return false;
+            rest = end;
+            while (*rest == ' ') rest++;
+            if (*rest) return false;
+        }
+        t.min = (int16_t)off;
+        out = t;
+        return true;
+    }
+
+    if (*s < '0' || *s > '9') return false;
+    long h = strtol(s, &end, 10);
+    if (*end != ':' && *end != '.') return false;
+    const char* m = end + 1;
+    if (*m < '0' || *m > '9') return false;
+    long mi = strtol(m, &end, 10);
+    while (*end == ' ') end++;
+    if (*end || h > 23 || mi > 59) return false;
+    t.anchor = ANCHOR_CLOCK;
+    t.min = (int16_t)(h * 60 + mi);
+    out = t;
+    return true;
+}
+
 /** Alle konfigurationsparametre for lysautomatik. */
 struct LysParam {
-    // Styringsmode: "Tid" | "Klokken" | "Astro"
-    String styringsvalg = "Tid";
+    // Styringsmode
+    LysMode styringsvalg = MODE_TID;
 
     // Lux-tærskel for nat/dag-skift
     float luxstartvaerdi = 8.0f;
@@ -54,25 +138,15 @@ struct LysParam {
     int slutKlokkeTimer    = 22;
     int slutKlokkeMinutter = 0;
 
-    // Segment 2 (tillæg) – start/slut + ugedage
-    bool    seg2Enabled       = false;
-    int     seg2StartTimer    = 5;
-    int     seg2StartMinutter = 30;
-    int     seg2SlutTimer     = 7;
-    int     seg2SlutMinutter  = 30;
-    uint8_t seg2WeekMask      = 0x7F;  // bit0=Søn .. bit6=Lør (0x7F = alle dage)
-
-    // Segment 3 (tillæg) – start/slut + ugedage
-    bool    seg3Enabled       = false;
-    int     seg3StartTimer    = 0;
-    int     seg3StartMinutter = 0;
-    int     seg3SlutTimer     = 0;
-    int     seg3SlutMinutter  = 0;
-    uint8_t seg3WeekMask      = 0x7F;
+    // Tillægssegmenter (segment 2, 3, …) – prioriteret rækkefølge
+    uint8_t    segCount = 0;
+    LysSegment segs[LYS_MAX_SEGMENTS];
 
     // Log-styring (kan slås til/fra via web)
     bool lognataktiv     = true;
     bool logpirdetection = true;
+    bool logbinary       = false;   // true: events i /events.bin (12 bytes/record) i stedet for tekst
+    int  logmaxmb        = 64;      // Loft for alle logfiler inkl. /log arkiver (MB), ældste slettes først
 
     // Softlys step-størrelse (1–10, bruges af Dimmerfunktion)
     int aktuelStepfrekvens = 5;
@@ -85,3 +159,7 @@ struct LysParam {
     int   astroSunriseOffsetMin = 0;        // Offset til solopgang (minutter, kan være negativ)
     bool  astroLuxEarlyStart    = true;     // Lux kan aktivere nat før beregnet solnedgang
 };
+static_assert(std::is_trivially_copyable<LysParam>::value, "LysParam skal kunne kopieres uden heap");
+
+/** Øges (under param_mutex) hver gang lysparam ændres – LysAutomatik genoversætter dagsplanen. */
+extern uint32_t lysparamRev;
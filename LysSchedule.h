@@ -0,0 +1,282 @@
+#pragma once
+/**
+ * @file LysSchedule.h
+ * @brief Forudberegnet dagsplan for segment-modes (Klokken/Astro).
+ *
+ * Segmentlogikken (seg1-slut, op til LYS_MAX_SEGMENTS tillægssegmenter med
+ * ugedage, solnedgang/solopgang) er stykvis konstant over døgnet: den skifter
+ * kun ved segmenternes start/slut, kl. 12:00 (nattens ugedag) og ved sol-tiderne.
+ * DaySchedule oversætter én lokal dato: tillægssegmenterne bliver start/slut-
+ * events, der sorteres og gennemløbes én gang med de aktive segmenter som
+ * bitmaske (laveste index vinder ved overlap). Resultatet er en tabel af
+ * entries [startSec, næste startSec) med ønsket tilstand (A/natglød), niveau
+ * og A-slut – opslag koster det samme uanset antal segmenter.
+ *
+ * Tabellen oversættes ved datoskift og når opsætningen ændres (lysparamRev).
+ * Lokal tid udledes af UTC ved at lægge til et anker (localtime_r kun ved
+ * oversættelse, ved midnat og ved skift mellem sommer-/vintertid), så et
+ * tick er en sammenligning og evt. et skridt frem i tabellen.
+ *
+ * Uden aktivt tillægssegment gælder basisreglerne: Klokken = grundlys til
+ * seg1-slut, Astro = grundlys fra solnedgang (inkl. offset) til seg1-slut.
+ * Sol-forankrede segmenter bruger den beregnede sol-tid + segmentets egen
+ * offset, og udgår på dage uden solopgang/-nedgang.
+ */
+
+#include <Arduino.h>
+#include <ctime>
+
+#include "AstroSun.h"
+#include "LysParam.h"
+
+// Knækpunkter: 0, 12:00, seg1-slut, solnedgang, solopgang + start/slut pr. tillægssegment
+#define SCHEDULE_MAX_ENTRIES (5 + 2 * LYS_MAX_SEGMENTS)
+
+/** Én periode i dagsplanen; gælder fra startSec til næste entry (eller midnat). */
+struct ScheduleEntry {
+    int32_t startSec;       // Sekund fra lokal midnat
+    int32_t klokEndSec;     // Klokken: A-slut (sek fra midnat)
+    int32_t astroEndSec;    // Astro: A-slut (sek fra midnat)
+    uint8_t klokLevel;      // Klokken: niveau (%) for A
+    uint8_t astroLevel;     // Astro: niveau (%) for A
+    bool    klokA;          // Klokken: grundlys (A) ønsket, ellers natglød
+    bool    astroA;         // Astro: grundlys (A) ønsket, ellers natglød
+    bool    astroNight;     // Mellem solnedgang og solopgang (inkl. offsets)
+
+    bool sameRule(const ScheduleEntry& o) const {
+        return klokEndSec == o.klokEndSec && astroEndSec == o.astroEndSec && klokLevel == o.klokLevel &&
+               astroLevel == o.astroLevel && klokA == o.klokA && astroA == o.astroA &&
+               astroNight == o.astroNight;
+    }
+};
+
+class DaySchedule {
+public:
+    static int toSec(int h, int m, int s = 0) { return h * 3600 + m * 60 + s; }
+
+    static bool inRangeSec(int nowSec, int startSec, int endSec) {
+        if (startSec == endSec) return true;
+        if (startSec < endSec)  return (nowSec >= startSec && nowSec < endSec);
+        return (nowSec >= startSec || nowSec < endSec);
+    }
+
+    static int wrapMin(int m) {
+        while (m < 0) m += 1440;
+        while (m >= 1440) m -= 1440;
+        return m;
+    }
+
+    static int seg1EndSec(const LysParam& p) { return toSec(p.slutKlokkeTimer, p.slutKlokkeMinutter, 0); }
+
+    /** Klokken uden tillægssegment: grundlys til seg1-slut (over midnat hvis slut er før kl. 12). */
+    static bool baseKlokA(int nowSec, int seg1End) {
+        if (seg1End < toSec(12, 0, 0)) return (nowSec >= toSec(12, 0, 0)) || (nowSec < seg1End);
+        return nowSec < seg1End;
+    }
+
+    /**
+     * @brief Sørg for at planen dækker t: forankr lokal tid og oversæt dagen hvis
+     *        datoen er ny eller force (ændret opsætning). false hvis localtime_r fejler.
+     */
+    bool refresh(const LysParam& p, time_t t, bool force) {
+        tm ti;
+        if (localtime_r(&t, &ti) == nullptr) {
+            ok = false;
+            spanStart = spanEnd = 0;
+            return false;
+        }
+        if (force || !ok || ti.tm_year + 1900 != yy || ti.tm_mon + 1 != mm || ti.tm_mday != dd) {
+            compile(p, ti);
+        }
+
+        int sec = toSec(ti.tm_hour, ti.tm_min, ti.tm_sec);
+        anchorSec = sec;
+        spanStart = t;
+        spanEnd   = t + (86400 - sec);
+
+        // Skift mellem sommer-/vintertid inden midnat: ankeret gælder kun til skiftet
+        time_t last = spanEnd - 1;
+        tm te;
+        if (localtime_r(&last, &te) != nullptr && te.tm_isdst != ti.tm_isdst) {
+            time_t lo = t, hi = last;
+            while (hi - lo > 1) {
+                time_t mid = lo + (hi - lo) / 2;
+                if (localtime_r(&mid, &te) != nullptr && te.tm_isdst == ti.tm_isdst) lo = mid;
+                else hi = mid;
+            }
+            spanEnd = hi;
+        }
+        ok = true;
+        return true;
+    }
+
+    /** Kan secOf(t) bruges uden refresh()? */
+    bool covers(time_t t) const { return ok && t >= spanStart && t < spanEnd; }
+
+    /** Lokalt sekund fra midnat (kræver covers(t)). */
+    int secOf(time_t t) const { return anchorSec + (int)(t - spanStart); }
+
+    /** Entry for sekund fra midnat; cursoren går kun frem mellem to kald i samme dag. */
+    const ScheduleEntry& at(int sec) {
+        if (cursor >= count || sec < entries[cursor].startSec) cursor = 0;
+        while (cursor + 1 < count && sec >= entries[cursor + 1].startSec) cursor++;
+        return entries[cursor];
+    }
+
+    bool valid() const { return ok; }
+    bool astroValid() const { return astroOk; }
+    int  sunriseMin() const { return riseMin; }     // Inkl. offset
+    int  sunsetMin() const { return setMin; }       // Inkl. offset
+    int  year() const { return yy; }
+    int  month() const { return mm; }
+    int  day() const { return dd; }
+    int  wday() const { return wd; }     // 0=Søn .. 6=Lør
+    uint8_t size() const { return count; }
+    const ScheduleEntry& entry(uint8_t i) const { return entries[i]; }
+
+private:
+    /** Segmentets start/slut som sekund fra midnat i dag; false hvis sol-tiden mangler. */
+    bool segSec(const SegTime& t, int& out) const {
+        if (t.anchor == ANCHOR_CLOCK) {
+            out = t.min * 60;
+            return t.min >= 0 && t.min < 1440;
+        }
+        if (!astroOk) return false;
+        out = wrapMin((t.anchor == ANCHOR_SUNSET ? rawSetMin : rawRiseMin) + t.min) * 60;
+        return true;
+    }
+
+    template <typename T>
+    static void sortBy(T* a, uint8_t n, int32_t (*key)(const T&)) {     // Indsættelsessortering (højst 37)
+        for (uint8_t i = 1; i < n; i++) {
+            T v = a[i];
+            uint8_t j = i;
+            for (; j > 0 && key(a[j - 1]) > key(v); j--) a[j] = a[j - 1];
+            a[j] = v;
+        }
+    }
+
+    void compile(const LysParam& p, const tm& ti) {
+        yy = ti.tm_year + 1900;
+        mm = ti.tm_mon + 1;
+        dd = ti.tm_mday;
+        wd = ti.tm_wday;
+
+        AstroTimes a = AstroSun::computeLocalTimes(yy, mm, dd, p.astroLat, p.astroLon);
+        astroOk = a.valid();
+        rawRiseMin = a.sunriseMin;
+        rawSetMin  = a.sunsetMin;
+        riseMin = astroOk ? wrapMin(a.sunriseMin + p.astroSunriseOffsetMin) : -1;
+        setMin  = astroOk ? wrapMin(a.sunsetMin  + p.astroSunsetOffsetMin)  : -1;
+
+        const int noon    = toSec(12, 0, 0);
+        const int seg1End = seg1EndSec(p);
+        const uint8_t pwmA = (uint8_t)constrain(p.pwmA, 0, 100);
+
+        // Tillægssegmenter → start/slut-events. Bit i = segment i.
+        struct Event {
+            int32_t  sec;
+            uint16_t on;
+            uint16_t off;
+        };
+        Event ev[2 * LYS_MAX_SEGMENTS];
+        uint8_t nEv = 0;
+        uint16_t active = 0;        // Aktive ved midnat (krydser midnat / hele døgnet)
+        uint16_t okToday = 0;       // Ugedag tilladt i dag
+        uint16_t okPrev = 0;        // Ugedag tilladt i går (Astro: nattens ugedag før kl. 12)
+        int32_t  segEnd[LYS_MAX_SEGMENTS];
+        uint8_t  segLevel[LYS_MAX_SEGMENTS];
+        const int prevWd = (wd + 6) % 7;
+        const uint8_t nSeg = p.segCount < LYS_MAX_SEGMENTS ? p.segCount : LYS_MAX_SEGMENTS;
+        for (uint8_t i = 0; i < nSeg; i++) {
+            const LysSegment& sg = p.segs[i];
+            int s, e;
+            if (!sg.enabled || !segSec(sg.start, s) || !segSec(sg.end, e)) continue;
+            uint16_t bit = (uint16_t)(1u << i);
+            segEnd[i] = e;
+            segLevel[i] = sg.level < 0 ? pwmA : (uint8_t)constrain((int)sg.level, 0, 100);
+            if (sg.weekMask & (1u << wd)) okToday |= bit;
+            if (sg.weekMask & (1u << prevWd)) okPrev |= bit;
+            if (s == e) { active |= bit; continue; }   // Hele døgnet
+            if (s > e) active |= bit;                   // [s, midnat) + [midnat, e)
+            ev[nEv++] = Event{s, bit, 0};
+            ev[nEv++] = Event{e, 0, bit};
+        }
+        sortBy<Event>(ev, nEv, [](const Event& x) { return x.sec; });
+
+        // Knækpunkter: events + basisreglernes skift
+        int32_t bp[SCHEDULE_MAX_ENTRIES];
+        uint8_t n = 0;
+        auto add = [&](int s) { if (s >= 0 && s < 86400 && n < SCHEDULE_MAX_ENTRIES) bp[n++] = s; };
+        add(0);
+        add(noon);
+        add(seg1End);
+        if (astroOk) {
+            add(setMin * 60);
+            add(riseMin * 60);
+        }
+        for (uint8_t i = 0; i < nEv; i++) add(ev[i].sec);
+        sortBy<int32_t>(bp, n, [](const int32_t& x) { return x; });
+
+        // Gennemløb: aktive segmenter som maske, vinder = laveste bit
+        count = 0;
+        cursor = 0;
+        uint8_t ei = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            if (i && bp[i] == bp[i - 1]) continue;
+            const int t = bp[i];
+            for (; ei < nEv && ev[ei].sec <= t; ei++) active = (uint16_t)((active | ev[ei].on) & ~ev[ei].off);
+
+            ScheduleEntry e;
+            e.startSec = t;
+            uint16_t klok = active & okToday;
+            if (klok) {
+                uint8_t w = (uint8_t)__builtin_ctz(klok);
+                e.klokA = true;
+                e.klokEndSec = segEnd[w];
+                e.klokLevel = segLevel[w];
+            } else {
+                e.klokA = baseKlokA(t, seg1End);
+                e.klokEndSec = seg1End;
+                e.klokLevel = pwmA;
+            }
+
+            if (astroOk) {
+                uint16_t astro = active & (t < noon ? okPrev : okToday);
+                if (astro) {
+                    uint8_t w = (uint8_t)__builtin_ctz(astro);
+                    e.astroA = true;
+                    e.astroEndSec = segEnd[w];
+                    e.astroLevel = segLevel[w];
+                } else {
+                    e.astroA = inRangeSec(t, setMin * 60, seg1End);
+                    e.astroEndSec = seg1End;
+                    e.astroLevel = pwmA;
+                }
+                e.astroNight = inRangeSec(t, setMin * 60, riseMin * 60);
+            } else {
+                // Uden sol-tider falder Astro tilbage til Klokken
+                e.astroA = e.klokA;
+                e.astroEndSec = e.klokEndSec;
+                e.astroLevel = e.klokLevel;
+                e.astroNight = false;
+            }
+            if (count && e.sameRule(entries[count - 1])) continue;
+            entries[count++] = e;
+        }
+    }
+
+    ScheduleEntry entries[SCHEDULE_MAX_ENTRIES];
+    uint8_t count = 0;
+    uint8_t cursor = 0;
+
+    bool ok = false;
+    bool astroOk = false;
+    int  yy = -1, mm = -1, dd = -1, wd = -1;     // Lokal dato for tabellen
+    int  riseMin = -1, setMin = -1;          // Inkl. astro-offsets (Astro-mode)
+    int  rawRiseMin = -1, rawSetMin = -1;    // Beregnet (sol-forankrede segmenter)
+
+    time_t spanStart = 0;       // UTC hvor ankeret blev sat
+    time_t spanEnd = 0;         // UTC for næste midnat eller DST-skift
+    int    anchorSec = 0;       // Lokalt sekund fra midnat ved spanStart
+};
@@ -0,0 +1,220 @@
+#pragma once
+/**
+ * @file MultipartStream.h
+ * @brief Streamende multipart/form-data parser (ingen String, ingen heap).
+ *
+ * Body'en fødes i vilkårlige bidder med feed(), præcis som de kommer fra
+ * socket'en. Grænsen ("\r\n--" + boundary) findes med en KMP-matcher, der
+ * husker et delvist match på tværs af bidder – hver byte undersøges én gang,
+ * og data uden '\r' springes over med memchr(). Fil-data sendes videre til
+ * MultipartSink i så store sammenhængende stykker som muligt.
+ *
+ * Første grænse har ingen foranstillet CRLF; matcheren starter derfor som om
+ * "\r\n" allerede er set.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <strings.h>
+
+#define MULTIPART_BOUNDARY_MAX 70      // RFC 2046
+#define MULTIPART_HDR_LINE     256     // Længere header-linjer afkortes
+#define MULTIPART_NAME_MAX     32
+#define MULTIPART_FILENAME_MAX 96
+
+/** Modtager af de dele parseren finder. */
+class MultipartSink {
+public:
+    virtual ~MultipartSink() {}
+    /** Ny del. filename er "" for almindelige formularfelter. */
+    virtual void partBegin(const char* name, const char* filename) = 0;
+    virtual void partData(const uint8_t* p, size_t n) = 0;
+    virtual void partEnd() = 0;
+};
+
+class MultipartStream {
+public:
+    /**
+     * @brief Nulstil til ny body.
+     * @return false hvis boundary er tom eller længere end MULTIPART_BOUNDARY_MAX.
+     */
+    bool begin(const char* boundary, size_t len, MultipartSink* s) {
+        if (len == 0 || len > MULTIPART_BOUNDARY_MAX) return false;
+        memcpy(delim, "\r\n--", 4);
+        memcpy(delim + 4, boundary, len);
+        dlen = (uint8_t)(4 + len);
+
+        // KMP præfiks-funktion
+        fail[0] = 0;
+        uint8_t k = 0;
+        for (uint8_t i = 1; i < dlen; i++) {
+            while (k > 0 && delim[i] != delim[k]) k = fail[k - 1];
+            if (delim[i] == delim[k]) k++;
+            fail[i] = k;
+        }
+
+        sink = s;
+        state = ST_PREAMBLE;
+        match = 2;          // "\r\n" foran første grænse
+        dashes = 0;
+        hlen = 0;
+        name[0] = filename[0] = '\0';
+        return true;
+    }
+
+    void feed(const uint8_t* p, size_t n) {
+        const uint8_t* e = p + n;
+        while (p < e && state != ST_DONE) {
+            switch (state) {
+                case ST_PREAMBLE:  p = feedPreamble(p, e); break;
+                case ST_DELIM_END: p = feedDelimEnd(p, e); break;
+                case ST_HEADERS:   p = feedHeaders(p, e); break;
+                case ST_BODY:      p = feedBody(p, e); break;
+                case ST_DONE:      break;
+            }
+        }
+    }
+
+    /** Afsluttende grænse ("--boundary--") er modtaget. */
+    bool finished() const { return state == ST_DONE; }
+
+    /** En del er åben (partBegin uden partEnd) – fx ved afbrudt upload. */
+    bool inPart() const { return state == ST_BODY; }
+
+private:
+    enum State : uint8_t { ST_PREAMBLE, ST_DELIM_END, ST_HEADERS, ST_BODY, ST_DONE };
+
+    char     delim[4 + MULTIPART_BOUNDARY_MAX];
+    uint8_t  fail[4 + MULTIPART_BOUNDARY_MAX];
+    uint8_t  dlen = 0;
+    uint8_t  match = 0;         // Antal matchede tegn af delim
+    uint8_t  dashes = 0;        // "--" efter grænse = sidste del
+    State    state = ST_DONE;
+    MultipartSink* sink = nullptr;
+
+    char     hdr[MULTIPART_HDR_LINE];
+    uint16_t hlen = 0;
+    char     name[MULTIPART_NAME_MAX];
+    char     filename[MULTIPART_FILENAME_MAX];
+
+    uint8_t step(uint8_t k, uint8_t c) const {
+        while (k > 0 && (uint8_t)delim[k] != c) k = fail[k - 1];
+        if ((uint8_t)delim[k] == c) k++;
+        return k;
+    }
+
+    const uint8_t* feedPreamble(const uint8_t* p, const uint8_t* e) {
+        while (p < e) {
+            match = step(match, *p++);
+            if (match == dlen) {
+                match = 0;
+                dashes = 0;
+                state = ST_DELIM_END;
+                break;
+            }
+        }
+        return p;
+    }
+
+    /** Efter grænsen: "\r\n" → headere, "--" → slut (evt. whitespace ignoreres). */
+    const uint8_t* feedDelimEnd(const uint8_t* p, const uint8_t* e) {
+        while (p < e) {
+            uint8_t c = *p++;
+            if (c == '-' && ++dashes == 2) {
+                state = ST_DONE;
+                break;
+            }
+            if (c == '\n') {
+                hlen = 0;
+                name[0] = filename[0] = '\0';
+                state = ST_HEADERS;
+                break;
+            }
+        }
+        return p;
+    }
+
+    const uint8_t* feedHeaders(const uint8_t* p, const uint8_t* e) {
+        while (p < e) {
+            char c = (char)*p++;
+            if (c != '\n') {
+                if (hlen < sizeof(hdr) - 1) hdr[hlen++] = c;
+                continue;
+            }
+            if (hlen > 0 && hdr[hlen - 1] == '\r') hlen--;
+            if (hlen == 0) {            // Tom linje: data følger
+                sink->partBegin(name, filename);
+                match = 0;
+                state = ST_BODY;
+                break;
+            }
+            hdr[hlen] = '\0';
+            static const char cd[] = "Content-Disposition:";
+            if (strncasecmp(hdr, cd, sizeof(cd) - 1) == 0) {
+                headerParam(hdr, "name", name, sizeof(name));
+                headerParam(hdr, "filename", filename, sizeof(filename));
+            }
+            hlen = 0;
+        }
+        return p;
+    }
+
+    /** Data indtil grænsen. Bytes der kan være starten på en grænse holdes tilbage (match). */
+    const uint8_t* feedBody(const uint8_t* p, const uint8_t* e) {
+        const uint8_t* run = p;         // Start af endnu ikke afleveret data
+        while (p < e) {
+            if (match == 0) {
+                const uint8_t* cr = (const uint8_t*)memchr(p, '\r', e - p);
+                if (!cr) {
+                    p = e;
+                    break;
+                }
+                p = cr;
+            }
+            uint8_t k = step(match, *p);
+            if (k > match) {            // Match forlænget: data før holdes ikke længere tilbage
+                if (p > run) sink->partData(run, p - run);
+                run = p + 1;
+                match = k;
+                p++;
+                if (match == dlen) {
+                    sink->partEnd();
+                    match = 0;
+                    dashes = 0;
+                    state = ST_DELIM_END;
+                    return p;
+                }
+                continue;
+            }
+            // Mismatch: tilbageholdte tegn (delim[0..match) + c) frigives undtagen de k sidste
+            if (k == 0) {
+                sink->partData((const uint8_t*)delim, match);
+                run = p;                // c er almindelig data
+            } else {
+                sink->partData((const uint8_t*)delim, match + 1 - k);
+                run = p + 1;
+            }
+            match = k;
+            p++;
+        }
+        if (p > run) sink->partData(run, p - run);
+        return p;
+    }
+
+    /** Find param="værdi" i en header-linje (kun hele parameternavne). */
+    static void headerParam(const char* line, const char* param, char* dst, size_t size) {
+        size_t plen = strlen(param);
+        for (const char* s = line; (s = strstr(s, param)) != nullptr; s += plen) {
+            if (s > line && s[-1] != ' ' && s[-1] != ';') continue;
+            if (s[plen] != '=' || s[plen + 1] != '"') continue;
+            const char* v = s + plen + 2;
+            const char* q = strchr(v, '"');
+            if (!q) q = v + strlen(v);
+            size_t n = (size_t)(q - v);
+            if (n >= size) n = size - 1;
+            memcpy(dst, v, n);
+            dst[n] = '\0';
+            return;
+        }
+    }
+};
@@ -0,0 +1,201 @@
+#pragma once
+/**
+ * @file SensorHistory.h
+ * @brief Sensorhistorik i fast RAM: tre opløsninger med min/avg/max pr. record.
+ *
+ * Core1 kalder add() hvert sekund med seneste lux/temp/tryk. Værdien lægges i
+ * 1 s-ringen, og samles samtidig til 1 min-records (60 sekunder) og videre til
+ * 15 min-records (15 minutter). Hver ring overskriver ældste record når den er
+ * fuld, så hukommelsen er fast: alle ringe er statiske arrays (SensorHistoryBuf),
+ * og der allokeres aldrig efter boot.
+ *
+ * Records er pakket til 6 bytes: min/avg/max som 16-bit koder (histEncode),
+ * HIST_GAP hvis sensoren ikke leverede noget i perioden. Lux kodes med 0.1 lux
+ * opløsning under 1000 lux (tærskel-området for luxstartvaerdi) og 4 lux over.
+ *
+ * Læsning (core0, /history) sker uden lås: ringens tæller + tid publiceres via
+ * SeqLock efter recorden er skrevet, og get() kontrollerer efter kopieringen at
+ * recorden ikke blev overskrevet undervejs (så gives HIST_GAP).
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+#include "SeqLock.h"
+
+// Ringstørrelser (records). Lux: 10 min / 48 t / 30 døgn. Temp/tryk ændrer sig langsomt: 10 min / 24 t / 15 døgn.
+#define HISTORY_LUX_1S_LEN   600
+#define HISTORY_LUX_1M_LEN   2880
+#define HISTORY_LUX_15M_LEN  2880
+#define HISTORY_ENV_1S_LEN   600
+#define HISTORY_ENV_1M_LEN   1440
+#define HISTORY_ENV_15M_LEN  1440
+
+#define HIST_GAP 0xFFFF     // Ingen måling i perioden
+
+enum HistSensor : uint8_t { HIST_LUX, HIST_TEMP, HIST_PRESSURE, HIST_SENSOR_COUNT };
+enum HistRes : uint8_t { HIST_1S, HIST_1M, HIST_15M, HIST_RES_COUNT };
+
+/** Sekunder pr. record for hver opløsning. */
+inline uint16_t histResSeconds(uint8_t res) {
+    static const uint16_t sec[HIST_RES_COUNT] = {1, 60, 900};
+    return res < HIST_RES_COUNT ? sec[res] : 0;
+}
+
+/** Sensorværdi → 16-bit kode (monoton, så min/max bevares). Skal matche tools/history.py. */
+inline uint16_t histEncode(uint8_t sensor, float v) {
+    if (!std::isfinite(v)) return HIST_GAP;
+    float c;
+    switch (sensor) {
+        case HIST_LUX:  c = (v < 1000.0f) ? v * 10.0f : 10000.0f + (v - 1000.0f) / 4.0f; break;
+        case HIST_TEMP: c = (v + 50.0f) * 100.0f; break;       // 0.01 °C fra -50 °C
+        default:        c = (v - 300.0f) * 50.0f; break;       // 0.02 hPa fra 300 hPa
+    }
+    if (c <= 0.0f) return 0;
+    if (c >= (float)(HIST_GAP - 1)) return HIST_GAP - 1;
+    return (uint16_t)lroundf(c);
+}
+
+inline float histDecode(uint8_t sensor, uint16_t code) {
+    if (code == HIST_GAP) return NAN;
+    switch (sensor) {
+        case HIST_LUX:  return (code < 10000) ? code / 10.0f : 1000.0f + (code - 10000) * 4.0f;
+        case HIST_TEMP: return code / 100.0f - 50.0f;
+        default:        return code / 50.0f + 300.0f;
+    }
+}
+
+struct HistRecord {
+    uint16_t min;
+    uint16_t avg;
+    uint16_t max;
+};
+static_assert(sizeof(HistRecord) == 6, "HistRecord skal være 6 bytes");
+
+/** Header foran records i /history-svaret (little-endian). */
+struct HistHeader {
+    char     magic[2];      // "LH"
+    uint8_t  version;       // 1
+    uint8_t  sensor;        // HistSensor
+    uint16_t resSeconds;    // Sekunder pr. record
+    uint16_t recordSize;    // sizeof(HistRecord)
+    uint32_t lastEpoch;     // UTC ved afslutning af nyeste record (records ligger med resSeconds mellemrum)
+    uint32_t count;         // Antal records efter headeren (ældste først)
+};
+static_assert(sizeof(HistHeader) == 16, "HistHeader skal være 16 bytes");
+
+/** Ring af records for én opløsning. Én skriver (core1), læsere på core0. */
+class HistRing {
+public:
+    HistRing(HistRecord* storage, uint16_t len) : buf(storage), len(len) {}
+
+    void push(const HistRecord& r, uint32_t epoch) {
+        buf[written % len] = r;
+        written++;
+        Head h{written, epoch};
+        head.publish(h);
+    }
+
+    /** Antal records skrevet i alt og UTC for den nyeste. false hvis intet er skrevet. */
+    bool state(uint32_t& count, uint32_t& epoch) const {
+        Head h;
+        if (!head.read(h)) return false;
+        count = h.count;
+        epoch = h.epoch;
+        return true;
+    }
+
+    /** Kopi af record nr. i (absolut). false hvis den er overskrevet før eller under kopieringen. */
+    bool get(uint32_t i, HistRecord& out) const {
+        out = buf[i % len];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint32_t count, epoch;
+        return state(count, epoch) && i < count && count - i < len;
+    }
+
+    /** Max antal records der kan læses: ældste plads kan være ved at blive overskrevet. */
+    uint16_t readable() const { return len - 1; }
+
+private:
+    struct Head {
+        uint32_t count;
+        uint32_t epoch;
+    };
+
+    HistRecord* buf;
+    uint16_t len;
+    uint32_t written = 0;       // Kun skriveren
+    SeqLock<Head> head;
+};
+
+/** Historik for én sensor. Ringenes lager ligger i SensorHistoryBuf. */
+class SensorHistory {
+public:
+    SensorHistory(HistSensor sensor, HistRecord* s1, uint16_t n1, HistRecord* s2, uint16_t n2,
+                  HistRecord* s3, uint16_t n3)
+        : sensor(sensor), rings{HistRing(s1, n1), HistRing(s2, n2), HistRing(s3, n3)} {}
+
+    /** Kald fra core1 hvert sekund. v = NAN hvis sensoren ikke leverede en måling. */
+    void add(float v, uint32_t epoch) {
+        uint16_t c = histEncode(sensor, v);
+        rings[HIST_1S].push(HistRecord{c, c, c}, epoch);
+        acc[HIST_1M].add(sensor, HistRecord{c, c, c});
+        if (++ticks % 60 != 0) return;
+
+        HistRecord m = acc[HIST_1M].take();
+        rings[HIST_1M].push(m, epoch);
+        acc[HIST_15M].add(sensor, m);
+        if (ticks % 900 != 0) return;
+        rings[HIST_15M].push(acc[HIST_15M].take(), epoch);
+        ticks = 0;
+    }
+
+    const HistRing& ring(uint8_t res) const { return rings[res < HIST_RES_COUNT ? res : HIST_1S]; }
+    HistSensor id() const { return sensor; }
+
+private:
+    /** Samler records til én record på næste niveau. Gennemsnit af de gyldige avg-værdier. */
+    struct Acc {
+        uint8_t  sensor = 0;
+        uint16_t n = 0;
+        uint16_t lo = HIST_GAP;
+        uint16_t hi = 0;
+        float    sum = 0.0f;
+
+        void add(uint8_t s, const HistRecord& r) {
+            if (r.avg == HIST_GAP) return;
+            sensor = s;
+            if (r.min < lo) lo = r.min;
+            if (r.max > hi) hi = r.max;
+            sum += histDecode(s, r.avg);
+            n++;
+        }
+
+        HistRecord take() {
+            HistRecord r{HIST_GAP, HIST_GAP, HIST_GAP};
+            if (n) r = HistRecord{lo, histEncode(sensor, sum / n), hi};
+            *this = Acc();
+            return r;
+        }
+    };
+
+    HistSensor sensor;
+    HistRing rings[HIST_RES_COUNT];
+    Acc acc[HIST_RES_COUNT];    // [HIST_1M] samler sekunder, [HIST_15M] samler minutter
+    uint16_t ticks = 0;
+};
+
+/** SensorHistory med statisk lager til de tre ringe. */
+template <uint16_t N1, uint16_t N2, uint16_t N3>
+class SensorHistoryBuf : public SensorHistory {
+public:
+    explicit SensorHistoryBuf(HistSensor s) : SensorHistory(s, r1, N1, r2, N2, r3, N3) {}
+
+private:
+    HistRecord r1[N1];
+    HistRecord r2[N2];
+    HistRecord r3[N3];
+};
+
+extern SensorHistory* const sensorHistory[HIST_SENSOR_COUNT];
@@ -0,0 +1,62 @@
+#pragma once
+/**
+ * @file SeqLock.h
+ * @brief Sekvenslås: én skriver (fx core1) deler en lille POD-struct med læsere på den anden core.
+ *
+ * Skriveren sætter seq ulige, kopierer data og sætter seq lige igen – den venter aldrig.
+ * Læseren kopierer data og godtager kopien hvis seq var lige og uændret undervejs.
+ * Kolliderer en læsning med en skrivning (kopien er få bytes) prøves igen, højst
+ * SEQLOCK_READ_TRIES gange, så læseren heller aldrig kan hænge.
+ *
+ * Ingen mutex → ingen prioritets- eller krydscore-ventetid i real-time løkken.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#define SEQLOCK_READ_TRIES 64
+
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock kræver en trivielt kopierbar type");
+
+public:
+    /** Publicér ny værdi (kun fra én skriver-core). */
+    void publish(const T& v) {
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&data, &v, sizeof(T));
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Læs seneste konsistente værdi.
+     * @return false hvis der endnu intet er publiceret, eller skriveren var midt i en
+     *         opdatering ved alle forsøg (out er da uændret).
+     */
+    bool read(T& out) const {
+        for (int i = 0; i < SEQLOCK_READ_TRIES; i++) {
+            uint32_t s1 = seq.load(std::memory_order_acquire);
+            if (s1 == 0) return false;
+            if (s1 & 1) continue;
+            T tmp;
+            memcpy(&tmp, &data, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == s1) {
+                out = tmp;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Antal publiceringer indtil nu. */
+    uint32_t version() const { return seq.load(std::memory_order_acquire) >> 1; }
+
+private:
+    std::atomic<uint32_t> seq{0};
+    T data{};
+};
@@ -0,0 +1,58 @@
+#pragma once
+/**
+ * @file StatusSnapshot.h
+ * @brief Øjebliksbillede af systemstatus, publiceret af core1 og læst af webserveren på core0.
+ *
+ * Core1 udfylder en StatusSnapshot i loop1() (hvert sekund og når lysprocent
+ * ændrer sig) og publicerer den i statusSnapshot (SeqLock). Webserveren læser
+ * kopien uden mutex, så /status.htm, /statusjson.htm og /events aldrig holder
+ * core1 hen.
+ *
+ * Tidsstempler er UTC-epoch (0 = aldrig/ukendt); formatering til lokal tid
+ * sker på core0 med EpochClock::formatLocal().
+ */
+
+#include <cstdint>
+
+#include "SeqLock.h"
+
+/** Automatikkens tilstand (spejler LysAutomatik::LysState). */
+enum AutoState : uint8_t {
+    AUTO_OFF,
+    AUTO_TIMER_A,
+    AUTO_TIMER_C,
+    AUTO_TIMER_E,
+    AUTO_NIGHT_GLOW
+};
+
+inline const char* autoStateName(uint8_t s) {
+    switch (s) {
+        case AUTO_OFF:        return "OFF";
+        case AUTO_TIMER_A:    return "TIMER_A";
+        case AUTO_TIMER_C:    return "TIMER_C";
+        case AUTO_TIMER_E:    return "TIMER_E";
+        case AUTO_NIGHT_GLOW: return "NIGHT_GLOW";
+        default:              return "?";
+    }
+}
+
+struct StatusSnapshot {
+    uint32_t epoch = 0;         // UTC ved publicering
+    float    lux = 0.0f;
+    float    temp = 0.0f;       // °C (BMP280)
+    float    pressure = 0.0f;   // hPa
+    float    cpuTemp = 0.0f;    // °C (RP2040 intern)
+    int16_t  lysprocent = 0;
+    uint8_t  autoState = AUTO_OFF;
+    bool     nat = false;       // Nataktiv
+    bool     forcedOn = false;  // Tvungen on (kontakt eller software)
+    bool     hwsw = false;      // Hardware-kontakt aktiv
+    uint32_t pir1Epoch = 0;     // Sidste PIR1-aktivering
+    uint32_t pir2Epoch = 0;     // Sidste PIR2-aktivering
+    uint32_t hwswEpoch = 0;     // Sidste kontakt on/off
+    uint32_t i2cWireResets = 0;     // Bus-resets Wire (VEML7700) siden boot
+    uint32_t i2cWire1Resets = 0;    // Bus-resets Wire1 (BMP280) siden boot
+    uint32_t paramSkips = 0;        // Automatik-ticks sprunget over (param_mutex optaget)
+};
+
+extern SeqLock<StatusSnapshot> statusSnapshot;
@@ -0,0 +1,469 @@
+#pragma once
+/**
+ * @file WebServerEngine.h
+ * @brief Ikke-blokerende HTTP-server med forbindelsestabel (kører på core0).
+ *
+ * Op til WEB_MAX_CONN samtidige sockets. Hver forbindelse har sin egen
+ * parse-tilstand, header-buffer og timeout. poll() kaldes fra loop() og læser
+ * kun de bytes der allerede er modtaget, så én langsom browser ikke holder
+ * NTP-sync, FIFO-log eller andre klienter hen.
+ *
+ * Når en komplet header ("\r\n\r\n") er modtaget, tokeniseres den af
+ * HttpRequest direkte i bufferen og sendes videre til WebServerHandler::handle().
+ * Svaret skrives i den fælles WebTxBuffer, som flushes når handle() returnerer
+ * (handle() er synkron, så én buffer dækker alle forbindelser).
+ * Er tabellen fuld, genbruges den ældste tomgangs-forbindelse (keep-alive);
+ * ellers svares 503 med det samme.
+ *
+ * Keep-alive: har svaret kendt længde og ønsker klienten det (HTTP/1.1 uden
+ * "Connection: close"), går forbindelsen tilbage til CONN_READ_HEADERS i
+ * stedet for at blive lukket. Tomgang lukkes efter WEB_IDLE_TIMEOUT_MS.
+ * Bytes efter headeren behandles som næste (pipelinede) request.
+ *
+ * Download (REPLY_FILE): handleren sender kun headeren; forbindelsen går i
+ * CONN_SEND_FILE og filen streames herfra ved hvert poll() – kun så meget som
+ * lwIP's sendebuffer har plads til (availableForWrite), så andre klienter ikke
+ * venter. Mens en fil streames, afviser /delete og /upload at slette eller
+ * overskrive den (409, via WebFileGuard), så downloaden ikke læser frigivne clusters.
+ * SD-læsninger holdes på 512-byte sektorgrænser og er op til
+ * WEB_FILE_BUF bytes, så SdFat læser hele sektorer direkte ind i bufferen
+ * (ingen cache-kopi). lwIP's sendebuffer er "den anden buffer": mens radioen
+ * sender forrige bid, læses næste fra SD.
+ *
+ * Upload (REPLY_BODY): forbindelsen går i CONN_RECV_BODY, og body'en fødes til
+ * handleren (uploadFeed) i bidder af det der allerede er modtaget – ingen
+ * ventesløjfe. Mens SD skrives, modtager lwIP videre i TCP-vinduet.
+ *
+ * /events (Server-Sent Events): forbindelsen bliver i tabellen som CONN_SSE.
+ * Hvert WEB_SSE_TICK_MS bygger WebServerHandler én status-delta, som sendes
+ * til alle SSE-klienter. Max WEB_MAX_SSE streams, så der altid er plads til
+ * almindelige requests.
+ */
+
+#include <WiFi.h>
+#include <Arduino.h>
+
+#include "WebServerHandler.h"
+
+#ifndef WEB_MAX_CONN
+#define WEB_MAX_CONN        4       // Samtidige forbindelser
+#endif
+#define WEB_HDR_BUF         1536    // Max header-størrelse pr. forbindelse
+#define WEB_HDR_TIMEOUT_MS  2000    // Max tid til at modtage en komplet header
+#define WEB_IDLE_TIMEOUT_MS 5000    // Keep-alive: max tomgang mellem requests
+#define WEB_MAX_SSE         2       // Max samtidige /events streams
+#define WEB_SSE_TICK_MS     250     // Interval for status-delta til SSE-klienter
+#define WEB_SSE_BUF         384     // Max størrelse af ét SSE-event
+#define WEB_FILE_BUF        4096    // Download: max SD-læsning pr. write (multiplum af 512)
+#define WEB_FILE_CHUNKS     3       // Download: max læs/send-runder pr. forbindelse pr. poll()
+#define WEB_SEND_TIMEOUT_MS 10000   // Download: max tid uden fremdrift (klienten læser ikke)
+
+class WebServerEngine : public WebFileGuard {
+public:
+    WebServerEngine(WiFiServer& server, WebServerHandler& handler)
+        : server(server), handler(handler) {
+        handler.setFileGuard(this);
+    }
+
+    /** Kald fra loop() – accepterer nye klienter og servicerer alle aktive. */
+    void poll() {
+        acceptNew();
+        for (int i = 0; i < WEB_MAX_CONN; i++) {
+            if (conns[i].state == CONN_READ_HEADERS) service(conns[i]);
+            else if (conns[i].state == CONN_SEND_FILE) serviceFile(conns[i]);
+            else if (conns[i].state == CONN_RECV_BODY) serviceBody(conns[i]);
+            else if (conns[i].state == CONN_SSE) serviceSse(conns[i]);
+        }
+        broadcastSse();
+    }
+
+    /** TX-tællere (svar, bytes, segmenter). */
+    const WebTxStats& txStats() const { return tx.stats; }
+
+    /** Streames filen med denne første sektor af en forbindelse i CONN_SEND_FILE? */
+    bool fileSending(uint32_t firstSector) override {
+        for (int i = 0; i < WEB_MAX_CONN; i++) {
+            Conn& c = conns[i];
+            if (c.state == CONN_SEND_FILE && c.file.isOpen() && c.file.firstSector() == firstSector) return true;
+        }
+        return false;
+    }
+
+    /** Antal aktive forbindelser (til debug/status). */
+    uint8_t activeConnections() const {
+        uint8_t n = 0;
+        for (int i = 0; i < WEB_MAX_CONN; i++) {
+            if (conns[i].state != CONN_FREE) n++;
+        }
+        return n;
+    }
+
+private:
+    enum ConnState : uint8_t {
+        CONN_FREE,          // Ledig plads i tabellen
+        CONN_READ_HEADERS,  // Venter på resten af request-headeren
+        CONN_SEND_FILE,     // Header sendt, fil-body streames (download)
+        CONN_RECV_BODY,     // Request-body fødes til handleren (upload)
+        CONN_SSE            // Åben /events stream
+    };
+
+    struct Conn {
+        WiFiClient client;
+        ConnState  state = CONN_FREE;
+        uint32_t   startMs = 0;     // Accept / første byte / forrige svar (timeout)
+        uint16_t   len = 0;         // Bytes i buf
+        uint8_t    crlfMatch = 0;   // Antal matchede tegn af "\r\n\r\n"
+        bool       idle = false;    // Keep-alive tomgang (venter på næste request)
+        bool       keep = false;    // Download: genbrug forbindelsen når filen er sendt
+        FsFile     file;            // Download: åben fil (CONN_SEND_FILE)
+        uint32_t   fileLeft = 0;    // Download: bytes tilbage / upload: body-bytes tilbage
+        uint32_t   fileSent = 0;    // Download: bytes sendt
+        uint32_t   fileT0 = 0;      // Download: millis() ved start (KB/s)
+        char       buf[WEB_HDR_BUF];
+    };
+
+    WiFiServer& server;
+    WebServerHandler& handler;
+    Conn conns[WEB_MAX_CONN];
+    WebTxBuffer tx;
+
+    alignas(4) uint8_t fileBuf[WEB_FILE_BUF];   // Fælles download/upload – tømmes i samme poll()
+
+    uint32_t lastSseTickMs = 0;
+    char sseBuf[WEB_SSE_BUF];
+
+    uint8_t countState(ConnState st) const {
+        uint8_t n = 0;
+        for (int i = 0; i < WEB_MAX_CONN; i++) {
+            if (conns[i].state == st) n++;
+        }
+        return n;
+    }
+
+    Conn* findFree() {
+        for (int i = 0; i < WEB_MAX_CONN; i++) {
+            if (conns[i].state == CONN_FREE) return &conns[i];
+        }
+        return nullptr;
+    }
+
+    /** Ældste keep-alive forbindelse i tomgang (kan overtages af en ny klient). */
+    Conn* findIdle() {
+        Conn* oldest = nullptr;
+        for (int i = 0; i < WEB_MAX_CONN; i++) {
+            Conn& c = conns[i];
+            if (c.state != CONN_READ_HEADERS || !c.idle) continue;
+            if (!oldest || (int32_t)(c.startMs - oldest->startMs) < 0) oldest = &c;
+        }
+        return oldest;
+    }
+
+    void acceptNew() {
+        WiFiClient nc = server.available();
+        if (!nc) return;
+
+        Conn* c = findFree();
+        if (!c && (c = findIdle()) != nullptr) close(*c);
+        if (!c) {
+            nc.print("HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\n\r\n");
+            nc.stop();
+            return;
+        }
+        c->client = nc;
+        c->client.setNoDelay(true);   // Header og body sendes som separate writes – undgå Nagle-forsinkelse
+        c->state = CONN_READ_HEADERS;
+        c->startMs = millis();
+        c->len = 0;
+        c->crlfMatch = 0;
+        c->idle = false;
+    }
+
+    void close(Conn& c) {
+        if (c.file.isOpen()) c.file.close();
+        if (c.state == CONN_RECV_BODY) handler.uploadAbort();
+        c.client.stop();
+        c.client = WiFiClient();
+        c.state = CONN_FREE;
+        c.len = 0;
+        c.crlfMatch = 0;
+        c.idle = false;
+    }
+
+    /** Scan nye bytes for "\r\n\r\n". Returnerer index lige efter headeren, ellers -1. */
+    static int scanHeaderEnd(Conn& c, uint16_t from) {
+        static const char pat[4] = {'\r', '\n', '\r', '\n'};
+        for (uint16_t i = from; i < c.len; i++) {
+            char ch = c.buf[i];
+            if (ch == pat[c.crlfMatch]) {
+                if (++c.crlfMatch == 4) return i + 1;
+            } else {
+                c.crlfMatch = (ch == '\r') ? 1 : 0;
+            }
+        }
+        return -1;
+    }
+
+    void service(Conn& c) {
+        uint32_t timeout = c.idle ? WEB_IDLE_TIMEOUT_MS : WEB_HDR_TIMEOUT_MS;
+        if (millis() - c.startMs > timeout) {
+            close(c);
+            return;
+        }
+
+        int avail = c.client.available();
+        if (avail <= 0) {
+            if (!c.client.connected()) close(c);
+            return;
+        }
+
+        uint16_t space = (uint16_t)(WEB_HDR_BUF - c.len);
+        if (space == 0) {
+            c.client.print("HTTP/1.1 431 Request Header Fields Too Large\r\nConnection: close\r\n\r\n");
+            close(c);
+            return;
+        }
+        if ((int)space > avail) space = (uint16_t)avail;
+
+        uint16_t from = c.len;
+        int n = c.client.read((uint8_t*)c.buf + c.len, space);
+        if (n <= 0) return;
+        c.len += (uint16_t)n;
+        if (c.idle) {
+            c.idle = false;            // Ny request på genbrugt forbindelse
+            c.startMs = millis();
+        }
+
+        int hdrEnd = scanHeaderEnd(c, from);
+        while (hdrEnd >= 0) {
+            if (!dispatch(c, (uint16_t)hdrEnd)) return;
+            hdrEnd = scanHeaderEnd(c, 0);   // Evt. pipelinet request allerede i buf
+        }
+    }
+
+    /**
+     * @brief Behandl én komplet request i c.buf[0..hdrEnd).
+     * @return true hvis forbindelsen holdes åben (keep-alive), false hvis lukket/SSE.
+     */
+    bool dispatch(Conn& c, uint16_t hdrEnd) {
+        // Header komplet – tokeniseres direkte i buf (evt. body-bytes følger med)
+        HttpRequest req;
+        if (!req.parse(c.buf, c.len, hdrEnd)) {
+            c.client.print("HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n");
+            close(c);
+            return false;
+        }
+        tx.begin(c.client);
+        WebReply reply = handler.handle(tx, req);
+        if (reply != REPLY_SSE && reply != REPLY_BODY) tx.end();
+        if (reply == REPLY_SSE) {
+            startSse(c);
+            return false;
+        }
+        if (!tx.ok()) {
+            close(c);
+            return false;
+        }
+        if (reply == REPLY_FILE) return startFile(c, hdrEnd);
+        if (reply == REPLY_BODY) return startBody(c, hdrEnd, (uint32_t)req.contentLength());
+        // Ulæst request-body (fx afvist upload) – forbindelsen kan ikke genbruges
+        if (!handler.keepAliveGranted() || req.contentLength() > 0) {
+            close(c);
+            return false;
+        }
+
+        // Keep-alive: flyt evt. resterende bytes (næste request) frem i buf
+        uint16_t rest = (uint16_t)(c.len - hdrEnd);
+        if (rest > 0) memmove(c.buf, c.buf + hdrEnd, rest);
+        c.len = rest;
+        c.crlfMatch = 0;
+        c.startMs = millis();
+        c.idle = (rest == 0);
+        return true;
+    }
+
+    /** Tilbage til keep-alive efter download/upload; behandl evt. pipelinede requests i buf. */
+    void resume(Conn& c) {
+        c.startMs = millis();
+        c.idle = (c.len == 0);
+        int hdrEnd = scanHeaderEnd(c, 0);
+        while (hdrEnd >= 0) {
+            if (!dispatch(c, (uint16_t)hdrEnd)) return;
+            hdrEnd = scanHeaderEnd(c, 0);
+        }
+    }
+
+    // ------------------ Download (fil-body) ------------------
+    /** Overtag filen fra handleren; evt. pipelinede bytes gemmes til efter downloaden. */
+    bool startFile(Conn& c, uint16_t hdrEnd) {
+        if (!handler.takeFile(c.file, c.fileLeft)) {
+            close(c);
+            return false;
+        }
+        uint16_t rest = (uint16_t)(c.len - hdrEnd);
+        if (rest > 0) memmove(c.buf, c.buf + hdrEnd, rest);
+        c.len = rest;
+        c.crlfMatch = 0;
+        c.keep = handler.keepAliveGranted();
+        c.fileSent = 0;
+        c.fileT0 = c.startMs = millis();
+        c.state = CONN_SEND_FILE;
+        return false;   // Ikke flere requests før filen er sendt
+    }
+
+    void serviceFile(Conn& c) {
+        if (!c.client.connected() || millis() - c.startMs > WEB_SEND_TIMEOUT_MS) {
+            Serial.printf("Download afbrudt efter %lu bytes\n", (unsigned long)c.fileSent);
+            close(c);
+            return;
+        }
+        for (int round = 0; round < WEB_FILE_CHUNKS && c.fileLeft > 0; round++) {
+            uint32_t space = (uint32_t)c.client.availableForWrite();
+            uint32_t want = c.fileLeft;
+            if (want > WEB_FILE_BUF) want = WEB_FILE_BUF;
+            if (want > space) want = space;
+
+            // Hold læsningerne på sektorgrænser: første bid op til næste 512-grænse,
+            // derefter hele sektorer (SdFat læser dem direkte uden om sin cache)
+            uint32_t toBoundary = 512 - (uint32_t)(c.file.curPosition() & 511);
+            if (toBoundary < 512) {
+                if (want > toBoundary) want = toBoundary;
+            } else if (want >= 512) {
+                want &= ~511u;
+            } else if (want < c.fileLeft) {
+                return;                 // Vent på plads til en hel sektor
+            }
+            if (want == 0) return;      // Sendebufferen er fuld
+
+            int n = c.file.read(fileBuf, want);
+            if (n <= 0 || c.client.write(fileBuf, (size_t)n) != (size_t)n) {
+                Serial.printf("Download fejl efter %lu bytes\n", (unsigned long)c.fileSent);
+                close(c);
+                return;
+            }
+            c.fileLeft -= (uint32_t)n;
+            c.fileSent += (uint32_t)n;
+            c.startMs = millis();
+        }
+        if (c.fileLeft == 0) finishFile(c);
+    }
+
+    void finishFile(Conn& c) {
+        uint32_t ms = millis() - c.fileT0;
+        Serial.printf("Download: %lu bytes på %lu ms (%lu KB/s)\n", (unsigned long)c.fileSent,
+                      (unsigned long)ms, (unsigned long)(ms ? c.fileSent / ms : 0));   // bytes/ms ≈ KB/s
+        c.file.close();
+        if (!c.keep) {
+            close(c);
+            return;
+        }
+        c.state = CONN_READ_HEADERS;
+        resume(c);
+    }
+
+    // ------------------ Upload (request-body) ------------------
+    /** Fød body-bytes der allerede ligger i buf; evt. bytes derefter er næste request. */
+    bool startBody(Conn& c, uint16_t hdrEnd, uint32_t bodyLen) {
+        uint16_t have = (uint16_t)(c.len - hdrEnd);
+        if (have > bodyLen) have = (uint16_t)bodyLen;
+        if (have > 0) handler.uploadFeed((const uint8_t*)c.buf + hdrEnd, have);
+        uint16_t used = (uint16_t)(hdrEnd + have);
+        uint16_t rest = (uint16_t)(c.len - used);
+        if (rest > 0) memmove(c.buf, c.buf + used, rest);
+        c.len = rest;
+        c.crlfMatch = 0;
+        c.keep = handler.keepAliveGranted();
+        c.fileLeft = bodyLen - have;
+        c.startMs = millis();
+        c.state = CONN_RECV_BODY;
+        if (c.fileLeft == 0) finishBody(c);
+        return false;
+    }
+
+    void serviceBody(Conn& c) {
+        if (millis() - c.startMs > WEB_SEND_TIMEOUT_MS) {
+            close(c);
+            return;
+        }
+        for (int round = 0; round < WEB_FILE_CHUNKS && c.fileLeft > 0; round++) {
+            int avail = c.client.available();
+            if (avail <= 0) {
+                if (!c.client.connected()) close(c);
+                return;
+            }
+            uint32_t want = c.fileLeft;
+            if (want > WEB_FILE_BUF) want = WEB_FILE_BUF;
+            if (want > (uint32_t)avail) want = (uint32_t)avail;
+            int n = c.client.read(fileBuf, want);
+            if (n <= 0) return;
+            handler.uploadFeed(fileBuf, (size_t)n);
+            c.fileLeft -= (uint32_t)n;
+            c.startMs = millis();
+        }
+        if (c.fileLeft == 0) finishBody(c);
+    }
+
+    void finishBody(Conn& c) {
+        c.state = CONN_READ_HEADERS;    // Før svaret: close() må ikke afbryde uploaden
+        tx.begin(c.client);
+        handler.uploadFinish(tx, c.keep);
+        tx.end();
+        if (!tx.ok() || !c.keep) {
+            close(c);
+            return;
+        }
+        resume(c);
+    }
+
+    // ------------------ Server-Sent Events ------------------
+    void startSse(Conn& c) {
+        if (countState(CONN_SSE) >= WEB_MAX_SSE) {
+            c.client.print("HTTP/1.1 503 Service Unavailable\r\nRetry-After: 10\r\nConnection: close\r\n\r\n");
+            close(c);
+            return;
+        }
+        // Header + første fulde status i ét segment
+        tx.begin(c.client);
+        tx.print("HTTP/1.1 200 OK\r\n"
+                 "Content-Type: text/event-stream\r\n"
+                 "Cache-Control: no-cache\r\n"
+                 "Connection: keep-alive\r\n\r\n"
+                 "retry: 3000\n\n");
+        size_t n = handler.buildStatusEvent(sseBuf, sizeof(sseBuf), true);
+        tx.write((const uint8_t*)sseBuf, n);
+        tx.end();
+        if (!tx.ok()) {
+            close(c);
+            return;
+        }
+        c.state = CONN_SSE;
+        c.len = 0;
+        c.idle = false;
+    }
+
+    /** SSE-klienter sender intet – dræn evt. bytes og opdag lukkede sockets. */
+    void serviceSse(Conn& c) {
+        if (!c.client.connected()) {
+            close(c);
+            return;
+        }
+        uint8_t scratch[32];
+        while (c.client.available() > 0) {
+            if (c.client.read(scratch, sizeof(scratch)) <= 0) break;
+        }
+    }
+
+    void broadcastSse() {
+        uint32_t now = millis();
+        if (now - lastSseTickMs < WEB_SSE_TICK_MS) return;
+        lastSseTickMs = now;
+        if (countState(CONN_SSE) == 0) return;
+
+        size_t n = handler.buildStatusEvent(sseBuf, sizeof(sseBuf), false);
+        if (n == 0) return;
+        for (int i = 0; i < WEB_MAX_CONN; i++) {
+            Conn& c = conns[i];
+            if (c.state != CONN_SSE) continue;
+            if (c.client.write((const uint8_t*)sseBuf, n) != n) close(c);
+        }
+    }
+};
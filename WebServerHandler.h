@@ -7,16 +7,38 @@
  *  - Parametrering af hardware via web
  *  - Log-konfiguration og status
  *  - Filbrowser + upload/download/delete på SD
- *  - Kommunikation med hardware via globale variabler (mutexbeskyttet)
+ *  - Status læses fra StatusSnapshot (publiceret af core1, ingen mutex)
+ *  - Kommandoer (slider, on/off) til core1 via globale variabler (lys_mutex)
+ *
+ * Routing:
+ *  - Request-linjen tokeniseres af HttpRequest (ingen String-allokering);
+ *    path slås op i route-tabellen WEB_ROUTES (HttpRequest.h) via switch på hash.
+ *
+ * Forbindelser:
+ *  - Alle svar skrives til WebTxBuffer (samles til fulde TCP-segmenter).
+ *  - Alle svar har Content-Length (eller er uden body), så WebServerEngine kan
+ *    genbruge socket'en (HTTP/1.1 keep-alive). Svar hvor længden ikke kendes
+ *    på forhånd sendes med "Connection: close".
+ *
+ * Dynamiske sider (opsætning, log-konfiguration):
+ *  - Template i flash med %NAVN% pladsholdere, streames af WebTemplate.h.
+ *    Én tællepass giver Content-Length; ingen String-kopi af siden.
+ *
+ * Statiske sider:
+ *  - index.htm, filebrowser.htm og opsaetning.css/.js ligger gzip'et i flash
+ *    (WebStatic.h, genereres fra web/ med tools/webgz.py) og serveres med ETag/304.
  *
  * Mode UI:
  *  - Skift af mode laver PREVIEW reload (ingen gem): /opsaetning.htm?previewMode=Tid|Klokken|Astro
  *  - "Gem opsætning" gemmer parametre + redirecter til /opsaetning.htm (uden previewMode)
  *
  * Segmenter:
- *  - seg2/seg3 kan begrænses på ugedage via weekmask:
- *    tm_wday mapping: 0=Sunday ... 6=Saturday
- *    mask bit i = (1 << tm_wday)
+ *  - Op til LYS_MAX_SEGMENTS tillægssegmenter (segment 2, 3, …), hver med
+ *    start/slut (klokkeslæt eller solnedgang/solopgang ± min), ugedage og niveau.
+ *    Ved overlap vinder øverste række (laveste index).
+ *  - Ugedage som weekmask: tm_wday mapping 0=Sunday ... 6=Saturday, bit i = (1 << tm_wday)
+ *  - Rækkerne har ingen name; opsaetning.js pakker dem i ét felt "segs" ved submit
+ *    (se parseSegsQuery), så hele request'en holder sig under WEB_HDR_BUF.
  *
  * Astro:
  *  - Felter: astroEnabled, astroLat, astroLon, astroSunsetOffsetMin, astroSunriseOffsetMin, astroLuxEarlyStart
@@ -25,189 +47,496 @@
 
 #include <WiFi.h>
 #include <Arduino.h>
-#include <ArduinoJson.h>
-#include <vector>
+#include <algorithm>
 #include <SdFat.h>
+#include "hardware/timer.h"
 
+#include "HttpRequest.h"
 #include "LysParam.h"
 #include "mitjason.h"
 #include "lyslog.h"
+#include "WebStatic.h"
+#include "WebTemplate.h"
+#include "WebTxBuffer.h"
+#include "StatusSnapshot.h"
+#include "EpochClock.h"
+#include "MultipartStream.h"
+#include "EventRing.h"
+#include "SensorHistory.h"
+#include "LoopTiming.h"
+#include "LysSchedule.h"
+
+#define UPLOAD_BUF 4096     // Upload: SD skrives i bidder af denne størrelse (multiplum af 512)
 
 // Eksterne variabler (mutexbeskyttelse påkrævet hvis der skrives/ændres!)
 extern mutex_t lys_mutex;
-extern mutex_t nat_mutex;
 extern mutex_t param_mutex;
-extern mutex_t pir_mutex;
 
 extern LysLog* lyslog;
+extern uint32_t wifiReconnects;
 extern LysParam lysparam;
 extern MitJsonWiFi* mitjason;
 extern SdFat sd;
 
-// Midlertidig kopi til webformular (lokal kopi)
+/**
+ * Implementeres af WebServerEngine: streames en fil (identificeret ved første sektor)
+ * lige nu til en klient? Sletning/overskrivning ville frigive clusters som downloaden
+ * stadig læser, så /delete og /upload afviser med 409 i stedet.
+ */
+class WebFileGuard {
+public:
+    virtual bool fileSending(uint32_t firstSector) = 0;
+};
 
+/**
+ * Resultat af handle(): færdig (keep-alive/luk, se keepAliveGranted()), overgå til
+ * SSE-stream, header sendt og fil-body streames af WebServerEngine (takeFile()),
+ * eller request-body skal fødes til handleren (uploadFeed()/uploadFinish()).
+ */
+enum WebReply : uint8_t { REPLY_DONE, REPLY_SSE, REPLY_FILE, REPLY_BODY };
 
 class WebServerHandler {
 private:
-    // ------------------ Utils: query parsing ------------------
+    // ------------------ Web-kopi af LysParam (kopieres under param_mutex) ------------------
     LysParam lysparamWeb;
-    static bool hasQueryKeyEq(const String& params, const char* key, const char* value) {
-        String needle = String(key) + "=" + value;
-        return params.indexOf(needle) >= 0;
+
+    // ------------------ SSE status (sidst udsendte værdier) ------------------
+    static constexpr uint32_t SSE_ENV_MS  = 10000;  // Min. interval for temp/tryk/CPU alene
+    static constexpr uint32_t SSE_TIME_MS = 30000;  // Tid/heartbeat interval
+
+    struct SseStatus {
+        int  lys = 0;
+        int  lux = 0;      // 0.1 lux
+        int  temp = 0;     // 0.1 °C
+        int  hpa = 0;      // 0.1 hPa
+        int  cpu = 0;      // 0.1 °C
+        bool nat = false;
+        bool perm = false;
+        uint32_t pir1 = 0;  // UTC epoch
+        uint32_t pir2 = 0;
+        uint32_t hwsw = 0;
+    };
+    SseStatus sseLast;
+    bool sseValid = false;
+    uint32_t sseLastEnvMs = 0;
+    uint32_t sseLastTimeMs = 0;
+
+    static int deci(float v) { return (int)lroundf(v * 10.0f); }
+
+    // ------------------ Metrics pr. route ------------------
+    static constexpr uint8_t METRICS_BUCKETS = 8;
+
+    /** Øvre grænser (µs) for latens-histogrammet; sidste bucket er +Inf. */
+    static uint32_t metricsBucketUs(uint8_t b) {
+        static const uint32_t le[METRICS_BUCKETS - 1] = {1000, 5000, 10000, 25000, 50000, 100000, 500000};
+        return b < METRICS_BUCKETS - 1 ? le[b] : 0xFFFFFFFFu;
+    }
+
+    struct RouteStats {
+        uint32_t count = 0;
+        uint64_t sumUs = 0;
+        uint32_t buckets[METRICS_BUCKETS] = {};     // Ikke-kumulative; summeres ved udskrivning
+    };
+    RouteStats routeStats[ROUTE_COUNT];             // [ROUTE_NONE] = ukendte paths
+
+    void recordRoute(WebRoute r, uint32_t us) {
+        RouteStats& s = routeStats[r];
+        s.count++;
+        s.sumUs += us;
+        uint8_t b = 0;
+        while (us > metricsBucketUs(b)) b++;
+        s.buckets[b]++;
     }
 
-    static int toMin(int h, int m) { return h * 60 + m; }
-    static void fromMin(int v, int &h, int &m) { h = v / 60; m = v % 60; }
+    /** Værdier der kan ændre sig under afsendelsen – fastfryses før tællepass og afsendelse. */
+    struct MetricsValues {
+        StatusSnapshot st;
+        uint64_t uptimeMs;
+        uint32_t wifiReconnects;
+        uint32_t eventDrops;
+        uint32_t eventHighWater;
+        uint32_t txResponses;
+        uint32_t txBytes;
+        uint32_t logLines;
+        uint32_t logSyncs;
+        uint32_t sdErrors;
+    };
+
+    // ------------------ Keep-alive for aktuel request ------------------
+    bool keepAlive = false;
+
+    // ------------------ Download overdraget til WebServerEngine ------------------
+    FsFile   pendingFile;
+    uint32_t pendingLen = 0;
+    WebFileGuard* fileGuard = nullptr;
+
+    /** Er filen på path ved at blive downloadet? (tomme filer har ingen clusters at frigive) */
+    static bool fileSending(WebFileGuard* guard, const char* path) {
+        if (!guard) return false;
+        FsFile f = sd.open(path, O_RDONLY);
+        if (!f) return false;
+        uint32_t sector = f.isDir() ? 0 : f.firstSector();
+        f.close();
+        return sector != 0 && guard->fileSending(sector);
+    }
+
+    // ------------------ Status fra core1 ------------------
+    StatusSnapshot snap;    // Seneste konsistente kopi (beholdes hvis læsning ikke lykkes)
+
+    const StatusSnapshot& readSnapshot() {
+        statusSnapshot.read(snap);
+        return snap;
+    }
 
-    static void clampStartNotBefore(int &startH, int &startM, int minAllowed) {
-        int s = toMin(startH, startM);
-        if (s < minAllowed) fromMin(minAllowed, startH, startM);
+    void readSseStatus(SseStatus& s) {
+        const StatusSnapshot& st = readSnapshot();
+        s.lys  = st.lysprocent;
+        s.lux  = deci(st.lux);
+        s.temp = deci(st.temp);
+        s.hpa  = deci(st.pressure);
+        s.cpu  = deci(st.cpuTemp);
+        s.perm = st.forcedOn;
+        s.nat  = st.nat;
+        s.pir1 = st.pir1Epoch;
+        s.pir2 = st.pir2Epoch;
+        s.hwsw = st.hwswEpoch;
+    }
+    // ------------------ Segmenter: pakket formularfelt ------------------
+    /**
+     * Tid i segs-feltet: "HHMM" (klokkeslæt), "s[±N]" (solnedgang), "r[±N]" (solopgang).
+     * Kun URL-sikre tegn, så feltet ikke vokser ved %-kodning.
+     */
+    static bool parseSegToken(const char* s, SegTime& out) {
+        SegTime t;
+        if (*s == 's' || *s == 'r') {
+            t.anchor = (*s == 's') ? ANCHOR_SUNSET : ANCHOR_SUNRISE;
+            char* end;
+            long off = s[1] ? strtol(s + 1, &end, 10) : 0;
+            if ((s[1] && *end) || off < -720 || off > 720) return false;
+            t.min = (int16_t)off;
+        } else {
+            if (strlen(s) != 4) return false;
+            for (int i = 0; i < 4; i++) if (s[i] < '0' || s[i] > '9') return false;
+            int h = (s[0] - '0') * 10 + (s[1] - '0');
+            int m = (s[2] - '0') * 10 + (s[3] - '0');
+            if (h > 23 || m > 59) return false;
+            t.min = (int16_t)(h * 60 + m);
+        }
+        out = t;
+        return true;
     }
 
-    static String getRequestLine(const String& req) {
-        int lineEnd = req.indexOf("\r\n");
-        return (lineEnd > 0) ? req.substring(0, lineEnd) : req;
+    /**
+     * @brief segs=on.mask.level.start.end_on.mask.level.start.end…  → p.segs[]
+     *        level tom = pwmA, mask 0 = alle dage. Ugyldige rækker springes over.
+     */
+    static void parseSegsQuery(const char* v, LysParam& p) {
+        uint8_t n = 0;
+        while (*v && n < LYS_MAX_SEGMENTS) {
+            const char* rowEnd = strchr(v, '_');
+            size_t len = rowEnd ? (size_t)(rowEnd - v) : strlen(v);
+            char row[48];
+            if (len < sizeof(row)) {
+                memcpy(row, v, len);
+                row[len] = '\0';
+                char* f[5];
+                int nf = 0;
+                for (char* q = row; nf < 5; ) {
+                    f[nf++] = q;
+                    q = strchr(q, '.');
+                    if (!q) break;
+                    *q++ = '\0';
+                }
+                LysSegment sg;
+                if (nf == 5 && parseSegToken(f[3], sg.start) && parseSegToken(f[4], sg.end)) {
+                    sg.enabled = (f[0][0] == '1');
+                    int mask = atoi(f[1]) & 0x7F;
+                    sg.weekMask = mask ? (uint8_t)mask : (uint8_t)0x7F;
+                    sg.level = f[2][0] ? (int8_t)constrain(atoi(f[2]), -1, 100) : (int8_t)SEG_LEVEL_PWMA;
+                    p.segs[n++] = sg;
+                }
+            }
+            if (!rowEnd) break;
+            v = rowEnd + 1;
+        }
+        p.segCount = n;
+        for (uint8_t i = n; i < LYS_MAX_SEGMENTS; i++) p.segs[i] = LysSegment();
     }
 
-    static String getQueryStringFromRequestLine(const String& requestLine) {
-        int q = requestLine.indexOf('?');
-        if (q < 0) return "";
-        int space = requestLine.indexOf(' ', q);
-        if (space < 0) space = requestLine.length();
-        return requestLine.substring(q + 1, space);
+    static void printWeekDays(Print& out, uint8_t mask) {
+        static const char* label[7] = {"Søn","Man","Tir","Ons","Tor","Fre","Lør"};
+        for (int i = 0; i < 7; i++) {
+            out.print("<label style=\"display:inline-block; min-width:0; margin-right:10px;\">");
+            out.print("<input type=\"checkbox\" class=\"seg-day\" value=\"");
+            out.print(1u << i);
+            out.print("\" ");
+            if (mask & (1u << i)) out.print("checked");
+            out.print("> ");
+            out.print(label[i]);
+            out.print("</label>");
+        }
     }
 
-    static String getQueryParamFromRequestLine(const String& requestLine, const char* key) {
-        String q = getQueryStringFromRequestLine(requestLine);
-        if (q.length() == 0) return "";
+    // ------------------ Template-værdier: opsætning ------------------
+    /** Udfylder pladsholdere i opsætnings-templaten; MODE_BLOCKS renderer under-templates. */
+    struct OpsaetningFill {
+        const LysParam& p;
+        bool isTid;
+        bool isKlokken;
+        bool isAstro;
+        const char* tplTid;
+        const char* tplSeg;
+        const char* tplSegRow;
+        const char* tplAstro;
+        int seg = -1;           // Segment-række under rendering af tplSegRow
+
+        /** Række i: eksisterende segment, ellers en tom række til et nyt. */
+        const LysSegment* row() const { return seg < p.segCount ? &p.segs[seg] : nullptr; }
+
+        void segTime(Print& out, bool start) const {
+            const LysSegment* r = row();
+            if (!r) return;
+            char buf[20];
+            formatSegTime(buf, sizeof(buf), start ? r->start : r->end);
+            out.print(buf);
+        }
 
-        String needle = String(key) + "=";
-        int p = q.indexOf(needle);
-        if (p < 0) return "";
+        static void checked(Print& out, bool on) { if (on) out.print("checked"); }
 
-        int start = p + needle.length();
-        int end = q.indexOf('&', start);
-        if (end < 0) end = q.length();
+        void operator()(Print& out, const HttpSlice& name) {
+            switch (fnv1aSlice(name.p, name.len)) {
+                case fnv1a("MODE_BLOCKS"):
+                    if (isTid) webTemplateRender(out, tplTid, *this);
+                    if (isKlokken || isAstro) webTemplateRender(out, tplSeg, *this);
+                    if (isAstro) webTemplateRender(out, tplAstro, *this);
+                    break;
 
-        String val = q.substring(start, end);
-        val.replace("+", " ");
-        val.trim();
-        return val;
+                case fnv1a("PWMA"):            out.print(p.pwmA); break;
+                case fnv1a("PWMC"):            out.print(p.pwmC); break;
+                case fnv1a("PWME"):            out.print(p.pwmE); break;
+                case fnv1a("PWMG"):            out.print(p.pwmG); break;
+                case fnv1a("LUX"):             out.print((int)p.luxstartvaerdi); break;
+                case fnv1a("NATDAG"):          out.print(p.natdagdelay); break;
+                case fnv1a("SOFTSTEP"):        out.print(p.aktuelStepfrekvens); break;
+
+                case fnv1a("TIMERA"):          out.print(p.timerA); break;
+                case fnv1a("TIMERC"):          out.print(p.timerC); break;
+                case fnv1a("TIMERE"):          out.print(p.timerE); break;
+
+                case fnv1a("KLOKKETIMER"):     out.print(p.slutKlokkeTimer); break;
+                case fnv1a("KLOKKEMINUTTER"):  out.print(p.slutKlokkeMinutter); break;
+
+                // Tillægssegmenter: de gemte + én tom række (op til LYS_MAX_SEGMENTS)
+                case fnv1a("SEGROWS"): {
+                    int rows = p.segCount < LYS_MAX_SEGMENTS ? p.segCount + 1 : LYS_MAX_SEGMENTS;
+                    for (int i = 0; i < rows; i++) {
+                        OpsaetningFill r = *this;
+                        r.seg = i;
+                        webTemplateRender(out, tplSegRow, r);
+                    }
+                    break;
+                }
+                case fnv1a("SEGMAX"):          out.print(LYS_MAX_SEGMENTS); break;
+                case fnv1a("SEGNO"):           out.print(seg + 2); break;
+                case fnv1a("SEGON"):           checked(out, row() && row()->enabled); break;
+                case fnv1a("SEGSTART"):        segTime(out, true); break;
+                case fnv1a("SEGEND"):          segTime(out, false); break;
+                case fnv1a("SEGLEVEL"):        if (row() && row()->level >= 0) out.print(row()->level); break;
+                case fnv1a("SEGPATTERN"):      out.print("\\s*([01]?\\d|2[0-3])[:.][0-5]\\d\\s*|\\s*[Ss]ol(nedgang|opgang)\\s*([+\\-]\\d{1,3})?\\s*"); break;
+                case fnv1a("SEGDAYS"):         printWeekDays(out, row() ? row()->weekMask : 0x7F); break;
+
+                case fnv1a("ASTROENABLED"):    checked(out, p.astroEnabled); break;
+                case fnv1a("ASTROLAT"):        out.print(p.astroLat, 4); break;
+                case fnv1a("ASTROLON"):        out.print(p.astroLon, 4); break;
+                case fnv1a("ASTROSUNSETOFF"):  out.print(p.astroSunsetOffsetMin); break;
+                case fnv1a("ASTROSUNRISEOFF"): out.print(p.astroSunriseOffsetMin); break;
+                case fnv1a("ASTROLUXEARLY"):   checked(out, p.astroLuxEarlyStart); break;
+
+                // Mode radio følger renderMode (evt. preview)
+                case fnv1a("MODETID"):         checked(out, isTid); break;
+                case fnv1a("MODEKLOKKEN"):     checked(out, isKlokken); break;
+                case fnv1a("MODEASTRO"):       checked(out, isAstro); break;
+                default: break;
+            }
+        }
+    };
+
+    // ------------------ Filebrowser: mappeliste ------------------
+    static constexpr long DIRLIST_DEFAULT_LIMIT = 100;
+    static constexpr long DIRLIST_MAX_LIMIT     = 250;
+    static constexpr uint16_t DIRLIST_SORT_MAX  = 256;   // Heap-størrelse pr. gennemløb ved sortering
+
+    enum DirSort : uint8_t { DIRSORT_NONE, DIRSORT_MTIME, DIRSORT_SIZE };
+
+    /** Sorteringsnøgle + position i mappen (filen genåbnes via index ved udskrivning). */
+    struct DirKey {
+        uint32_t key;
+        uint32_t index;
+    };
+    DirKey dirKeys[DIRLIST_SORT_MAX];   // Fast buffer – uafhængig af antal filer i mappen
+
+    static bool dirKeyLess(const DirKey& a, const DirKey& b) {
+        return a.key != b.key ? a.key < b.key : a.index < b.index;
     }
 
-    static bool extractIntFromParams(const String& params, const char* key, int& out) {
-        String needle = String(key) + "=";
-        int p = params.indexOf(needle);
-        if (p < 0) return false;
-        int start = p + needle.length();
-        int end = params.indexOf('&', start);
-        if (end < 0) end = params.length();
-        out = params.substring(start, end).toInt();
-        return true;
+    static uint32_t dirSortKey(FsFile& e, DirSort sort, bool asc) {
+        uint32_t k = 0;
+        if (sort == DIRSORT_MTIME) {
+            uint16_t d = 0, t = 0;
+            e.getModifyDateTime(&d, &t);
+            k = ((uint32_t)d << 16) | t;
+        } else if (!e.isDir()) {
+            uint64_t sz = e.fileSize();
+            k = sz > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)sz;
+        }
+        return asc ? k : ~k;
     }
 
-    static bool extractFloatFromParams(const String& params, const char* key, float& out) {
-        String needle = String(key) + "=";
-        int p = params.indexOf(needle);
-        if (p < 0) return false;
-        int start = p + needle.length();
-        int end = params.indexOf('&', start);
-        if (end < 0) end = params.length();
-        out = params.substring(start, end).toFloat();
-        return true;
+    /**
+     * @brief Find de første keep entries i sorteret rækkefølge (bounded max-heap).
+     * @param after Kun nøgler efter denne (keyset fra forrige gennemløb); nullptr = fra starten.
+     * @return Antal nøgler i dirKeys (sorteret); total = antal entries i mappen.
+     */
+    uint16_t collectSorted(FsFile& dir, DirSort sort, bool asc, uint16_t keep, uint32_t& total,
+                           const DirKey* after = nullptr) {
+        uint16_t n = 0;
+        total = 0;
+        dir.rewind();
+        FsFile e;
+        while (e.openNext(&dir, O_RDONLY)) {
+            DirKey k{dirSortKey(e, sort, asc), e.dirIndex()};
+            e.close();
+            total++;
+            if (keep == 0 || (after && !dirKeyLess(*after, k))) continue;
+            if (n < keep) {
+                dirKeys[n++] = k;
+                std::push_heap(dirKeys, dirKeys + n, dirKeyLess);
+            } else if (dirKeyLess(k, dirKeys[0])) {
+                std::pop_heap(dirKeys, dirKeys + n, dirKeyLess);
+                dirKeys[n - 1] = k;
+                std::push_heap(dirKeys, dirKeys + n, dirKeyLess);
+            }
+        }
+        std::sort_heap(dirKeys, dirKeys + n, dirKeyLess);
+        return n;
     }
 
-    // ------------------ Weekmask helpers ------------------
-    static uint8_t parseWeekMaskFromQuery(const String& params, const char* prefix) {
-        // prefix: "seg2d" / "seg3d", keys: seg2d0=1..seg2d6=1
-        uint8_t mask = 0;
-        for (int i = 0; i < 7; i++) {
-            String needle = String(prefix) + String(i) + "=1";
-            if (params.indexOf(needle) >= 0) mask |= (uint8_t)(1u << i);
+    static void writeDirEntry(Print& out, FsFile& e, const char* dirPath, bool first) {
+        char name[64];
+        e.getName(name, sizeof(name));
+        uint16_t d = 0, t = 0;
+        e.getModifyDateTime(&d, &t);
+        bool isDir = e.isDir();
+        size_t plen = strlen(dirPath);
+        const char* sep = (plen > 0 && dirPath[plen - 1] == '/') ? "" : "/";
+
+        char line[320];
+        int n = snprintf(line, sizeof(line),
+                         "%s{\"name\":\"%s\",\"path\":\"%s%s%s\",\"isDir\":%s",
+                         first ? "" : ",", name, dirPath, sep, name, isDir ? "true" : "false");
+        if (!isDir && n < (int)sizeof(line)) {
+            n += snprintf(line + n, sizeof(line) - n, ",\"size\":%lu", (unsigned long)e.fileSize());
+        }
+        if (n < (int)sizeof(line)) {
+            n += snprintf(line + n, sizeof(line) - n, ",\"mtime\":\"%04u-%02u-%02u %02u:%02u\"}",
+                          FS_YEAR(d), FS_MONTH(d), FS_DAY(d), FS_HOUR(t), FS_MINUTE(t));
         }
-        // Hvis ingen dage valgt => fail-open alle dage
-        return (mask == 0) ? (uint8_t)0x7F : mask;
+        if (n >= (int)sizeof(line)) n = sizeof(line) - 1;
+        out.write((const uint8_t*)line, n);
     }
 
-static String weekMaskToHtml(uint8_t mask, const char* prefix) {
-    static const char* label[7] = {"Søn","Man","Tir","Ons","Tor","Fre","Lør"};
-    String out;
-    out.reserve(600);
-    for (int i = 0; i < 7; i++) {
-        bool checked = (mask & (1u << i)) != 0;
-        out += "<label style=\"display:inline-block; margin-right:10px;\">";
-        out += "<input type=\"checkbox\" name=\"";
-        out += prefix;
-        out += String(i);
-        out += "\" value=\"1\" ";
-        if (checked) out += "checked";
-        out += "> ";
-        out += label[i];
-        out += "</label>";
+    /**
+     * @brief Skriv én side af mappelisten som JSON.
+     *        Usorteret: entries læses med openNext og skrives direkte.
+     *        Sorteret: dirKeys[0..nKeys) (siden fra offset) genåbnes via index.
+     */
+    void writeDirList(Print& out, FsFile& dir, const char* path, DirSort sort,
+                      long offset, long limit, uint16_t nKeys, uint32_t total) {
+        char head[200];
+        int n = snprintf(head, sizeof(head), "{\"path\":\"%s\",\"offset\":%ld,\"limit\":%ld,\"entries\":[",
+                         path, offset, limit);
+        out.write((const uint8_t*)head, n);
+
+        FsFile e;
+        bool first = true;
+        if (sort == DIRSORT_NONE) {
+            total = 0;
+            dir.rewind();
+            while (e.openNext(&dir, O_RDONLY)) {
+                if ((long)total >= offset && (long)total < offset + limit) {
+                    writeDirEntry(out, e, path, first);
+                    first = false;
+                }
+                total++;
+                e.close();
+            }
+        } else {
+            for (uint16_t i = 0; i < nKeys; i++) {
+                if (!e.open(&dir, dirKeys[i].index, O_RDONLY)) continue;
+                writeDirEntry(out, e, path, first);
+                first = false;
+                e.close();
+            }
+        }
+
+        n = snprintf(head, sizeof(head), "],\"total\":%lu}", (unsigned long)total);
+        out.write((const uint8_t*)head, n);
     }
-    return out;
-}
 
-    // ------------------ Filebrowser path parsing ------------------
-    String extractPathFromRequestLine(const String& requestLine) {
-        String path = "/";
-        int q = requestLine.indexOf('?');
-        if (q >= 0) {
-            String rest = requestLine.substring(q + 1);
-            int space = rest.indexOf(' ');
-            if (space >= 0) rest = rest.substring(0, space);
-            int p = rest.indexOf("path=");
-            if (p >= 0) {
-                int start = p + 5;
-                int end = rest.indexOf('&', start);
-                if (end == -1) end = rest.length();
-                path = rest.substring(start, end);
-                path.replace("%2F", "/");
-                path.replace("%20", " ");
-                if (!path.startsWith("/")) path = "/" + path;
+    // ------------------ Log-forespørgsler ------------------
+    static constexpr long LOGQUERY_DEFAULT_LIMIT = 100;
+    static constexpr long LOGQUERY_MAX_LIMIT     = 2000;
+
+    /** file=nat|pir|hw|events → LysLog-plads (standard pir). */
+    static bool parseLogSlot(const HttpRequest& req, uint8_t& slot) {
+        HttpSlice v;
+        if (!req.queryValue("file", v) || v.eq("pir")) slot = LOG_PIR;
+        else if (v.eq("nat"))    slot = LOG_NAT;
+        else if (v.eq("hw"))     slot = LOG_HW;
+        else if (v.eq("events")) slot = LysLog::SLOT_BIN;
+        else return false;
+        return true;
+    }
+
+    /** YYYY-MM-DD eller YYYYMMDD → YYYYMMDD. 0 hvis parameteren mangler; false hvis ugyldig. */
+    static bool parseLogDay(const HttpRequest& req, const char* key, uint32_t& day) {
+        day = 0;
+        HttpSlice v;
+        if (!req.queryValue(key, v) || v.empty()) return true;
+        uint8_t digits = 0;
+        for (uint16_t i = 0; i < v.len; i++) {
+            char c = v.p[i];
+            if (c >= '0' && c <= '9') {
+                day = day * 10 + (uint32_t)(c - '0');
+                digits++;
+            } else if (c != '-') {
+                return false;
             }
         }
-        if (path.length() == 0) path = "/";
-        return path;
+        return digits == 8;
+    }
+
+    // ------------------ Filebrowser path parsing ------------------
+    /** path=... fra query (URL-dekodet) – altid med ledende '/'. */
+    static void extractPath(const HttpRequest& req, char* out, size_t outSize) {
+        char tmp[128];
+        if (!req.queryParam("path", tmp, sizeof(tmp)) || tmp[0] == '\0') {
+            snprintf(out, outSize, "/");
+            return;
+        }
+        snprintf(out, outSize, "%s%s", (tmp[0] == '/') ? "" : "/", tmp);
     }
 
 public:
-    int&   aktuellysvaerdi;
-    float& internaltemp;
-    bool&  lys_permanet_on;
-    bool&  hardware_aktiv;
-    float& aktuellux;
-    float& aktueltemp;
-    float& aktuelpress;
+    // Kommandoer til core1
     bool&  opdaterlys;
     int&   nylysvaerdi;
     bool&  softwarehardset;
-    bool&  nataktivstatus;
-    String* pir1_tid;
-    String* pir2_tid;
-    String* hwsw_tid;
-
-    WebServerHandler(
-        int& lys, float& temp, bool& lys_on, bool& hwsw_active,
-        float& aktuel_lux, float& aktuel_temp, float& aktuel_press,
-        bool& software_active, bool& updatelysprocent,
-        int& nyupdatevaerdi, bool& natstatus,
-        String* pir1txt, String* pir2txt, String* hwswtxt
-    )
-        : aktuellysvaerdi(lys),
-          internaltemp(temp),
-          lys_permanet_on(lys_on),
-          hardware_aktiv(hwsw_active),
-          aktuellux(aktuel_lux),
-          aktueltemp(aktuel_temp),
-          aktuelpress(aktuel_press),
-          opdaterlys(updatelysprocent),
+
+    WebServerHandler(bool& software_active, bool& updatelysprocent, int& nyupdatevaerdi)
+        : opdaterlys(updatelysprocent),
           nylysvaerdi(nyupdatevaerdi),
-          softwarehardset(software_active),
-          nataktivstatus(natstatus),
-          pir1_tid(pir1txt),
-          pir2_tid(pir2txt),
-          hwsw_tid(hwswtxt)
+          softwarehardset(software_active)
     {}
 
     void nylysvaerdiCore1(int vaerdi, bool swstate) {
@@ -219,286 +548,234 @@ public:
     }
 
     // ------------------ Router ------------------
-    void handle(WiFiClient& client, const String& req) {
-        if (req.indexOf("GET / ") >= 0 || req.indexOf("GET /index.htm") >= 0) {
-            sendIndex(client);
-        } else if (req.indexOf("GET /?value=") >= 0) {
-            int pos1 = req.indexOf('=');
-            int pos2 = req.indexOf('&');
-            if (pos1 > 0 && pos2 > pos1) {
-                bool softhwset = false;
-                int value = req.substring(pos1 + 1, pos2).toInt();
-                nylysvaerdiCore1(value, softhwset);
-            }
-            sendOK(client);
-        } else if (req.indexOf("GET /on.htm") >= 0) {
-            if (!softwarehardset) {
-                bool doLog = false;
-                mutex_enter_blocking(&param_mutex);
-                doLog = lysparam.logpirdetection;
-                mutex_exit(&param_mutex);
-                if (doLog && lyslog) lyslog->logPIR("Software on");
-                softwarehardset = true;
-            }
-            sendOK(client);
-        } else if (req.indexOf("GET /off.htm") >= 0) {
-            if (!hardware_aktiv) nylysvaerdiCore1(0, false);
-            if (softwarehardset) {
-                bool doLog = false;
-                mutex_enter_blocking(&param_mutex);
-                doLog = lysparam.logpirdetection;
-                mutex_exit(&param_mutex);
-                if (doLog && lyslog) lyslog->logPIR("Software off");
-                softwarehardset = false;
-            }
-            sendOK(client);
-        } else if (req.indexOf("GET /status.htm") >= 0) {
-            sendStatus(client);
-        } else if (req.indexOf("GET /favicon.ico") >= 0) {
-            client.println("HTTP/1.1 204 No Content");
-            client.println();
-            return;
-        } else if (req.indexOf("GET /opsaetning.htm") >= 0) {
-            sendOpsaetning(client, req);
-        } else if (req.indexOf("GET /opsaetdata.htm") >= 0) {
-            processOpsaetData(client, req);
-        } else if (req.indexOf("GET /statusjson.htm") >= 0) {
-            sendStatusJSON(client);
-        } else if (req.indexOf("GET /logconfig.htm") >= 0) {
-            sendLogConfig(client);
-        } else if (req.indexOf("GET /gemlogconfig.htm") >= 0) {
-            handleGemLogConfig(client, req);
-        } else if (req.indexOf("GET /filebrowser.htm") >= 0) {
-            sendFileBrowserPage(client);
-        } else if (req.indexOf("GET /dirlist") >= 0) {
-            handleDirList(client, req);
-        } else if (req.indexOf("GET /download") >= 0) {
-            handleDownload(client, req);
-        } else if (req.indexOf("GET /delete") >= 0) {
-            handleDelete(client, req);
-        } else if (req.indexOf("POST /upload") >= 0) {
-            handleUpload(client, req);
-        } else {
-            send404(client);
+    WebReply handle(WebTxBuffer& out, const HttpRequest& req) {
+        uint32_t t0 = micros();
+        keepAlive = req.wantsKeepAlive();
+        HttpMethod expected = METHOD_GET;
+        WebRoute route = lookupRoute(req.path, expected);
+        WebReply reply = REPLY_DONE;
+        if (route != ROUTE_NONE && req.method != expected) send405(out);
+        else reply = dispatch(out, req, route);
+        recordRoute(route, micros() - t0);
+        return reply;
+    }
+
+private:
+    WebReply dispatch(WebTxBuffer& out, const HttpRequest& req, WebRoute route) {
+        switch (route) {
+            case ROUTE_ROOT:
+                if (req.hasQuery("value")) {
+                    int value = 0;
+                    if (req.queryInt("value", value)) {
+                        bool softhwset = false;
+                        nylysvaerdiCore1(value, softhwset);
+                    }
+                    sendOK(out);
+                } else {
+                    sendStatic(out, req, WEBSTATIC_INDEX_HTM);
+                }
+                break;
+            case ROUTE_INDEX:        sendStatic(out, req, WEBSTATIC_INDEX_HTM); break;
+            case ROUTE_ON:
+                if (!softwarehardset) {
+                    bool doLog = false;
+                    mutex_enter_blocking(&param_mutex);
+                    doLog = lysparam.logpirdetection;
+                    mutex_exit(&param_mutex);
+                    if (doLog && lyslog) lyslog->logEvent(swsw_on);
+                    softwarehardset = true;
+                }
+                sendOK(out);
+                break;
+            case ROUTE_OFF:
+                if (!readSnapshot().hwsw) nylysvaerdiCore1(0, false);
+                if (softwarehardset) {
+                    bool doLog = false;
+                    mutex_enter_blocking(&param_mutex);
+                    doLog = lysparam.logpirdetection;
+                    mutex_exit(&param_mutex);
+                    if (doLog && lyslog) lyslog->logEvent(swsw_off);
+                    softwarehardset = false;
+                }
+                sendOK(out);
+                break;
+            case ROUTE_STATUS:       sendStatus(out); break;
+            case ROUTE_FAVICON:      beginResponse(out, "204 No Content", nullptr, NO_BODY); break;
+            case ROUTE_OPSAETNING:   sendOpsaetning(out, req); break;
+            case ROUTE_OPSAETDATA:   processOpsaetData(out, req); break;
+            case ROUTE_STATUSJSON:   sendStatusJSON(out); break;
+            case ROUTE_LOGCONFIG:    sendLogConfig(out); break;
+            case ROUTE_GEMLOGCONFIG: handleGemLogConfig(out, req); break;
+            case ROUTE_FILEBROWSER:  sendStatic(out, req, WEBSTATIC_FILEBROWSER_HTM); break;
+            case ROUTE_OPSAETCSS:    sendStatic(out, req, WEBSTATIC_OPSAETNING_CSS); break;
+            case ROUTE_OPSAETJS:     sendStatic(out, req, WEBSTATIC_OPSAETNING_JS); break;
+            case ROUTE_DIRLIST:      handleDirList(out, req); break;
+            case ROUTE_DOWNLOAD:     return handleDownload(out, req);
+            case ROUTE_DELETE:       handleDelete(out, req); break;
+            case ROUTE_APILOG:       return handleLogQuery(out, req, false);
+            case ROUTE_APILOGTAIL:   return handleLogQuery(out, req, true);
+            case ROUTE_HISTORY:      handleHistory(out, req); break;
+            case ROUTE_APISCHEDULE:  sendSchedule(out, req); break;
+            case ROUTE_DEBUGTIMING:  sendTiming(out, req); break;
+            case ROUTE_METRICS:      sendMetrics(out); break;
+            case ROUTE_UPLOAD:       return handleUpload(out, req);
+            case ROUTE_EVENTS:       return REPLY_SSE;   // Header + stream sendes af WebServerEngine
+            default:                 send404(out); break;
         }
+        return REPLY_DONE;
     }
 
-    // ------------------ Pages ------------------
-    void sendIndex(WiFiClient& client) {
-        client.print(F(
-            "<!DOCTYPE html><html lang=\"dk\"><head>"
-            "<meta charset=\"utf-8\" />"
-            "<title>Kontrol panel</title>"
-            "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1\" />"
-            "<style>"
-            "h1, h2, p {text-align: center;}"
-            ".buttonon {background-color: #f44336; border: none; color: white; padding: 20px 40px; font-size: 20px;}"
-            ".buttonoff {background-color: #04AA6D; border: none; color: white; padding: 20px 40px; font-size: 20px;}"
-            ".stat {text-align:center; margin: 3px; font-size: 1.1em;}"
-            ".clock {text-align:center; font-size: 2em; font-weight: bold; margin: 10px 0;}"
-            "</style>"
-            "</head><body>"
-            "<h1>Kontrol panel</h1>"
-            "<div class=\"clock\" id=\"clockdiv\">--:--:--</div>"
-            "<h2>Lys on / Soft off</h2>"
-            "<p>"
-            "<button class=\"button buttonon\" title=\"Sætter systemet i låst ON\" id=\"onBtn\">ON</button>"
-            "&nbsp;&nbsp;&nbsp;"
-            "<button class=\"button buttonoff\" id=\"offBtn\" title=\"Soft OFF slukker lyset og returnerer til automatik.\">Soft OFF</button>"
-            "</p>"
-            "<h2>Variabel Lysværdi i %</h2>"
-            "<p><input type=\"range\" min=\"0\" max=\"100\" class=\"slider\" id=\"Lysslider\" value=\""
-        ));
-        client.print(aktuellysvaerdi);
-        client.print(F(
-            "\"></p>"
-            "<p>Value: <span id=\"demo\"></span></p>"
-            "<p>valgt mode <span id=\"demovalg\">OFF</span></p>"
-            "<div class=\"stat\">Målt LUX værdi = <span id=\"luxval\"></span></div>"
-            "<div class=\"stat\">Målt temperatur = <span id=\"tempval\"></span> &deg;C</div>"
-            "<div class=\"stat\">Målt Barometertryk = <span id=\"pressval\"></span> hPa</div>"
-            "<div class=\"stat\">Målt Intern cpu temperatur = <span id=\"cputempval\"></span> C</div>"
-            "<div class=\"stat\">Lys permanent on: <span id=\"lysperm\"></span></div>"
-            "<p style=\"text-align:center;\">"
-            "<button style=\"font-size:15px;\" onclick=\"opsaetning()\">Opsætning</button>"
-            "<button style=\"font-size:15px;\" onclick=\"konfigurerLog()\">Log</button>"
-            "<button style=\"font-size:15px;\" onclick=\"file()\">Fileoperationer</button>"
-            "</p>"
-            "<script>"
-            "function opsaetning() { location.replace('/opsaetning.htm'); }"
-            "function konfigurerLog() { location.replace('/logconfig.htm'); }"
-            "function file() { location.replace('/filebrowser.htm'); }"
-            "function opdaterDemovalg(val) {"
-            "  const demovalg = document.getElementById('demovalg');"
-            "  if(val === 0) demovalg.innerHTML = 'Off';"
-            "  else if(val === 100) demovalg.innerHTML = 'On';"
-            "  else demovalg.innerHTML = 'Variabel';"
-            "}"
-            "function pad(n){return n<10?'0'+n:n;}"
-            "var serverTime=null;"
-            "var serverTimeAt=null;"
-            "function updateClock(){"
-            "  if(serverTime===null) return;"
-            "  var elapsed=Math.floor((Date.now()-serverTimeAt)/1000);"
-            "  var t=new Date(serverTime.getTime()+elapsed*1000);"
-            "  document.getElementById('clockdiv').textContent="
-            "    pad(t.getHours())+':'+pad(t.getMinutes())+':'+pad(t.getSeconds());"
-            "}"
-            "document.addEventListener('DOMContentLoaded', function() {"
-            "  const slider = document.getElementById('Lysslider');"
-            "  const output = document.getElementById('demo');"
-            "  const onBtn = document.getElementById('onBtn');"
-            "  const offBtn = document.getElementById('offBtn');"
-            "  output.innerHTML = slider.value;"
-            "  opdaterDemovalg(parseInt(slider.value));"
-            "  let statusLock = false;"
-            "  let statusLockTimeout = null;"
-            "  function lockStatusUpdate() {"
-            "    statusLock = true;"
-            "    if (statusLockTimeout) clearTimeout(statusLockTimeout);"
-            "    statusLockTimeout = setTimeout(function(){ statusLock = false; }, 1200);"
-            "  }"
-            "  slider.oninput = function() {"
-            "    output.innerHTML = this.value;"
-            "    opdaterDemovalg(parseInt(this.value));"
-            "    lockStatusUpdate();"
-            "  };"
-            "  slider.onchange = function() {"
-            "    fetch('/?value=' + this.value + '&nocache=' + Math.random());"
-            "    lockStatusUpdate();"
-            "  };"
-            "  onBtn.onclick = function() {"
-            "    fetch('/on.htm&').then(function(){"
-            "      slider.value = 100;"
-            "      output.innerHTML = 100;"
-            "      opdaterDemovalg(100);"
-            "      lockStatusUpdate();"
-            "    });"
-            "  };"
-            "  offBtn.onclick = function() {"
-            "    fetch('/off.htm&').then(function(){"
-            "      slider.value = 0;"
-            "      output.innerHTML = 0;"
-            "      opdaterDemovalg(0);"
-            "      lockStatusUpdate();"
-            "    });"
-            "  };"
-            "  function opdaterStatus() {"
-            "    if (statusLock) return;"
-            "    fetch('/status.htm').then(r=>r.text()).then(function(txt){"
-            "      let lux = txt.match(/maalt lux=(-?[\\d\\.]+)/);"
-            "      let temp = txt.match(/temp=(-?[\\d\\.]+)/);"
-            "      let press = txt.match(/Hpa=(-?[\\d\\.]+)/);"
-            "      let cputemp = txt.match(/Cputemp=(-?[\\d\\.]+)/);"
-            "      let lys = txt.match(/lys procent=(-?[\\d\\.]+)/);"
-            "      let perm = txt.match(/lys_on=([01])/);"
-            "      if(lux) document.getElementById('luxval').innerText = lux[1];"
-            "      if(temp) document.getElementById('tempval').innerText = temp[1];"
-            "      if(press) document.getElementById('pressval').innerText = press[1];"
-            "      if(cputemp) document.getElementById('cputempval').innerText = cputemp[1];"
-            "      if(lys) {"
-            "        slider.value = lys[1];"
-            "        output.innerHTML = lys[1];"
-            "        opdaterDemovalg(parseInt(lys[1]));"
-            "      }"
-            "      if(perm) document.getElementById('lysperm').innerText = perm[1]==1?'Ja':'Nej';"
-            "    });"
-            "  }"
-            "  function hentTid() {"
-            "    fetch('/statusjson.htm').then(r=>r.json()).then(function(j){"
-            "      if(j.time){"
-            "        var p=j.time.split(/[\\-: ]/);"
-            "        serverTime=new Date(p[0],p[1]-1,p[2],p[3],p[4],p[5]);"
-            "        serverTimeAt=Date.now();"
-            "      }"
-            "    }).catch(function(){});"
-            "  }"
-            "  opdaterStatus();"
-            "  hentTid();"
-            "  setInterval(opdaterStatus, 5000);"
-            "  setInterval(hentTid, 30000);"
-            "  setInterval(updateClock, 1000);"
-            "});"
-            "</script>"
-            "</body></html>"
-        ));
+public:
+    /** Må forbindelsen genbruges efter sidste handle()? (klient ønskede det og svaret havde kendt længde) */
+    bool keepAliveGranted() const { return keepAlive; }
+
+    /**
+     * @brief Overtag filen efter REPLY_FILE (positioneret ved første body-byte).
+     * @param len Antal bytes der skal sendes.
+     * @return false hvis der ingen ventende fil er.
+     */
+    /** WebServerEngine registrerer sig, så sletning/overskrivning af en fil under download afvises. */
+    void setFileGuard(WebFileGuard* guard) {
+        fileGuard = guard;
+        upload.guard = guard;
     }
 
-    void sendStatus(WiFiClient& client) {
-        client.println("HTTP/1.1 200 OK");
-        client.println("Content-type:text/plain");
-        client.println();
+    bool takeFile(FsFile& dst, uint32_t& len) {
+        if (!pendingFile.isOpen()) return false;
+        dst = pendingFile;
+        len = pendingLen;
+        pendingFile.close();    // Kun read-only håndtag – dst fortsætter uafhængigt
+        pendingLen = 0;
+        return true;
+    }
 
-        mutex_enter_blocking(&lys_mutex);
-        client.print("lys procent="); client.println(aktuellysvaerdi);
-        client.print("maalt lux="); client.println(aktuellux);
-        client.print("temp="); client.println(aktueltemp);
-        client.print("Hpa="); client.println(aktuelpress);
-        client.print("Cputemp="); client.println(internaltemp);
-        client.print("lys_on="); client.println(lys_permanet_on ? 1 : 0);
-        mutex_exit(&lys_mutex);
+    // ------------------ Svar-helpers ------------------
+    static constexpr long UNKNOWN_LEN = -1;   // Længde ukendt → forbindelsen lukkes efter svaret
+    static constexpr long NO_BODY     = -2;   // 204/304: ingen body og ingen Content-Length
+
+    /**
+     * @brief Skriv statuslinje + headere i ét write.
+     * @param status fx "200 OK".
+     * @param contentType nullptr → ingen Content-Type.
+     * @param len Body-længde, UNKNOWN_LEN eller NO_BODY.
+     * @param extra Evt. ekstra header-linjer, hver afsluttet med "\r\n".
+     */
+    void beginResponse(WebTxBuffer& out, const char* status, const char* contentType,
+                       long len, const char* extra = nullptr) {
+        if (len == UNKNOWN_LEN) keepAlive = false;
+
+        char hdr[384];
+        int n = snprintf(hdr, sizeof(hdr), "HTTP/1.1 %s\r\n", status);
+        if (contentType) n += snprintf(hdr + n, sizeof(hdr) - n, "Content-Type: %s\r\n", contentType);
+        if (len >= 0)    n += snprintf(hdr + n, sizeof(hdr) - n, "Content-Length: %ld\r\n", len);
+        if (extra)       n += snprintf(hdr + n, sizeof(hdr) - n, "%s", extra);
+        n += snprintf(hdr + n, sizeof(hdr) - n, "%s",
+                      keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n");
+        if (n >= (int)sizeof(hdr)) n = sizeof(hdr) - 1;
+        out.write((const uint8_t*)hdr, n);
+    }
+
+    /** Kort tekstsvar med Content-Length. */
+    void sendText(WebTxBuffer& out, const char* status, const char* body) {
+        size_t len = strlen(body);
+        beginResponse(out, status, "text/plain", (long)len, "Cache-Control: no-cache\r\n");
+        out.write((const uint8_t*)body, len);
+    }
 
-        mutex_enter_blocking(&pir_mutex);
-        client.print("Sidste pir 1 aktivering = "); client.println(pir1_tid ? *pir1_tid : "");
-        client.print("Sidste pir 2 aktivering = "); client.println(pir2_tid ? *pir2_tid : "");
-        client.print("Sidste Kontakt aktivering = "); client.println(hwsw_tid ? *hwsw_tid : "");
-        mutex_exit(&pir_mutex);
+    /** Template-side: tællepass for Content-Length, derefter streaming til klienten. */
+    template <typename Fill>
+    void sendTemplate(WebTxBuffer& out, const char* tpl, Fill& fill) {
+        WebCountingPrint counter;
+        webTemplateRender(counter, tpl, fill);
+        beginResponse(out, "200 OK", "text/html; charset=utf-8", (long)counter.count);
+        webTemplateRender(out, tpl, fill);
     }
 
-    void sendOK(WiFiClient& client) {
-        client.println("HTTP/1.1 200 OK");
-        client.println("Content-type:text/plain");
-        client.println("Cache-Control: no-cache");
-        client.println();
-        client.println("OK");
+    void sendRedirect(WebTxBuffer& out, const char* location) {
+        char extra[64];
+        snprintf(extra, sizeof(extra), "Location: %s\r\n", location);
+        beginResponse(out, "303 See Other", nullptr, 0, extra);
     }
 
-    void send404(WiFiClient& client) {
-        client.println("HTTP/1.1 404 Not Found");
-        client.println("Content-type:text/plain");
-        client.println();
-        client.println("404 Not Found");
+    // ------------------ Pages ------------------
+    /**
+     * @brief Send forkomprimeret statisk fil (WebStatic.h) med gzip + ETag.
+     *        Matcher If-None-Match svares 304 uden body.
+     *        Alle nutidige browsere accepterer gzip; der findes ingen ukomprimeret kopi.
+     */
+    void sendStatic(WebTxBuffer& out, const HttpRequest& req, WebStaticId id) {
+        const WebStaticFile& f = webStaticFiles[id];
+
+        char extra[112];
+        HttpSlice inm;
+        if (req.header("If-None-Match", inm) && inm.find(f.etag) >= 0) {
+            snprintf(extra, sizeof(extra), "ETag: %s\r\nCache-Control: no-cache\r\n", f.etag);
+            beginResponse(out, "304 Not Modified", nullptr, NO_BODY, extra);
+            return;
+        }
+
+        snprintf(extra, sizeof(extra),
+                 "Content-Encoding: gzip\r\nETag: %s\r\nCache-Control: no-cache\r\nVary: Accept-Encoding\r\n",
+                 f.etag);
+        beginResponse(out, "200 OK", f.contentType, (long)f.len, extra);
+        out.write(f.data, f.len);
+    }
+
+    void sendStatus(WebTxBuffer& out) {
+        const StatusSnapshot& st = readSnapshot();
+        char p1[20], p2[20], hw[20];
+        EpochClock::formatLocal(st.pir1Epoch, p1, sizeof(p1));
+        EpochClock::formatLocal(st.pir2Epoch, p2, sizeof(p2));
+        EpochClock::formatLocal(st.hwswEpoch, hw, sizeof(hw));
+
+        char body[320];
+        int n = snprintf(body, sizeof(body),
+                         "lys procent=%d\r\nmaalt lux=%.2f\r\ntemp=%.2f\r\nHpa=%.2f\r\nCputemp=%.2f\r\nlys_on=%d\r\n"
+                         "Sidste pir 1 aktivering = %s\r\nSidste pir 2 aktivering = %s\r\nSidste Kontakt aktivering = %s\r\n",
+                         st.lysprocent, st.lux, st.temp, st.pressure, st.cpuTemp, st.forcedOn ? 1 : 0,
+                         p1, p2, hw);
+        if (n >= (int)sizeof(body)) n = sizeof(body) - 1;
+        beginResponse(out, "200 OK", "text/plain", n);
+        out.write((const uint8_t*)body, n);
+    }
+
+    void sendOK(WebTxBuffer& out) {
+        sendText(out, "200 OK", "OK\r\n");
+    }
+
+    void send404(WebTxBuffer& out) {
+        sendText(out, "404 Not Found", "404 Not Found\r\n");
+    }
+
+    void send405(WebTxBuffer& out) {
+        sendText(out, "405 Method Not Allowed", "405 Method Not Allowed\r\n");
     }
 
     // ------------------ Opsætning ------------------
-    void sendOpsaetning(WiFiClient& client, const String& req) {
+    void sendOpsaetning(WebTxBuffer& out, const HttpRequest& req) {
         mutex_enter_blocking(&param_mutex);
         lysparamWeb = lysparam;
         mutex_exit(&param_mutex);
 
-        String requestLine = getRequestLine(req);
-        String previewMode = getQueryParamFromRequestLine(requestLine, "previewMode");
+        char previewMode[12];
+        req.queryParam("previewMode", previewMode, sizeof(previewMode));
 
-        String renderMode = lysparamWeb.styringsvalg;
-        if (previewMode == "Tid" || previewMode == "Klokken" || previewMode == "Astro") {
-            renderMode = previewMode; // kun UI
-        }
+        LysMode renderMode = lysparamWeb.styringsvalg;
+        parseLysMode(previewMode, renderMode);     // kun UI
 
-        bool isTid     = (renderMode == "Tid");
-        bool isKlokken = (renderMode == "Klokken");
-        bool isAstro   = (renderMode == "Astro");
-        bool isSegMode = (isKlokken || isAstro);
+        bool isTid     = renderMode == MODE_TID;
+        bool isKlokken = renderMode == MODE_KLOKKEN;
+        bool isAstro   = renderMode == MODE_ASTRO;
 
-        // Base HTML + placeholder for mode blocks
-        String html = R"rawliteral(
+        // Base HTML + placeholder for mode blocks (const → flash)
+        static const char tplPage[] = R"rawliteral(
 <!DOCTYPE html>
 <html lang="da">
 <head>
   <meta charset="utf-8">
   <title>Opsætning</title>
   <meta name="viewport" content="width=device-width, initial-scale=1">
-  <style>
-    body { font-family: Arial; max-width: 760px; margin: auto; }
-    h1 { text-align: center; }
-    .slider-block { margin: 18px 0; }
-    label { min-width: 210px; display: inline-block; }
-    .value { font-weight: bold; margin-left: 16px; }
-    .mode-block { margin: 18px 0; padding: 10px; border-top: 1px solid #eee; }
-    .segment-box { border: 1px solid #ddd; padding: 12px; margin: 12px 0; }
-    .hint { font-size: 0.9em; color: #555; margin-top: 6px; }
-    .weekdays { margin: 10px 0; }
-    input[type="number"] { padding: 3px; }
-  </style>
+  <link rel="stylesheet" href="/opsaetning.css">
 </head>
 <body>
   <h1>Opsætning</h1>
@@ -563,34 +840,13 @@ public:
     </div>
   </form>
 
-  <script>
-    function index() { location.replace('/index.htm'); }
-
-    function modePreviewChanged(val) {
-      location.replace('/opsaetning.htm?previewMode=' + encodeURIComponent(val));
-    }
-
-    function updateValues() {
-      document.getElementById('val_pwma').textContent = pwma.value;
-      document.getElementById('val_pwmc').textContent = pwmc.value;
-      document.getElementById('val_pwme').textContent = pwme.value;
-      document.getElementById('val_pwmg').textContent = pwmg.value;
-      document.getElementById('val_luxstart').textContent = luxstart.value;
-      document.getElementById('val_delay').textContent = delay.value;
-      document.getElementById('val_stepfrekvens').textContent = stepfrekvens.value;
-    }
-    updateValues();
-  </script>
+  <script src="/opsaetning.js"></script>
 </body>
 </html>
 )rawliteral";
 
-        // Build mode blocks
-        String blocks;
-        blocks.reserve(3500);
-
-        if (isTid) {
-            blocks += R"rawliteral(
+        // Mode blocks (indsættes ved %MODE_BLOCKS%)
+        static const char tplTid[] = R"rawliteral(
 <div class="segment-box">
   <strong>Timer (Tid-mode)</strong><br><br>
 
@@ -610,10 +866,8 @@ public:
   </div>
 </div>
 )rawliteral";
-        }
 
-        if (isSegMode) {
-            blocks += R"rawliteral(
+        static const char tplSeg[] = R"rawliteral(
 <div class="slider-block">
   <label for="klokkentimer">Klokken (segment 1 slut):</label>
   <input type="number" id="klokkentimer" name="klokkentimer" min="0" max="23" value="%KLOKKETIMER%" style="width:45px;"> :
@@ -621,52 +875,35 @@ public:
   <div class="hint">Segment 1 kører som før: nataktiv → pwmA indtil dette tidspunkt.</div>
 </div>
 
-<div class="segment-box">
-  <strong>Segment 2 (tillæg)</strong><br>
-  <label for="seg2Enabled">Aktiv:</label>
-  <input type="checkbox" id="seg2Enabled" name="seg2Enabled" value="1" %SEG2ENABLED%><br><br>
-
-  <label>Start (hh:mm):</label>
-  <input type="number" name="seg2StartTimer" min="0" max="23" value="%SEG2STARTH%" style="width:45px;"> :
-  <input type="number" name="seg2StartMinutter" min="0" max="59" value="%SEG2STARTM%" style="width:45px;"><br>
-
-  <label>Slut (hh:mm):</label>
-  <input type="number" name="seg2SlutTimer" min="0" max="23" value="%SEG2ENDH%" style="width:45px;"> :
-  <input type="number" name="seg2SlutMinutter" min="0" max="59" value="%SEG2ENDM%" style="width:45px;"><br>
-
-  <div class="weekdays">
-    <label>Ugedage:</label>
-    %SEG2WEEKDAYS%
-  </div>
+%SEGROWS%
+<input type="hidden" name="segs" id="segs">
+<div class="hint">Tillægssegmenter (op til %SEGMAX%): start/slut som hh:mm, "solnedgang", "solopgang" eller fx "solnedgang+15".
+  Niveau tomt = pwmA. Ved overlap vinder øverste segment. Ryd start/slut for at slette en række.</div>
+)rawliteral";
 
-  <div class="hint">Segment 2 start flyttes automatisk frem hvis den er før segment 1 slut.</div>
-</div>
+        static const char tplSegRow[] = R"rawliteral(
+<div class="segment-box seg-row">
+  <strong>Segment %SEGNO% (tillæg)</strong><br>
+  <label>Aktiv:</label>
+  <input type="checkbox" class="seg-on" value="1" %SEGON%><br><br>
 
-<div class="segment-box">
-  <strong>Segment 3 (tillæg)</strong><br>
-  <label for="seg3Enabled">Aktiv:</label>
-  <input type="checkbox" id="seg3Enabled" name="seg3Enabled" value="1" %SEG3ENABLED%><br><br>
+  <label>Start:</label>
+  <input type="text" class="seg-start" value="%SEGSTART%" pattern="%SEGPATTERN%" placeholder="hh:mm" style="width:130px;"><br>
 
-  <label>Start (hh:mm):</label>
-  <input type="number" name="seg3StartTimer" min="0" max="23" value="%SEG3STARTH%" style="width:45px;"> :
-  <input type="number" name="seg3StartMinutter" min="0" max="59" value="%SEG3STARTM%" style="width:45px;"><br>
+  <label>Slut:</label>
+  <input type="text" class="seg-end" value="%SEGEND%" pattern="%SEGPATTERN%" placeholder="hh:mm" style="width:130px;"><br>
 
-  <label>Slut (hh:mm):</label>
-  <input type="number" name="seg3SlutTimer" min="0" max="23" value="%SEG3ENDH%" style="width:45px;"> :
-  <input type="number" name="seg3SlutMinutter" min="0" max="59" value="%SEG3ENDM%" style="width:45px;"><br>
+  <label>Niveau (%):</label>
+  <input type="number" class="seg-level" min="0" max="100" value="%SEGLEVEL%" placeholder="pwmA" style="width:70px;">
 
   <div class="weekdays">
     <label>Ugedage:</label>
-    %SEG3WEEKDAYS%
+    %SEGDAYS%
   </div>
-
-  <div class="hint">Segment 3 start flyttes automatisk frem hvis den er før segment 2 slut (eller segment 1 slut hvis segment 2 ikke er aktiv).</div>
 </div>
 )rawliteral";
-        }
 
-        if (isAstro) {
-            blocks += R"rawliteral(
+        static const char tplAstro[] = R"rawliteral(
 <div class="segment-box">
   <strong>Astro (solnedgang/solopgang)</strong><br><br>
 
@@ -698,73 +935,16 @@ public:
   <input type="checkbox" id="astroLuxEarlyStart" name="astroLuxEarlyStart" value="1" %ASTROLUXEARLY%><br>
 </div>
 )rawliteral";
-        }
 
-        // Insert blocks
-        html.replace("%MODE_BLOCKS%", blocks);
-
-        // Replace common placeholders
-        html.replace("%PWMA%", String(lysparamWeb.pwmA));
-        html.replace("%PWMC%", String(lysparamWeb.pwmC));
-        html.replace("%PWME%", String(lysparamWeb.pwmE));
-        html.replace("%PWMG%", String(lysparamWeb.pwmG));
-        html.replace("%LUX%", String((int)lysparamWeb.luxstartvaerdi));
-        html.replace("%NATDAG%", String(lysparamWeb.natdagdelay));
-        html.replace("%SOFTSTEP%", String(lysparamWeb.aktuelStepfrekvens));
-
-        // Timer placeholders (only used in Tid blocks)
-        html.replace("%TIMERA%", String(lysparamWeb.timerA));
-        html.replace("%TIMERC%", String(lysparamWeb.timerC));
-        html.replace("%TIMERE%", String(lysparamWeb.timerE));
-
-        // Segment placeholders
-        html.replace("%KLOKKETIMER%", String(lysparamWeb.slutKlokkeTimer));
-        html.replace("%KLOKKEMINUTTER%", String(lysparamWeb.slutKlokkeMinutter));
-
-        html.replace("%SEG2ENABLED%", lysparamWeb.seg2Enabled ? "checked" : "");
-        html.replace("%SEG2STARTH%", String(lysparamWeb.seg2StartTimer));
-        html.replace("%SEG2STARTM%", String(lysparamWeb.seg2StartMinutter));
-        html.replace("%SEG2ENDH%", String(lysparamWeb.seg2SlutTimer));
-        html.replace("%SEG2ENDM%", String(lysparamWeb.seg2SlutMinutter));
-        html.replace("%SEG2WEEKDAYS%", weekMaskToHtml(lysparamWeb.seg2WeekMask, "seg2d"));
-
-        html.replace("%SEG3ENABLED%", lysparamWeb.seg3Enabled ? "checked" : "");
-        html.replace("%SEG3STARTH%", String(lysparamWeb.seg3StartTimer));
-        html.replace("%SEG3STARTM%", String(lysparamWeb.seg3StartMinutter));
-        html.replace("%SEG3ENDH%", String(lysparamWeb.seg3SlutTimer));
-        html.replace("%SEG3ENDM%", String(lysparamWeb.seg3SlutMinutter));
-        html.replace("%SEG3WEEKDAYS%", weekMaskToHtml(lysparamWeb.seg3WeekMask, "seg3d"));
-
-        // Astro placeholders
-        html.replace("%ASTROENABLED%", lysparamWeb.astroEnabled ? "checked" : "");
-        html.replace("%ASTROLAT%", String(lysparamWeb.astroLat, 4));
-        html.replace("%ASTROLON%", String(lysparamWeb.astroLon, 4));
-        html.replace("%ASTROSUNSETOFF%", String(lysparamWeb.astroSunsetOffsetMin));
-        html.replace("%ASTROSUNRISEOFF%", String(lysparamWeb.astroSunriseOffsetMin));
-        html.replace("%ASTROLUXEARLY%", lysparamWeb.astroLuxEarlyStart ? "checked" : "");
-
-        // Mode radio checked uses renderMode
-        html.replace("%MODETID%", isTid ? "checked" : "");
-        html.replace("%MODEKLOKKEN%", isKlokken ? "checked" : "");
-        html.replace("%MODEASTRO%", isAstro ? "checked" : "");
-
-        client.println("HTTP/1.1 200 OK");
-        client.println("Content-Type: text/html; charset=utf-8");
-        client.println("Connection: close");
-        client.println();
-        client.print(html);
+        OpsaetningFill fill{lysparamWeb, isTid, isKlokken, isAstro, tplTid, tplSeg, tplSegRow, tplAstro};
+        sendTemplate(out, tplPage, fill);
     }
 
-    void processOpsaetData(WiFiClient& client, const String& req) {
-        // Extract params from full request (naiv men ok her)
-        int q = req.indexOf('?');
-        if (q < 0) {
-            client.println("HTTP/1.1 400 Bad Request\r\n\r\nMissing query");
+    void processOpsaetData(WebTxBuffer& out, const HttpRequest& req) {
+        if (req.query.empty()) {
+            sendText(out, "400 Bad Request", "Missing query\r\n");
             return;
         }
-        String params = req.substring(q + 1);
-        int sp = params.indexOf(' ');
-        if (sp > 0) params = params.substring(0, sp);
 
         // Start med nuværende værdier
         mutex_enter_blocking(&param_mutex);
@@ -772,145 +952,418 @@ public:
         mutex_exit(&param_mutex);
 
         // Standard
-        extractIntFromParams(params, "pwma", lysparamWeb.pwmA);
-        extractIntFromParams(params, "pwmc", lysparamWeb.pwmC);
-        extractIntFromParams(params, "pwme", lysparamWeb.pwmE);
-        extractIntFromParams(params, "pwmg", lysparamWeb.pwmG);
+        req.queryInt("pwma", lysparamWeb.pwmA);
+        req.queryInt("pwmc", lysparamWeb.pwmC);
+        req.queryInt("pwme", lysparamWeb.pwmE);
+        req.queryInt("pwmg", lysparamWeb.pwmG);
 
         // Backcompat + nyt
-        { int tmp; if (extractIntFromParams(params, "toggle", tmp)) lysparamWeb.luxstartvaerdi = (float)tmp; }
-        { int tmp; if (extractIntFromParams(params, "luxstart", tmp)) lysparamWeb.luxstartvaerdi = (float)tmp; }
+        { int tmp; if (req.queryInt("toggle", tmp)) lysparamWeb.luxstartvaerdi = (float)tmp; }
+        { int tmp; if (req.queryInt("luxstart", tmp)) lysparamWeb.luxstartvaerdi = (float)tmp; }
 
-        { int tmp; if (extractIntFromParams(params, "delay", tmp)) lysparamWeb.natdagdelay = tmp; }
-        { int tmp; if (extractIntFromParams(params, "stepfrekvens", tmp)) lysparamWeb.aktuelStepfrekvens = tmp; }
+        req.queryLong("delay", lysparamWeb.natdagdelay);
+        { int tmp; if (req.queryInt("stepfrekvens", tmp)) lysparamWeb.aktuelStepfrekvens = tmp; }
 
         // Tid-mode timers
-{ int tmp; if (extractIntFromParams(params, "timera", tmp)) lysparamWeb.timerA = (long)tmp; }
-{ int tmp; if (extractIntFromParams(params, "timerc", tmp)) lysparamWeb.timerC = (long)tmp; }
-{ int tmp; if (extractIntFromParams(params, "timere", tmp)) lysparamWeb.timerE = (long)tmp; }
+        req.queryLong("timera", lysparamWeb.timerA);
+        req.queryLong("timerc", lysparamWeb.timerC);
+        req.queryLong("timere", lysparamWeb.timerE);
 
         // Segment baseline
-        extractIntFromParams(params, "klokkentimer", lysparamWeb.slutKlokkeTimer);
-        extractIntFromParams(params, "klokkenminutter", lysparamWeb.slutKlokkeMinutter);
-
-        // Segment 2
-        lysparamWeb.seg2Enabled = hasQueryKeyEq(params, "seg2Enabled", "1");
-        extractIntFromParams(params, "seg2StartTimer", lysparamWeb.seg2StartTimer);
-        extractIntFromParams(params, "seg2StartMinutter", lysparamWeb.seg2StartMinutter);
-        extractIntFromParams(params, "seg2SlutTimer", lysparamWeb.seg2SlutTimer);
-        extractIntFromParams(params, "seg2SlutMinutter", lysparamWeb.seg2SlutMinutter);
-        lysparamWeb.seg2WeekMask = parseWeekMaskFromQuery(params, "seg2d");
-
-        // Segment 3
-        lysparamWeb.seg3Enabled = hasQueryKeyEq(params, "seg3Enabled", "1");
-        extractIntFromParams(params, "seg3StartTimer", lysparamWeb.seg3StartTimer);
-        extractIntFromParams(params, "seg3StartMinutter", lysparamWeb.seg3StartMinutter);
-        extractIntFromParams(params, "seg3SlutTimer", lysparamWeb.seg3SlutTimer);
-        extractIntFromParams(params, "seg3SlutMinutter", lysparamWeb.seg3SlutMinutter);
-        lysparamWeb.seg3WeekMask = parseWeekMaskFromQuery(params, "seg3d");
+        req.queryInt("klokkentimer", lysparamWeb.slutKlokkeTimer);
+        req.queryInt("klokkenminutter", lysparamWeb.slutKlokkeMinutter);
+
+        // Tillægssegmenter (kun når formularen har segment-blokken)
+        if (req.hasQuery("segs")) {
+            char segs[LYS_MAX_SEGMENTS * 40];
+            req.queryParam("segs", segs, sizeof(segs));
+            parseSegsQuery(segs, lysparamWeb);
+        }
 
         // Astro
-        lysparamWeb.astroEnabled = hasQueryKeyEq(params, "astroEnabled", "1");
-        lysparamWeb.astroLuxEarlyStart = hasQueryKeyEq(params, "astroLuxEarlyStart", "1");
-        extractFloatFromParams(params, "astroLat", lysparamWeb.astroLat);
-        extractFloatFromParams(params, "astroLon", lysparamWeb.astroLon);
-        extractIntFromParams(params, "astroSunsetOffsetMin", lysparamWeb.astroSunsetOffsetMin);
-        extractIntFromParams(params, "astroSunriseOffsetMin", lysparamWeb.astroSunriseOffsetMin);
+        lysparamWeb.astroEnabled = req.queryEq("astroEnabled", "1");
+        lysparamWeb.astroLuxEarlyStart = req.queryEq("astroLuxEarlyStart", "1");
+        req.queryFloat("astroLat", lysparamWeb.astroLat);
+        req.queryFloat("astroLon", lysparamWeb.astroLon);
+        req.queryInt("astroSunsetOffsetMin", lysparamWeb.astroSunsetOffsetMin);
+        req.queryInt("astroSunriseOffsetMin", lysparamWeb.astroSunriseOffsetMin);
 
         // Mode
-        String mode = "";
-        {
-            int p = params.indexOf("modeselect=");
-            if (p >= 0) {
-                int start = p + (int)strlen("modeselect=");
-                int end = params.indexOf('&', start);
-                if (end < 0) end = params.length();
-                mode = params.substring(start, end);
-                mode.trim();
-            }
-        }
-        if (mode == "Tid" || mode == "Klokken" || mode == "Astro") {
-            lysparamWeb.styringsvalg = mode;
-          if (lysparamWeb.styringsvalg == "Astro") {
-              lysparamWeb.astroEnabled = true;
-          }
-        }
-
-        // Kædevalidering (harmløs i Tid-mode)
-        int seg1End = toMin(lysparamWeb.slutKlokkeTimer, lysparamWeb.slutKlokkeMinutter);
-        if (lysparamWeb.seg2Enabled) {
-            clampStartNotBefore(lysparamWeb.seg2StartTimer, lysparamWeb.seg2StartMinutter, seg1End);
-        }
-        int seg2End = toMin(lysparamWeb.seg2SlutTimer, lysparamWeb.seg2SlutMinutter);
-        int minStart3 = lysparamWeb.seg2Enabled ? seg2End : seg1End;
-        if (lysparamWeb.seg3Enabled) {
-            clampStartNotBefore(lysparamWeb.seg3StartTimer, lysparamWeb.seg3StartMinutter, minStart3);
+        char mode[12];
+        req.queryParam("modeselect", mode, sizeof(mode));
+        if (parseLysMode(mode, lysparamWeb.styringsvalg) && lysparamWeb.styringsvalg == MODE_ASTRO) {
+            lysparamWeb.astroEnabled = true;
         }
 
         // Commit + save
         mutex_enter_blocking(&param_mutex);
         lysparam = lysparamWeb;
+        lysparamRev++;
         mutex_exit(&param_mutex);
 
         if (mitjason) mitjason->saveDefault(sd, &lysparamWeb);
 
-        client.println("HTTP/1.1 303 See Other");
-        client.println("Location: /opsaetning.htm");
-        client.println();
+        sendRedirect(out, "/opsaetning.htm");
     }
 
     // ------------------ JSON status ------------------
-    void sendStatusJSON(WiFiClient& client) {
-        JsonDocument doc;
+    void sendStatusJSON(WebTxBuffer& out) {
+        const StatusSnapshot& st = readSnapshot();
+
+        // Konfiguration: kort kopi under param_mutex, formatering bagefter
+        int softstep;
+        uint8_t seg2mask, seg3mask, segCount;
+        bool astroEnabled;
+        float astroLat, astroLon;
+        LysMode mode;
+        mutex_enter_blocking(&param_mutex);
+        softstep     = lysparam.aktuelStepfrekvens;
+        segCount     = lysparam.segCount;
+        seg2mask     = segCount > 0 ? lysparam.segs[0].weekMask : 0;
+        seg3mask     = segCount > 1 ? lysparam.segs[1].weekMask : 0;
+        astroEnabled = lysparam.astroEnabled;
+        astroLat     = lysparam.astroLat;
+        astroLon     = lysparam.astroLon;
+        mode         = lysparam.styringsvalg;
+        mutex_exit(&param_mutex);
 
-        mutex_enter_blocking(&lys_mutex);
-        doc["lys procent"] = aktuellysvaerdi;
-        doc["maalt lux"]   = aktuellux;
-        doc["temp"]        = aktueltemp;
-        doc["Hpa"]         = aktuelpress;
-        doc["Cputemp"]     = internaltemp;
-        doc["lys_on"]      = lys_permanet_on;
-        mutex_exit(&lys_mutex);
+        char p1[20], p2[20], hw[20], tnow[20];
+        EpochClock::formatLocal(st.pir1Epoch, p1, sizeof(p1));
+        EpochClock::formatLocal(st.pir2Epoch, p2, sizeof(p2));
+        EpochClock::formatLocal(st.hwswEpoch, hw, sizeof(hw));
+        EpochClock::formatLocal(epochClock.now(), tnow, sizeof(tnow));   // Ur-visning i browser
+
+        char body[768];
+        int n = snprintf(body, sizeof(body),
+            "{\"lys procent\":%d,\"maalt lux\":%.2f,\"temp\":%.2f,\"Hpa\":%.2f,\"Cputemp\":%.2f,"
+            "\"lys_on\":%s,\"nat\":%s,\"state\":\"%s\","
+            "\"Sidste pir 1 aktivering\":\"%s\",\"Sidste pir 2 aktivering\":\"%s\",\"Sidste Kontakt aktivering\":\"%s\","
+            "\"softstep\":%d,\"mode\":\"%s\",\"seg2mask\":%u,\"seg3mask\":%u,\"segments\":%u,"
+            "\"astroEnabled\":%s,\"astroLat\":%.4f,\"astroLon\":%.4f,\"time\":\"%s\","
+            "\"txResponses\":%lu,\"txBytes\":%lu,\"txSegments\":%lu,"
+            "\"eventDrops\":%lu,\"eventHighWater\":%lu,\"logLines\":%lu,\"logSyncs\":%lu}\r\n",
+            st.lysprocent, st.lux, st.temp, st.pressure, st.cpuTemp,
+            st.forcedOn ? "true" : "false", st.nat ? "true" : "false", autoStateName(st.autoState),
+            p1, p2, hw,
+            softstep, lysModeName(mode), (unsigned)seg2mask, (unsigned)seg3mask, (unsigned)segCount,
+            astroEnabled ? "true" : "false", astroLat, astroLon, tnow,
+            (unsigned long)out.stats.responses, (unsigned long)out.stats.bytes,
+            (unsigned long)out.stats.segments,
+            (unsigned long)eventRing.dropped(), (unsigned long)eventRing.highWater(),
+            (unsigned long)(lyslog ? lyslog->lineCount() : 0), (unsigned long)(lyslog ? lyslog->syncCount() : 0));
+        if (n >= (int)sizeof(body)) n = sizeof(body) - 1;
+
+        beginResponse(out, "200 OK", "application/json", n);
+        out.write((const uint8_t*)body, n);
+    }
 
-        mutex_enter_blocking(&pir_mutex);
-        doc["Sidste pir 1 aktivering"]   = pir1_tid ? *pir1_tid : "";
-        doc["Sidste pir 2 aktivering"]   = pir2_tid ? *pir2_tid : "";
-        doc["Sidste Kontakt aktivering"] = hwsw_tid ? *hwsw_tid : "";
-        mutex_exit(&pir_mutex);
+    // ------------------ Sektionstider (/debug/timing) ------------------
+#if LYS_TIMING
+    static void writeTimingJson(Print& out, const TimingTable& t) {
+        char line[200];
+        int n = snprintf(line, sizeof(line), "{\"windowMs\":%lu,\"sections\":[",
+                         (unsigned long)(millis() - t.sinceMs));
+        out.write((const uint8_t*)line, n);
+        for (uint8_t i = 0; i < TIMING_COUNT; i++) {
+            const TimingStats& s = t.s[i];
+            n = snprintf(line, sizeof(line),
+                         "%s{\"name\":\"%s\",\"count\":%lu,\"minUs\":%lu,\"avgUs\":%lu,"
+                         "\"p99Us\":%lu,\"maxUs\":%lu,\"buckets\":[",
+                         i ? "," : "", timingSectionName(i), (unsigned long)s.count,
+                         (unsigned long)s.minUs, (unsigned long)(s.count ? s.sumUs / s.count : 0),
+                         (unsigned long)s.percentileUs(990), (unsigned long)s.maxUs);
+            out.write((const uint8_t*)line, n);
+            for (uint8_t b = 0; b < TIMING_BUCKETS; b++) {
+                n = snprintf(line, sizeof(line), "%s%lu", b ? "," : "", (unsigned long)s.buckets[b]);
+                out.write((const uint8_t*)line, n);
+            }
+            out.print("]}");
+        }
+        out.print("]}\r\n");
+    }
+#endif
+
+    /**
+     * @brief /debug/timing[?reset=1] – min/avg/p99/max og histogram (bucket b = [2^(b-1), 2^b) µs)
+     *        for hver målt sektion af loop1() siden sidste nulstilling.
+     */
+    void sendTiming(WebTxBuffer& out, const HttpRequest& req) {
+#if LYS_TIMING
+        if (req.queryEq("reset", "1")) loopTiming.requestReset();
+        TimingTable t;
+        if (!loopTiming.read(t)) {
+            sendText(out, "503 Service Unavailable", "Ingen målinger endnu\r\n");
+            return;
+        }
+        WebCountingPrint counter;
+        writeTimingJson(counter, t);
+        beginResponse(out, "200 OK", "application/json", (long)counter.count, "Cache-Control: no-cache\r\n");
+        writeTimingJson(out, t);
+#else
+        (void)req;
+        sendText(out, "404 Not Found", "Timing er slået fra (LYS_TIMING=0)\r\n");
+#endif
+    }
+
+    // ------------------ Dagsplan (/api/schedule) ------------------
+    static void writeScheduleSide(Print& out, const char* name, const LysParam& p, bool wantA, int level, int endSec) {
+        char line[96];
+        int n = snprintf(line, sizeof(line), ",\"%s\":{\"state\":\"%s\",\"pwm\":%d,\"end\":\"%02d:%02d:%02d\"}",
+                         name, wantA ? "A" : "G", wantA ? level : p.pwmG,
+                         endSec / 3600, (endSec / 60) % 60, endSec % 60);
+        out.write((const uint8_t*)line, n);
+    }
+
+    /** Oversæt og skriv days dage fra i dag – samme DaySchedule som LysAutomatik bruger. */
+    static void writeScheduleJson(Print& out, const LysParam& p, time_t now, int days) {
+        char line[160];
+        int n = snprintf(line, sizeof(line), "{\"mode\":\"%s\",\"days\":[", lysModeName(p.styringsvalg));
+        out.write((const uint8_t*)line, n);
+
+        tm base;
+        localtime_r(&now, &base);
+        DaySchedule ds;
+        for (int d = 0; d < days; d++) {
+            tm x = base;                    // Middag undgår DST-skiftet om natten
+            x.tm_mday += d;
+            x.tm_hour = 12;
+            x.tm_min = 0;
+            x.tm_sec = 0;
+            x.tm_isdst = -1;
+            if (!ds.refresh(p, mktime(&x), true)) break;
+
+            char rise[8] = "null", set[8] = "null";
+            if (ds.astroValid()) {
+                snprintf(rise, sizeof(rise), "\"%02d:%02d\"", ds.sunriseMin() / 60, ds.sunriseMin() % 60);
+                snprintf(set, sizeof(set), "\"%02d:%02d\"", ds.sunsetMin() / 60, ds.sunsetMin() % 60);
+            }
+            n = snprintf(line, sizeof(line),
+                         "%s{\"date\":\"%04d-%02d-%02d\",\"wday\":%d,\"sunrise\":%s,\"sunset\":%s,\"entries\":[",
+                         d ? "," : "", ds.year(), ds.month(), ds.day(), ds.wday(), rise, set);
+            out.write((const uint8_t*)line, n);
+
+            for (uint8_t i = 0; i < ds.size(); i++) {
+                const ScheduleEntry& e = ds.entry(i);
+                n = snprintf(line, sizeof(line), "%s{\"start\":\"%02d:%02d:%02d\",\"astroNight\":%s",
+                             i ? "," : "", (int)(e.startSec / 3600), (int)((e.startSec / 60) % 60),
+                             (int)(e.startSec % 60), e.astroNight ? "true" : "false");
+                out.write((const uint8_t*)line, n);
+                writeScheduleSide(out, "klokken", p, e.klokA, e.klokLevel, e.klokEndSec);
+                writeScheduleSide(out, "astro", p, e.astroA, e.astroLevel, e.astroEndSec);
+                out.print("}");
+            }
+            out.print("]}");
+        }
+        out.print("]}\r\n");
+    }
+
+    /**
+     * @brief /api/schedule[?days=7] – den oversatte dagsplan for i dag og de næste dage (1–14).
+     *
+     * Hver entry gælder fra start til næste entry. "klokken" er tilstanden i Klokken-mode
+     * (og i Astro-dag når lux har gjort det nat), "astro" tilstanden i Astro-mode; A = grundlys
+     * til end (pwm = pwmA eller det vindende segments niveau), G = natglød (pwmG). Tid-mode bruger ikke planen.
+     */
+    void sendSchedule(WebTxBuffer& out, const HttpRequest& req) {
+        int days = 7;
+        req.queryInt("days", days);
+        days = constrain(days, 1, 14);
+
+        time_t now = (time_t)epochClock.now();
+        if (now < 1700000000) {
+            sendText(out, "503 Service Unavailable", "Ingen tid endnu\r\n");
+            return;
+        }
 
         mutex_enter_blocking(&param_mutex);
-        doc["softstep"] = lysparam.aktuelStepfrekvens;
-        doc["mode"]     = lysparam.styringsvalg;
-        doc["seg2mask"] = lysparam.seg2WeekMask;
-        doc["seg3mask"] = lysparam.seg3WeekMask;
-        doc["astroEnabled"] = lysparam.astroEnabled;
-        doc["astroLat"] = lysparam.astroLat;
-        doc["astroLon"] = lysparam.astroLon;
+        lysparamWeb = lysparam;
         mutex_exit(&param_mutex);
 
-        // RTC tid til ur-visning i browser
-        datetime_t t;
-        rtc_get_datetime(&t);
-        char timebuf[20];
-        snprintf(timebuf, sizeof(timebuf), "%04d-%02d-%02d %02d:%02d:%02d",
-                 t.year, t.month, t.day, t.hour, t.min, t.sec);
-        doc["time"] = timebuf;
-
-        String vis;
-        serializeJsonPretty(doc, vis);
-        client.println("HTTP/1.1 200 OK");
-        client.println("Content-type: application/json");
-        client.println();
-        client.println(vis);
+        WebCountingPrint counter;
+        writeScheduleJson(counter, lysparamWeb, now, days);
+        beginResponse(out, "200 OK", "application/json", (long)counter.count, "Cache-Control: no-cache\r\n");
+        writeScheduleJson(out, lysparamWeb, now, days);
+    }
+
+    // ------------------ Prometheus (/metrics) ------------------
+    static void metric(Print& out, const char* name, const char* type, const char* help) {
+        char line[160];
+        int n = snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+        if (n >= (int)sizeof(line)) n = sizeof(line) - 1;
+        out.write((const uint8_t*)line, n);
+    }
+
+    static void sample(Print& out, const char* name, const char* labels, double v) {
+        char line[160];
+        int n = snprintf(line, sizeof(line), "%s%s %.10g\n", name, labels, v);
+        if (n >= (int)sizeof(line)) n = sizeof(line) - 1;
+        out.write((const uint8_t*)line, n);
+    }
+
+    void writeMetrics(Print& out, const MetricsValues& m) {
+        metric(out, "lys_uptime_seconds", "counter", "Sekunder siden boot");
+        sample(out, "lys_uptime_seconds", "", m.uptimeMs / 1000.0);
+
+        metric(out, "lys_i2c_resets_total", "counter", "I2C bus-resets efter læsefejl");
+        sample(out, "lys_i2c_resets_total", "{bus=\"wire\"}", m.st.i2cWireResets);
+        sample(out, "lys_i2c_resets_total", "{bus=\"wire1\"}", m.st.i2cWire1Resets);
+        metric(out, "lys_param_skips_total", "counter", "Automatik-ticks sprunget over fordi param_mutex var optaget");
+        sample(out, "lys_param_skips_total", "", m.st.paramSkips);
+        metric(out, "lys_wifi_reconnects_total", "counter", "WiFi-reconnects");
+        sample(out, "lys_wifi_reconnects_total", "", m.wifiReconnects);
+        metric(out, "lys_event_drops_total", "counter", "Events tabt fordi EventRing var fuld");
+        sample(out, "lys_event_drops_total", "", m.eventDrops);
+        metric(out, "lys_event_ring_high_water", "gauge", "Højeste fyldning af EventRing");
+        sample(out, "lys_event_ring_high_water", "", m.eventHighWater);
+
+        metric(out, "lys_http_responses_total", "counter", "HTTP-svar sendt");
+        sample(out, "lys_http_responses_total", "", m.txResponses);
+        metric(out, "lys_http_tx_bytes_total", "counter", "Bytes sendt til HTTP-klienter");
+        sample(out, "lys_http_tx_bytes_total", "", m.txBytes);
+
+        metric(out, "lys_log_lines_total", "counter", "Log-linjer/records skrevet");
+        sample(out, "lys_log_lines_total", "", m.logLines);
+        metric(out, "lys_log_syncs_total", "counter", "SD-sync af logfiler (group commits)");
+        sample(out, "lys_log_syncs_total", "", m.logSyncs);
+        metric(out, "lys_sd_write_errors_total", "counter", "Fejlede SD-writes/syncs i LysLog");
+        sample(out, "lys_sd_write_errors_total", "", m.sdErrors);
+
+        metric(out, "lys_light_percent", "gauge", "Aktuel lysprocent");
+        sample(out, "lys_light_percent", "", m.st.lysprocent);
+        metric(out, "lys_lux", "gauge", "Målt lux (VEML7700)");
+        sample(out, "lys_lux", "", m.st.lux);
+        metric(out, "lys_temperature_celsius", "gauge", "Temperatur");
+        sample(out, "lys_temperature_celsius", "{sensor=\"bmp280\"}", m.st.temp);
+        sample(out, "lys_temperature_celsius", "{sensor=\"cpu\"}", m.st.cpuTemp);
+        metric(out, "lys_pressure_hpa", "gauge", "Lufttryk (BMP280)");
+        sample(out, "lys_pressure_hpa", "", m.st.pressure);
+        metric(out, "lys_night", "gauge", "1 når nataktiv");
+        sample(out, "lys_night", "", m.st.nat ? 1 : 0);
+
+        // Pr. route (kun routes der har haft requests)
+        char labels[80];
+        metric(out, "lys_http_requests_total", "counter", "Requests pr. route");
+        for (uint8_t r = 0; r < ROUTE_COUNT; r++) {
+            if (!routeStats[r].count) continue;
+            snprintf(labels, sizeof(labels), "{route=\"%s\"}", routePath((WebRoute)r));
+            sample(out, "lys_http_requests_total", labels, routeStats[r].count);
+        }
+        metric(out, "lys_http_request_duration_seconds", "histogram", "Tid i handleren pr. route");
+        for (uint8_t r = 0; r < ROUTE_COUNT; r++) {
+            const RouteStats& s = routeStats[r];
+            if (!s.count) continue;
+            const char* path = routePath((WebRoute)r);
+            uint32_t cum = 0;
+            for (uint8_t b = 0; b < METRICS_BUCKETS; b++) {
+                cum += s.buckets[b];
+                if (b < METRICS_BUCKETS - 1) {
+                    snprintf(labels, sizeof(labels), "{route=\"%s\",le=\"%g\"}", path, metricsBucketUs(b) / 1e6);
+                } else {
+                    snprintf(labels, sizeof(labels), "{route=\"%s\",le=\"+Inf\"}", path);
+                }
+                sample(out, "lys_http_request_duration_seconds_bucket", labels, cum);
+            }
+            snprintf(labels, sizeof(labels), "{route=\"%s\"}", path);
+            sample(out, "lys_http_request_duration_seconds_sum", labels, s.sumUs / 1e6);
+            sample(out, "lys_http_request_duration_seconds_count", labels, s.count);
+        }
+    }
+
+    /**
+     * @brief /metrics i Prometheus tekstformat. Værdierne fastfryses først, så tællepass
+     *        (Content-Length) og afsendelse giver præcis samme tekst.
+     */
+    void sendMetrics(WebTxBuffer& out) {
+        MetricsValues m;
+        m.st             = readSnapshot();
+        m.uptimeMs       = time_us_64() / 1000;
+        m.wifiReconnects = wifiReconnects;
+        m.eventDrops     = eventRing.dropped();
+        m.eventHighWater = eventRing.highWater();
+        m.txResponses    = out.stats.responses;
+        m.txBytes        = out.stats.bytes;
+        m.logLines       = lyslog ? lyslog->lineCount() : 0;
+        m.logSyncs       = lyslog ? lyslog->syncCount() : 0;
+        m.sdErrors       = lyslog ? lyslog->errorCount() : 0;
+
+        WebCountingPrint counter;
+        writeMetrics(counter, m);
+        beginResponse(out, "200 OK", "text/plain; version=0.0.4", (long)counter.count, "Cache-Control: no-cache\r\n");
+        writeMetrics(out, m);
+    }
+
+    // ------------------ Server-Sent Events (/events) ------------------
+    /**
+     * @brief Byg næste status-event til SSE-klienter.
+     *
+     * Lysprocent, lux (0.1), nataktiv, lås og PIR-tidsstempler sendes straks
+     * når de ændrer sig. Temp/tryk/CPU-temp tages kun med hvis de er ændret og
+     * enten en af de første felter også er det, eller der er gået SSE_ENV_MS.
+     * Tid sendes hvert SSE_TIME_MS (fungerer også som heartbeat).
+     *
+     * @param full true → alle felter (ny klient), ellers kun ændringer. Kun !full opdaterer
+     *             sseLast og broadcast-timerne, så en ny klient ikke forsinker de øvrige.
+     * @return Antal bytes i buf ("data: {...}\n\n"), 0 hvis intet nyt.
+     */
+    size_t buildStatusEvent(char* buf, size_t size, bool full) {
+        SseStatus now;
+        readSseStatus(now);
+
+        uint32_t ms = millis();
+        bool sendTime = full || (ms - sseLastTimeMs >= SSE_TIME_MS);
+        bool envDue = full || (ms - sseLastEnvMs >= SSE_ENV_MS);
+
+        int n = snprintf(buf, size, "data: {");
+        bool any = false;
+        auto sep = [&]() { if (any) n += snprintf(buf + n, size - n, ","); any = true; };
+
+        bool trig = full || !sseValid;
+        if (trig || now.lys != sseLast.lys)   { sep(); n += snprintf(buf + n, size - n, "\"lys\":%d", now.lys); }
+        if (trig || now.lux != sseLast.lux)   { sep(); n += snprintf(buf + n, size - n, "\"lux\":%.1f", now.lux / 10.0f); }
+        if (trig || now.nat != sseLast.nat)   { sep(); n += snprintf(buf + n, size - n, "\"nat\":%d", now.nat ? 1 : 0); }
+        if (trig || now.perm != sseLast.perm) { sep(); n += snprintf(buf + n, size - n, "\"perm\":%d", now.perm ? 1 : 0); }
+        char ts[20];
+        if (trig || now.pir1 != sseLast.pir1) { sep(); EpochClock::formatLocal(now.pir1, ts, sizeof(ts)); n += snprintf(buf + n, size - n, "\"pir1\":\"%s\"", ts); }
+        if (trig || now.pir2 != sseLast.pir2) { sep(); EpochClock::formatLocal(now.pir2, ts, sizeof(ts)); n += snprintf(buf + n, size - n, "\"pir2\":\"%s\"", ts); }
+        if (trig || now.hwsw != sseLast.hwsw) { sep(); EpochClock::formatLocal(now.hwsw, ts, sizeof(ts)); n += snprintf(buf + n, size - n, "\"hwsw\":\"%s\"", ts); }
+
+        if (any || envDue) {
+            bool envSent = false;
+            if (trig || now.temp != sseLast.temp) { sep(); envSent = true; n += snprintf(buf + n, size - n, "\"temp\":%.1f", now.temp / 10.0f); }
+            if (trig || now.hpa != sseLast.hpa)   { sep(); envSent = true; n += snprintf(buf + n, size - n, "\"hpa\":%.1f", now.hpa / 10.0f); }
+            if (trig || now.cpu != sseLast.cpu)   { sep(); envSent = true; n += snprintf(buf + n, size - n, "\"cpu\":%.1f", now.cpu / 10.0f); }
+            if (!full && (envSent || envDue)) sseLastEnvMs = ms;
+        } else {
+            // Behold sidst sendte miljøværdier så ændringen opdages ved næste udsendelse
+            now.temp = sseLast.temp;
+            now.hpa = sseLast.hpa;
+            now.cpu = sseLast.cpu;
+        }
+
+        if (sendTime) {
+            EpochClock::formatLocal(epochClock.now(), ts, sizeof(ts));
+            sep();
+            n += snprintf(buf + n, size - n, "\"time\":\"%s\"", ts);
+            if (!full) sseLastTimeMs = ms;
+        }
+
+        if (!any || n <= 0 || (size_t)n + 4 >= size) return 0;
+        n += snprintf(buf + n, size - n, "}\n\n");
+
+        if (!full) {
+            sseLast = now;
+            sseValid = true;
+        }
+        return (size_t)n;
     }
 
     // ------------------ Log config ------------------
-    void sendLogConfig(WiFiClient& client) {
+    void sendLogConfig(WebTxBuffer& out) {
         mutex_enter_blocking(&param_mutex);
         lysparamWeb = lysparam;
         mutex_exit(&param_mutex);
 
-        String html = R"rawliteral(
+        static const char tplPage[] = R"rawliteral(
 <!DOCTYPE html>
 <html lang="da">
 <head>
@@ -943,6 +1396,17 @@ public:
                 <option value="0" %LOGPIRDETECTION_OFF%>Deaktiveret</option>
             </select>
         </div>
+        <div class="row">
+            <label for="logbinary">Log-format:</label>
+            <select id="logbinary" name="logbinary">
+                <option value="0" %LOGBINARY_OFF%>Tekst (.log)</option>
+                <option value="1" %LOGBINARY_ON%>Binær (/events.bin)</option>
+            </select>
+        </div>
+        <div class="row">
+            <label for="logmaxmb">Max logstørrelse (MB):</label>
+            <input type="number" id="logmaxmb" name="logmaxmb" min="1" max="4096" value="%LOGMAXMB%">
+        </div>
         <button type="submit" style="font-size:15px;">Gem</button>
         <button style="font-size:15px;" onclick="index()" type="button">Kontrol panel</button>
     </form>
@@ -953,427 +1417,519 @@ public:
 </html>
 )rawliteral";
 
-        html.replace("%LOGNATAKTIV_ON%",  lysparamWeb.lognataktiv ? "selected" : "");
-        html.replace("%LOGNATAKTIV_OFF%", !lysparamWeb.lognataktiv ? "selected" : "");
-        html.replace("%LOGPIRDETECTION_ON%",  lysparamWeb.logpirdetection ? "selected" : "");
-        html.replace("%LOGPIRDETECTION_OFF%", !lysparamWeb.logpirdetection ? "selected" : "");
-
-        client.println("HTTP/1.1 200 OK");
-        client.println("Content-Type: text/html; charset=utf-8");
-        client.println("Connection: close");
-        client.println();
-        client.print(html);
+        const LysParam& p = lysparamWeb;
+        auto fill = [&p](Print& out, const HttpSlice& name) {
+            if (name.eq("LOGMAXMB")) {
+                out.print(p.logmaxmb);
+                return;
+            }
+            bool sel = false;
+            if      (name.eq("LOGNATAKTIV_ON"))      sel = p.lognataktiv;
+            else if (name.eq("LOGNATAKTIV_OFF"))     sel = !p.lognataktiv;
+            else if (name.eq("LOGPIRDETECTION_ON"))  sel = p.logpirdetection;
+            else if (name.eq("LOGPIRDETECTION_OFF")) sel = !p.logpirdetection;
+            else if (name.eq("LOGBINARY_ON"))        sel = p.logbinary;
+            else if (name.eq("LOGBINARY_OFF"))       sel = !p.logbinary;
+            if (sel) out.print("selected");
+        };
+        sendTemplate(out, tplPage, fill);
     }
 
-    void handleGemLogConfig(WiFiClient& client, const String& req) {
-        int idx1 = req.indexOf("lognataktiv=");
-        int idx2 = req.indexOf("logpirdetection=");
-
-        bool lognataktiv = false;
-        bool logpirdetection = false;
-
-        if (idx1 >= 0) {
-            char val = req.charAt(idx1 + (int)strlen("lognataktiv="));
-            lognataktiv = (val == '1');
-        }
-        if (idx2 >= 0) {
-            char val = req.charAt(idx2 + (int)strlen("logpirdetection="));
-            logpirdetection = (val == '1');
-        }
+    void handleGemLogConfig(WebTxBuffer& out, const HttpRequest& req) {
+        bool lognataktiv = req.queryEq("lognataktiv", "1");
+        bool logpirdetection = req.queryEq("logpirdetection", "1");
+        bool logbinary = req.queryEq("logbinary", "1");
+        int logmaxmb = lysparamWeb.logmaxmb;
+        req.queryInt("logmaxmb", logmaxmb);
+        logmaxmb = constrain(logmaxmb, 1, 4096);
 
         mutex_enter_blocking(&param_mutex);
         lysparam.lognataktiv = lognataktiv;
         lysparam.logpirdetection = logpirdetection;
+        lysparam.logbinary = logbinary;
+        lysparam.logmaxmb = logmaxmb;
         lysparamWeb = lysparam;
         mutex_exit(&param_mutex);
 
         if (lyslog) {
             lyslog->setLogNatAktiv(lognataktiv);
             lyslog->setLogPIRAktiv(logpirdetection);
+            lyslog->setBinary(logbinary);
+            lyslog->setMaxMB((uint16_t)logmaxmb);
         }
 
         if (mitjason) mitjason->saveDefault(sd, &lysparamWeb);
 
-        client.println("HTTP/1.1 303 See Other");
-        client.println("Location: /index.htm");
-        client.println();
+        sendRedirect(out, "/index.htm");
     }
 
     // ------------------ File browser ------------------
-    void sendFileBrowserPage(WiFiClient& client) {
-        String page = R"rawliteral(
-<!DOCTYPE html>
-<html lang="da">
-<head>
-  <meta charset="utf-8">
-  <title>File Browser</title>
-  <style>
-    body { font-family: sans-serif; background: #f0f0f0; }
-    #filelist { width: 90%; margin: 30px auto; background: #fff; border: 1px solid #ccc; }
-    th, td { padding: 8px; }
-    th { background: #e0e0e0; }
-    tr:hover { background: #f9f9f9; }
-    .dir { color: #0070c0; cursor: pointer; }
-    .file { color: #333; }
-    #uploadForm { margin: 10px auto; text-align: center; }
-    #path { font-weight: bold; }
-    button { margin: 0 2px; }
-  </style>
-</head>
-<body>
-  <h2>Filbrowser</h2>
-  <div id="uploadForm">
-    <span id="path">/</span>
-    <input type="file" id="fileInput" multiple="multiple">
-    <button onclick="uploadFile()">Upload</button>
-  </div>
-  <table id="filelist">
-    <thead>
-      <tr><th>Navn</th><th>Størrelse</th><th>Type</th><th>Handling</th></tr>
-    </thead>
-    <tbody id="tbody"></tbody>
-  </table>
-  <div style="text-align:center;">
-    <button style="font-size:15px;" onclick="index()">Kontrol panel</button>
-  </div>
-<script>
-let currentPath = "/";
-
-function index() { location.replace('/index.htm');}
-function loadDir(path) {
-  fetch("/dirlist?path=" + encodeURIComponent(path))
-    .then(resp => resp.json())
-    .then(data => {
-      currentPath = data.path;
-      document.getElementById("path").textContent = currentPath;
-      let tbody = document.getElementById("tbody");
-      tbody.innerHTML = "";
-      if (currentPath !== "/") {
-        let up = currentPath.replace(/\\/g, '/').replace(/\/+$/, '').split('/');
-        up.pop();
-        let upPath = up.length > 1 ? up.join('/') : "/";
-        tbody.innerHTML += `<tr>
-          <td class="dir" onclick="loadDir('${upPath}')">.. (op)</td>
-          <td></td><td></td><td></td>
-        </tr>`;
-      }
-      data.entries.forEach(e => {
-        let icon = e.isDir ? "📁" : "📄";
-        let action = e.isDir ?
-          `<button onclick="loadDir('${e.path}')">Åbn</button>` :
-          `<a href="/download?path=${encodeURIComponent(e.path)}" target="_blank">Download</a>
-           <button onclick="deleteFile('${e.path}')">Slet</button>`;
-        tbody.innerHTML += `
-          <tr>
-            <td class="${e.isDir ? "dir" : "file"}" onclick="${e.isDir ? `loadDir('${e.path}')` : ""}">${icon} ${e.name}</td>
-            <td>${e.isDir ? "" : e.size}</td>
-            <td>${e.isDir ? "Mappe" : "Fil"}</td>
-            <td>${action}</td>
-          </tr>
-        `;
-      });
-    });
-}
-function deleteFile(path) {
-  if (!confirm("Slet filen?")) return;
-  fetch("/delete?path=" + encodeURIComponent(path))
-    .then(() => loadDir(currentPath));
-}
-function uploadFile() {
-  let input = document.getElementById("fileInput");
-  if (!input.files.length) return alert("Vælg fil");
-  let form = new FormData();
-  for (let i = 0; i < input.files.length; i++) {
-    form.append("file", input.files[i]);
-  }
-  form.append("path", currentPath);
-  fetch("/upload", {method: "POST", body: form})
-    .then(() => { input.value = ""; loadDir(currentPath); });
-}
-window.onload = () => loadDir("/");
-</script>
-</body>
-</html>
-)rawliteral";
-
-        client.println("HTTP/1.1 200 OK");
-        client.println("Content-Type: text/html");
-        client.println();
-        client.print(page);
-    }
-
-    void handleDirList(WiFiClient& client, const String& req) {
-        String requestLine = getRequestLine(req);
-        String path = extractPathFromRequestLine(requestLine);
-
-        FsFile dir = sd.open(path.c_str());
+    /**
+     * @brief /dirlist?path=/x[&offset=0&limit=100][&sort=mtime|size][&order=asc|desc]
+     *
+     * Entries streames direkte fra SD uden at samle listen i RAM, så
+     * hukommelsesforbruget er konstant uanset antal filer. Sortering sker med en
+     * begrænset heap (DIRLIST_SORT_MAX) – default nyeste/største først. Offset ud over
+     * heapen nås med keyset-gennemløb: hvert gennemløb springer op til DIRLIST_SORT_MAX
+     * entries over ved kun at tage nøgler efter forrige gennemløbs sidste (key, index).
+     * Mappen gennemløbes 1 + offset/DIRLIST_SORT_MAX gange for at finde siden, og
+     * derefter én gang til Content-Length og én gang til afsendelse.
+     */
+    void handleDirList(WebTxBuffer& out, const HttpRequest& req) {
+        char path[128];
+        extractPath(req, path, sizeof(path));
+
+        FsFile dir = sd.open(path);
         if (!dir || !dir.isDir()) {
-            client.println("HTTP/1.1 400 Bad Request");
-            client.println("Content-Type: text/plain");
-            client.println();
-            client.println("Invalid directory");
+            sendText(out, "400 Bad Request", "Invalid directory\r\n");
             return;
         }
 
-        String json = "{\"path\":\"" + path + "\",\"entries\":[";
-        bool first = true;
-        FsFile entry;
-        char namebuf[64];
-
-        while (entry.openNext(&dir, O_RDONLY)) {
-            entry.getName(namebuf, sizeof(namebuf));
-            if (!first) json += ",";
-            json += "{";
-            json += "\"name\":\"" + String(namebuf) + "\"";
-            String entryPath = path;
-            if (!entryPath.endsWith("/")) entryPath += "/";
-            entryPath += String(namebuf);
-            json += ",\"path\":\"" + entryPath + "\"";
-            json += ",\"isDir\":" + String(entry.isDir() ? "true" : "false");
-            if (!entry.isDir()) json += ",\"size\":" + String((unsigned long)entry.fileSize());
-            json += "}";
-            first = false;
-            entry.close();
+        long offset = 0;
+        long limit = DIRLIST_DEFAULT_LIMIT;
+        req.queryLong("offset", offset);
+        req.queryLong("limit", limit);
+        if (offset < 0) offset = 0;
+        if (limit < 0) limit = 0;
+        if (limit > DIRLIST_MAX_LIMIT) limit = DIRLIST_MAX_LIMIT;
+
+        DirSort sort = DIRSORT_NONE;
+        if (req.queryEq("sort", "mtime")) sort = DIRSORT_MTIME;
+        else if (req.queryEq("sort", "size")) sort = DIRSORT_SIZE;
+        bool asc = req.queryEq("order", "asc");
+
+        uint16_t nKeys = 0;
+        uint32_t total = 0;
+        if (sort != DIRSORT_NONE) {
+            DirKey after{0, 0};
+            bool haveAfter = false;
+            long skip = offset;
+            while (skip > 0) {
+                uint16_t step = skip > DIRLIST_SORT_MAX ? DIRLIST_SORT_MAX : (uint16_t)skip;
+                uint16_t got = collectSorted(dir, sort, asc, step, total, haveAfter ? &after : nullptr);
+                if (got == 0) break;
+                after = dirKeys[got - 1];
+                haveAfter = true;
+                skip -= got;
+                if (got < step) break;      // Offset er forbi mappens slutning
+            }
+            if (skip == 0) nKeys = collectSorted(dir, sort, asc, (uint16_t)limit, total, haveAfter ? &after : nullptr);
         }
-        json += "]}";
 
-        client.println("HTTP/1.1 200 OK");
-        client.println("Content-Type: application/json");
-        client.println();
-        client.print(json);
+        WebCountingPrint counter;
+        writeDirList(counter, dir, path, sort, offset, limit, nKeys, total);
+        beginResponse(out, "200 OK", "application/json", (long)counter.count);
+        writeDirList(out, dir, path, sort, offset, limit, nKeys, total);
+        dir.close();
     }
 
-    void handleDelete(WiFiClient& client, const String& req) {
-        String requestLine = getRequestLine(req);
-        String path = extractPathFromRequestLine(requestLine);
+    void handleDelete(WebTxBuffer& out, const HttpRequest& req) {
+        char path[128];
+        extractPath(req, path, sizeof(path));
 
-        bool ok = sd.remove(path.c_str());
-        client.println("HTTP/1.1 200 OK");
-        client.println();
-        client.println(ok ? "OK" : "FEJL");
+        if (fileSending(fileGuard, path)) {
+            sendText(out, "409 Conflict", "Filen downloades lige nu\r\n");
+            return;
+        }
+        if (lyslog) lyslog->release();     // Logfilerne holdes åbne af LysLog
+        bool ok = sd.remove(path);
+        sendText(out, "200 OK", ok ? "OK\r\n" : "FEJL\r\n");
     }
 
-    void handleDownload(WiFiClient& client, const String& req) {
-        String requestLine = getRequestLine(req);
-        String path = extractPathFromRequestLine(requestLine);
+    /**
+     * @brief Fortolk "Range: bytes=..." (ét interval: a-b, a- eller -n).
+     * @return 1 = gyldigt interval (206), 0 = ignorér headeren (hele filen, 200),
+     *         -1 = kan ikke opfyldes (416).
+     */
+    static int parseByteRange(const HttpSlice& v, uint32_t size, uint32_t& start, uint32_t& end) {
+        static const char prefix[] = "bytes=";
+        const uint16_t plen = sizeof(prefix) - 1;
+        if (v.len <= plen || strncasecmp(v.p, prefix, plen) != 0) return 0;
+        const char* p = v.p + plen;
+        const char* e = v.p + v.len;
+        for (const char* q = p; q < e; q++) {
+            if (*q == ',') return 0;    // Flere intervaller: send hele filen (tilladt efter RFC 9110)
+        }
 
-        FsFile file = sd.open(path.c_str(), O_RDONLY);
-        if (!file) {
-            client.println("HTTP/1.1 404 Not Found\r\n\r\n");
-            return;
+        bool haveA = false, haveB = false;
+        uint32_t a = 0, b = 0;
+        while (p < e && *p >= '0' && *p <= '9') { a = a * 10 + (*p++ - '0'); haveA = true; }
+        if (p >= e || *p++ != '-') return 0;
+        while (p < e && *p >= '0' && *p <= '9') { b = b * 10 + (*p++ - '0'); haveB = true; }
+        if (p != e || (!haveA && !haveB)) return 0;
+
+        if (!haveA) {                           // "-n": de sidste n bytes
+            if (b == 0 || size == 0) return -1;
+            start = (b >= size) ? 0 : size - b;
+            end = size - 1;
+            return 1;
+        }
+        if (a >= size) return -1;
+        if (haveB && b < a) return 0;           // Ugyldig syntaks → ignorér
+        start = a;
+        end = (!haveB || b >= size) ? size - 1 : b;
+        return 1;
+    }
+
+    /**
+     * Download med Content-Length og Range (206) – en afbrudt overførsel kan genoptages.
+     * Kun headeren skrives her; selve filen streames af WebServerEngine i sektor-justerede
+     * bidder efterhånden som lwIP's sendebuffer har plads (se takeFile()).
+     */
+    WebReply handleDownload(WebTxBuffer& out, const HttpRequest& req) {
+        char path[128];
+        extractPath(req, path, sizeof(path));
+
+        if (lyslog) lyslog->flush();       // Bufferede log-linjer med i download
+        FsFile file = sd.open(path, O_RDONLY);
+        if (!file || file.isDir()) {
+            send404(out);
+            return REPLY_DONE;
+        }
+
+        uint32_t size = (uint32_t)file.fileSize();
+        uint32_t start = 0, end = size ? size - 1 : 0;
+        bool partial = false;
+
+        HttpSlice range;
+        if (req.header("Range", range)) {
+            int r = parseByteRange(range, size, start, end);
+            if (r < 0) {
+                char extra[48];
+                snprintf(extra, sizeof(extra), "Content-Range: bytes */%lu\r\n", (unsigned long)size);
+                beginResponse(out, "416 Range Not Satisfiable", nullptr, 0, extra);
+                return REPLY_DONE;
+            }
+            partial = (r > 0);
         }
 
         char namebuf[64] = "download.bin";
         file.getName(namebuf, sizeof(namebuf));
 
-        client.println("HTTP/1.1 200 OK");
-        client.print("Content-Disposition: attachment; filename=\"");
-        client.print(namebuf);
-        client.println("\"");
-        client.println("Content-Type: application/octet-stream");
-        client.println();
-
-        uint8_t buf[512];
-        int n;
-        while ((n = file.read(buf, sizeof(buf))) > 0) client.write(buf, n);
-        file.close();
-    }
+        char extra[192];
+        int n = snprintf(extra, sizeof(extra),
+                         "Accept-Ranges: bytes\r\nContent-Disposition: attachment; filename=\"%s\"\r\n", namebuf);
+        if (partial && n < (int)sizeof(extra)) {
+            snprintf(extra + n, sizeof(extra) - n, "Content-Range: bytes %lu-%lu/%lu\r\n",
+                     (unsigned long)start, (unsigned long)end, (unsigned long)size);
+        }
+        uint32_t len = size ? end - start + 1 : 0;
+        beginResponse(out, partial ? "206 Partial Content" : "200 OK", "application/octet-stream", (long)len, extra);
+        if (len == 0) return REPLY_DONE;
 
-    void handleUpload(WiFiClient& client, const String& req) {
-        // Multipart upload parser (som din nuværende "rigtige C++" version)
-        Serial.println("Upload valgt");
+        if (start && !file.seekSet(start)) {
+            keepAlive = false;          // Header er sendt – afbryd forbindelsen
+            return REPLY_DONE;
+        }
+        pendingFile = file;
+        pendingLen = len;
+        return REPLY_FILE;
+    }
 
-        int boundaryPos = req.indexOf("boundary=");
-        if (boundaryPos < 0) {
-            client.println("HTTP/1.1 400 Bad Request\r\n\r\nMissing boundary");
-            return;
+    /**
+     * @brief /api/log?file=pir[&from=YYYY-MM-DD][&to=YYYY-MM-DD][&limit=100]
+     *        /api/log/tail?file=pir[&n=100]
+     *
+     * Kun de matchende linjer sendes (file=events: 12-byte records). LysLog finder
+     * byte-intervallet via dato-indekset eller ved at læse baglæns fra slutningen, og
+     * intervallet streames derefter som en download (REPLY_FILE). "X-Log-More: 1"
+     * betyder at der er flere linjer end sendt (limit nået eller måneds-arkivet slutter).
+     */
+    WebReply handleLogQuery(WebTxBuffer& out, const HttpRequest& req, bool tail) {
+        uint8_t slot = LOG_PIR;
+        uint32_t from = 0, to = 0;
+        if (!parseLogSlot(req, slot) || !parseLogDay(req, "from", from) || !parseLogDay(req, "to", to)) {
+            sendText(out, "400 Bad Request", "Ugyldig file/from/to\r\n");
+            return REPLY_DONE;
+        }
+        long limit = LOGQUERY_DEFAULT_LIMIT;
+        req.queryLong(tail ? "n" : "limit", limit);
+        if (limit <= 0 || limit > LOGQUERY_MAX_LIMIT) limit = LOGQUERY_MAX_LIMIT;
+
+        FsFile file;
+        uint32_t len = 0;
+        bool more = false;
+        bool ok = false;
+        if (lyslog) {
+            ok = tail ? lyslog->tail(slot, (uint32_t)limit, file, len)
+                      : lyslog->query(slot, from, to, (uint32_t)limit, file, len, more);
+        }
+        if (!ok) {
+            if (file.isOpen()) file.close();
+            len = 0;        // Ingen fil eller ingen linjer på/efter from: tomt svar
         }
-        String boundary = "--" + req.substring(boundaryPos + 9, req.indexOf('\r', boundaryPos));
 
-        int clPos = req.indexOf("Content-Length: ");
-        int contentLen = -1;
-        if (clPos >= 0) {
-            int clEnd = req.indexOf('\r', clPos);
-            contentLen = req.substring(clPos + 16, clEnd).toInt();
+        char extra[64];
+        snprintf(extra, sizeof(extra), "Cache-Control: no-cache\r\n%s", more ? "X-Log-More: 1\r\n" : "");
+        const char* ctype = (slot == LysLog::SLOT_BIN) ? "application/octet-stream" : "text/plain; charset=utf-8";
+        beginResponse(out, "200 OK", ctype, (long)len, extra);
+        if (len == 0) {
+            if (file.isOpen()) file.close();
+            return REPLY_DONE;
         }
+        pendingFile = file;
+        pendingLen = len;
+        return REPLY_FILE;
+    }
 
-        int bodyStart = req.indexOf("\r\n\r\n");
-        if (bodyStart < 0) {
-            client.println("HTTP/1.1 400 Bad Request\r\n\r\nNo body");
+    /**
+     * @brief /history?sensor=lux|temp|pressure&res=1s|1m|15m[&n=antal]
+     *
+     * Binært svar: HistHeader (16 bytes) + count HistRecord (6 bytes, ældste først),
+     * dekodes med tools/history.py. Længden kendes før afsendelse (fast record-størrelse),
+     * så records læses direkte fra ringen i bidder – en record core1 overskriver
+     * undervejs sendes som HIST_GAP.
+     */
+    void handleHistory(WebTxBuffer& out, const HttpRequest& req) {
+        uint8_t sensor = HIST_LUX;
+        if (req.queryEq("sensor", "temp")) sensor = HIST_TEMP;
+        else if (req.queryEq("sensor", "pressure")) sensor = HIST_PRESSURE;
+        else if (req.hasQuery("sensor") && !req.queryEq("sensor", "lux")) sensor = HIST_SENSOR_COUNT;
+
+        uint8_t res = HIST_1M;
+        if (req.queryEq("res", "1s")) res = HIST_1S;
+        else if (req.queryEq("res", "15m")) res = HIST_15M;
+        else if (req.hasQuery("res") && !req.queryEq("res", "1m")) res = HIST_RES_COUNT;
+
+        if (sensor >= HIST_SENSOR_COUNT || res >= HIST_RES_COUNT) {
+            sendText(out, "400 Bad Request", "Ugyldig sensor/res\r\n");
             return;
         }
-        bodyStart += 4;
-        size_t alreadyRead = req.length() - bodyStart;
 
-        static const size_t BUFSIZE = 2048;
-        std::vector<uint8_t> buffer;
-        buffer.reserve(BUFSIZE * 2);
-        size_t bufPos = 0;
+        const HistRing& ring = sensorHistory[sensor]->ring(res);
+        uint32_t written = 0, lastEpoch = 0;
+        ring.state(written, lastEpoch);
+        uint32_t count = written < ring.readable() ? written : ring.readable();
+        long n = (long)count;
+        req.queryLong("n", n);
+        if (n >= 0 && (uint32_t)n < count) count = (uint32_t)n;
+
+        HistHeader h{{'L', 'H'}, 1, sensor, histResSeconds(res), (uint16_t)sizeof(HistRecord), lastEpoch, count};
+        beginResponse(out, "200 OK", "application/octet-stream",
+                      (long)(sizeof(h) + count * sizeof(HistRecord)), "Cache-Control: no-cache\r\n");
+        out.write((const uint8_t*)&h, sizeof(h));
+
+        HistRecord chunk[64];
+        uint32_t i = written - count;
+        while (i < written) {
+            uint16_t k = 0;
+            for (; k < 64 && i < written; k++, i++) {
+                if (!ring.get(i, chunk[k])) chunk[k] = HistRecord{HIST_GAP, HIST_GAP, HIST_GAP};
+            }
+            out.write((const uint8_t*)chunk, k * sizeof(HistRecord));
+        }
+    }
 
-        if (alreadyRead > 0) {
-            buffer.insert(buffer.end(), req.c_str() + bodyStart, req.c_str() + req.length());
-            bufPos += alreadyRead;
+    /**
+     * Upload (multipart/form-data). Her valideres kun headeren og sessionen startes;
+     * WebServerEngine fødder derefter body'en ind via uploadFeed() efterhånden som den
+     * modtages, og kalder uploadFinish() når Content-Length er læst.
+     * Feltet "path" (eller ?path=) skal komme før filerne.
+     */
+    WebReply handleUpload(WebTxBuffer& out, const HttpRequest& req) {
+        HttpSlice ctype;
+        int bpos = req.header("Content-Type", ctype) ? ctype.findNoCase("boundary=") : -1;
+        if (bpos < 0) {
+            keepAlive = false;   // Body er ikke læst
+            sendText(out, "400 Bad Request", "Missing boundary\r\n");
+            return REPLY_DONE;
+        }
+        if (req.contentLength() <= 0) {
+            keepAlive = false;
+            sendText(out, "411 Length Required", "Content-Length mangler\r\n");
+            return REPLY_DONE;
+        }
+        if (upload.active) {
+            keepAlive = false;
+            sendText(out, "503 Service Unavailable", "Upload i gang\r\n");
+            return REPLY_DONE;
         }
 
-        size_t totalBytesRead = alreadyRead;
-        size_t totalBytesToRead = (contentLen > 0) ? (size_t)contentLen : (size_t)0x7FFFFFFF;
-
-        enum ParseState { WAIT_BOUNDARY, READ_HEADERS, READ_DATA };
-        ParseState state = WAIT_BOUNDARY;
-
-        String curFilename, lastUploadPath = "/";
-        FsFile curFile;
-        bool isPathField = false;
-        String formFieldName;
-
-        auto ensureDirs = [](const String& fullpath) {
-            int lastSlash = fullpath.lastIndexOf('/');
-            if (lastSlash <= 0) return;
-            String dir = fullpath.substring(0, lastSlash);
-            String build = "";
-            for (size_t i = 1; i < dir.length(); ++i) {
-                if (dir[i] == '/' || i == dir.length() - 1) {
-                    size_t end = (i == dir.length() - 1) ? i + 1 : i;
-                    build = dir.substring(0, end);
-                    if (!sd.exists(build.c_str())) sd.mkdir(build.c_str());
-                }
-            }
-        };
+        // boundary=værdi (evt. i anførselstegn, evt. efterfulgt af ;param)
+        const char* b = ctype.p + bpos + 9;
+        const char* e = ctype.p + ctype.len;
+        if (b < e && *b == '"') {
+            b++;
+            const char* q = (const char*)memchr(b, '"', e - b);
+            if (q) e = q;
+        } else {
+            const char* q = (const char*)memchr(b, ';', e - b);
+            if (q) e = q;
+            while (e > b && e[-1] == ' ') e--;
+        }
+        if (!upload.mp.begin(b, (size_t)(e - b), &upload)) {
+            keepAlive = false;
+            sendText(out, "400 Bad Request", "Invalid boundary\r\n");
+            return REPLY_DONE;
+        }
 
-        auto findBoundary = [&](const std::vector<uint8_t>& buf, const String& b, size_t start = 0) -> int {
-            if (b.length() == 0 || buf.size() < b.length()) return -1;
-            for (size_t i = start; i <= buf.size() - b.length(); ++i) {
-                bool match = true;
-                for (size_t j = 0; j < b.length(); ++j) {
-                    if (buf[i + j] != (uint8_t)b[j]) { match = false; break; }
-                }
-                if (match) return (int)i;
-            }
-            return -1;
-        };
+        Serial.println("Upload valgt");
+        extractPath(req, upload.dir, sizeof(upload.dir));
+        upload.left = (uint32_t)req.contentLength();
+        upload.t0 = millis();
+        upload.active = true;
+        return REPLY_BODY;
+    }
 
-        auto findCRLF = [](const std::vector<uint8_t>& buf, size_t start) -> int {
-            for (size_t i = start; i + 1 < buf.size(); ++i) {
-                if (buf[i] == 13 && buf[i + 1] == 10) return (int)i;
-            }
-            return -1;
-        };
+    // ------------------ Upload-session (fødes af WebServerEngine) ------------------
+public:
+    /** Næste bid af request-body efter REPLY_BODY. */
+    void uploadFeed(const uint8_t* p, size_t n) {
+        if (!upload.active) return;
+        upload.mp.feed(p, n);
+        upload.left = (n < upload.left) ? upload.left - (uint32_t)n : 0;
+    }
 
-        bool done = false, anyFile = false;
+    /** Hele body er modtaget: afslut sessionen og skriv svaret. */
+    void uploadFinish(WebTxBuffer& out, bool keep) {
+        keepAlive = keep;
+        bool complete = upload.mp.finished();
+        uint32_t ms = millis() - upload.t0;
+        Serial.printf("Upload: %lu bytes i %u filer på %lu ms (%lu KB/s)\n", (unsigned long)upload.bytes,
+                      upload.files, (unsigned long)ms, (unsigned long)(ms ? upload.bytes / ms : 0));
+        bool failed = upload.failed || !complete;
+        bool conflict = upload.conflict;
+        uint16_t files = upload.files;
+        upload.end(!complete);
+
+        if (conflict) sendText(out, "409 Conflict", "Filen downloades lige nu\r\n");
+        else if (failed) sendText(out, "500 Internal Server Error", "Upload fejlede\r\n");
+        else if (files > 0) sendText(out, "200 OK", "Upload OK\r\n");
+        else sendText(out, "400 Bad Request", "No files uploaded\r\n");
+    }
 
-        while (!done && totalBytesRead < totalBytesToRead) {
-            if (buffer.size() < BUFSIZE && totalBytesRead < totalBytesToRead) {
-                uint8_t tmp[BUFSIZE];
-                int n = client.read(tmp, BUFSIZE);
-                if (n > 0) {
-                    buffer.insert(buffer.end(), tmp, tmp + n);
-                    totalBytesRead += (size_t)n;
-                } else {
-                    delay(1);
-                }
-            }
+    /** Forbindelsen er tabt/timeout midt i en upload: halve filer slettes. */
+    void uploadAbort() {
+        if (!upload.active) return;
+        Serial.println("Upload afbrudt");
+        upload.end(true);
+    }
 
-            switch (state) {
-                case WAIT_BOUNDARY: {
-                    int bstart = findBoundary(buffer, boundary, 0);
-                    if (bstart < 0) {
-                        if (buffer.size() > boundary.length())
-                            buffer.erase(buffer.begin(), buffer.end() - boundary.length());
-                        break;
-                    }
-                    bufPos = (size_t)bstart + boundary.length();
-                    if (bufPos + 2 <= buffer.size() && buffer[bufPos] == 13 && buffer[bufPos + 1] == 10) bufPos += 2;
-                    if (bufPos + 2 <= buffer.size() && buffer[bufPos] == '-' && buffer[bufPos + 1] == '-') {
-                        done = true;
-                        break;
-                    }
-                    state = READ_HEADERS;
-                    buffer.erase(buffer.begin(), buffer.begin() + bufPos);
-                    bufPos = 0;
-                    break;
+private:
+    /**
+     * Skriver multipart-filer til SD. Filen præ-allokeres sammenhængende ud fra
+     * resterende Content-Length (øvre grænse) og trunkeres ved afslutning. Data samles
+     * i en 512-byte justeret buffer, så SD skrives i hele sektorer direkte fra bufferen.
+     */
+    struct UploadSession : public MultipartSink {
+        MultipartStream mp;
+        bool     active = false;
+        bool     failed = false;
+        bool     inPath = false;
+        bool     conflict = false;  // En fil blev sprunget over fordi den downloades
+        WebFileGuard* guard = nullptr;
+        uint16_t files = 0;
+        uint32_t bytes = 0;         // Fil-data skrevet (alle filer)
+        uint32_t left = 0;          // Body-bytes endnu ikke modtaget
+        uint32_t t0 = 0;
+        char     dir[128] = "/";
+        uint8_t  dirLen = 0;
+        char     curPath[192];
+        FsFile   file;
+        uint16_t len = 0;
+        alignas(4) uint8_t buf[UPLOAD_BUF];
+
+        void partBegin(const char* name, const char* filename) override {
+            if (filename[0] == '\0') {
+                if (strcmp(name, "path") == 0) {
+                    inPath = true;
+                    dirLen = 0;
                 }
+                return;
+            }
+            // Kun selve filnavnet (ældre browsere sender hele stien)
+            const char* base = filename;
+            for (const char* q = filename; *q; q++) {
+                if (*q == '/' || *q == '\\') base = q + 1;
+            }
+            if (*base == '\0') return;
+            if (lyslog) lyslog->release();     // Upload kan overskrive en åben logfil
+            size_t dl = strlen(dir);
+            while (dl > 1 && dir[dl - 1] == '/') dir[--dl] = '\0';
+            if (dl > 1 && !sd.exists(dir)) sd.mkdir(dir, true);     // Opret evt. manglende mapper
+            snprintf(curPath, sizeof(curPath), "%s%s%s", dir, (dl == 1) ? "" : "/", base);
+
+            if (fileSending(guard, curPath)) {      // O_TRUNC ville frigive dens clusters
+                Serial.printf("Upload: %s downloades – sprunget over\n", curPath);
+                conflict = true;
+                return;
+            }
+            file = sd.open(curPath, O_WRONLY | O_CREAT | O_TRUNC);
+            if (!file) {
+                Serial.printf("Upload: kan ikke oprette %s\n", curPath);
+                failed = true;
+                return;
+            }
+            if (left > 0 && !file.preAllocate(left)) {
+                Serial.println("Upload: preAllocate fejlede – skriver uden");
+            }
+            len = 0;
+            files++;
+        }
 
-                case READ_HEADERS: {
-                    String headers = "";
-                    while (true) {
-                        int crlf = findCRLF(buffer, bufPos);
-                        if (crlf < 0) break;
-                        if (crlf == (int)bufPos) { bufPos += 2; break; }
-                        String line((char*)&buffer[bufPos], (size_t)crlf - bufPos);
-                        headers += line + "\n";
-                        bufPos = (size_t)crlf + 2;
-                    }
-                    if (bufPos == 0 || bufPos > buffer.size()) break;
-
-                    int namePos = headers.indexOf("name=\"");
-                    int nameEnd = headers.indexOf("\"", namePos + 6);
-                    formFieldName = (namePos >= 0 && nameEnd > namePos) ? headers.substring(namePos + 6, nameEnd) : "";
-
-                    int fnPos = headers.indexOf("filename=\"");
-                    if (fnPos >= 0) {
-                        int fnEnd = headers.indexOf("\"", fnPos + 10);
-                        curFilename = headers.substring(fnPos + 10, fnEnd);
-                        String fullpath = lastUploadPath;
-                        if (!fullpath.endsWith("/")) fullpath += "/";
-                        fullpath += curFilename;
-                        ensureDirs(fullpath);
-
-                        curFile = sd.open(fullpath.c_str(), O_WRITE | O_CREAT | O_TRUNC);
-                        anyFile = true;
-                        isPathField = false;
-                        state = READ_DATA;
-                    } else if (formFieldName == "path") {
-                        isPathField = true;
-                        curFilename = "";
-                        state = READ_DATA;
-                    } else {
-                        state = WAIT_BOUNDARY;
-                    }
-                    buffer.erase(buffer.begin(), buffer.begin() + bufPos);
-                    bufPos = 0;
-                    break;
-                }
+        void partData(const uint8_t* p, size_t n) override {
+            if (inPath) {
+                while (n-- > 0 && dirLen < sizeof(dir) - 1) dir[dirLen++] = (char)*p++;
+                dir[dirLen] = '\0';
+                return;
+            }
+            if (!file.isOpen()) return;
+            while (n > 0) {
+                size_t k = UPLOAD_BUF - len;
+                if (k > n) k = n;
+                memcpy(buf + len, p, k);
+                len += (uint16_t)k;
+                p += k;
+                n -= k;
+                if (len == UPLOAD_BUF) flushBuf();
+            }
+        }
 
-                case READ_DATA: {
-                    int boundaryIdx = findBoundary(buffer, boundary, bufPos);
-                    if (boundaryIdx < 0) {
-                        size_t toWrite = (buffer.size() > boundary.length()) ? buffer.size() - boundary.length() : 0;
-                        if (!isPathField && curFile && toWrite > 0) {
-                            curFile.write(&buffer[bufPos], toWrite);
-                            buffer.erase(buffer.begin(), buffer.begin() + toWrite);
-                        }
-                        break;
-                    } else {
-                        if (isPathField) {
-                            size_t len = (size_t)boundaryIdx;
-                            if (len >= 2 && buffer[boundaryIdx - 2] == 13 && buffer[boundaryIdx - 1] == 10) len -= 2;
-                            String pathStr((char*)&buffer[bufPos], len);
-                            pathStr.trim();
-                            if (!pathStr.startsWith("/")) pathStr = "/" + pathStr;
-                            lastUploadPath = pathStr;
-                        } else if (curFile) {
-                            size_t toWrite = (size_t)boundaryIdx;
-                            if (toWrite >= 2 && buffer[boundaryIdx - 2] == 13 && buffer[boundaryIdx - 1] == 10) toWrite -= 2;
-                            if (toWrite > 0) curFile.write(&buffer[bufPos], toWrite);
-                            curFile.close();
-                        }
-                        curFile = FsFile();
-                        isPathField = false;
-                        state = WAIT_BOUNDARY;
-                        buffer.erase(buffer.begin(), buffer.begin() + (size_t)boundaryIdx + boundary.length());
-                        bufPos = 0;
-                    }
-                    break;
-                }
+        void partEnd() override {
+            if (inPath) {
+                inPath = false;
+                trimDir();
+                return;
             }
+            closeFile(false);
         }
 
-        if (curFile && curFile.isOpen()) curFile.close();
+        void flushBuf() {
+            if (len == 0 || !file.isOpen()) return;
+            if (file.write(buf, len) != len) failed = true;
+            bytes += len;
+            len = 0;
+        }
 
-        if (anyFile) {
-            client.println("HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n\r\nUpload OK");
-        } else {
-            client.println("HTTP/1.1 400 Bad Request\r\n\r\nNo files uploaded");
+        /** Skriv resten, frigiv præ-allokeret plads efter data; slet filen ved fejl/afbrydelse. */
+        void closeFile(bool discard) {
+            if (!file.isOpen()) return;
+            if (!discard) flushBuf();
+            file.truncate();
+            file.close();
+            if (discard || failed) sd.remove(curPath);
         }
-    }
+
+        void trimDir() {
+            char* s = dir;
+            while (*s == ' ' || *s == '\r' || *s == '\n') s++;
+            size_t n = strlen(s);
+            while (n > 0 && (s[n - 1] == ' ' || s[n - 1] == '\r' || s[n - 1] == '\n')) n--;
+            char tmp[sizeof(dir)];
+            snprintf(tmp, sizeof(tmp), "%s%.*s", (n && s[0] == '/') ? "" : "/", (int)n, s);
+            strcpy(dir, tmp);
+        }
+
+        void end(bool discard) {
+            closeFile(discard || mp.inPart());
+            active = failed = inPath = conflict = false;
+            files = 0;
+            bytes = 0;
+            left = 0;
+            len = 0;
+            dirLen = 0;
+            strcpy(dir, "/");
+        }
+    };
+    UploadSession upload;
 };
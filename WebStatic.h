@@ -0,0 +1,361 @@
+#pragma once
+/**
+ * @file WebStatic.h
+ * @brief Gzip-komprimerede statiske web-sider (GENERERET af tools/webgz.py – ret i web/).
+ *
+ * Serveres med Content-Encoding: gzip, Content-Length og ETag.
+ * Browseren revaliderer med If-None-Match og får 304 hvis intet er ændret.
+ */
+
+#include <Arduino.h>
+#include <cstdint>
+
+struct WebStaticFile {
+    const char*    path;
+    const char*    contentType;
+    const uint8_t* data;
+    uint32_t       len;
+    uint32_t       rawLen;
+    const char*    etag;
+};
+
+// index.htm: 6107 -> 2111 bytes
+static const uint8_t webgz_index_htm[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x58, 0xfd, 0x6e, 0xdb, 0x38,
+    0x12, 0xff, 0xdf, 0x4f, 0xc1, 0xf5, 0xe1, 0x2a, 0xf9, 0xe2, 0xef, 0xa6, 0x8b, 0x83, 0x6d, 0xb9,
+    0x68, 0x93, 0x16, 0xed, 0x6e, 0x3e, 0x8a, 0x4b, 0xf6, 0x70, 0x8b, 0x5e, 0x70, 0x60, 0x24, 0xca,
+    0x66, 0x2c, 0x53, 0x82, 0x44, 0xd9, 0xf1, 0x06, 0x79, 0x9c, 0xf6, 0x45, 0xf2, 0x62, 0xfb, 0x1b,
+    0x52, 0xb6, 0xe5, 0x8f, 0xc4, 0xc5, 0xe2, 0x80, 0xc4, 0xb2, 0x86, 0x33, 0xbf, 0x19, 0xce, 0x0c,
+    0x67, 0x86, 0x1e, 0xfc, 0x74, 0x7a, 0x79, 0x72, 0xfd, 0xfb, 0x97, 0x0f, 0x6c, 0xac, 0xa7, 0xd1,
+    0x70, 0x40, 0x9f, 0x2c, 0xe2, 0x6a, 0xe4, 0x55, 0x83, 0x49, 0x15, 0xef, 0x82, 0x07, 0xc3, 0xca,
+    0x60, 0x2a, 0x34, 0x67, 0xfe, 0x98, 0xa7, 0x99, 0xd0, 0x5e, 0x35, 0xd7, 0x61, 0xe3, 0x9f, 0x55,
+    0xd6, 0xc2, 0x82, 0x96, 0x3a, 0x12, 0xc3, 0x5f, 0x63, 0xa5, 0xd3, 0x38, 0x62, 0x09, 0x57, 0x22,
+    0x1a, 0xb4, 0x2c, 0xb1, 0x90, 0x52, 0x7c, 0x2a, 0xbc, 0xea, 0x4c, 0x8a, 0x79, 0x12, 0xa7, 0xba,
+    0xca, 0x7c, 0xf0, 0x0a, 0x05, 0x94, 0xb9, 0x0c, 0xf4, 0xd8, 0x0b, 0xc4, 0x4c, 0xfa, 0xa2, 0x61,
+    0x5e, 0xea, 0x4c, 0x2a, 0xa9, 0x25, 0x8f, 0x1a, 0x99, 0xcf, 0x23, 0xe1, 0x75, 0xac, 0x8e, 0x4c,
+    0x2f, 0x08, 0x6e, 0xdc, 0xa9, 0xb3, 0x71, 0xb7, 0xce, 0x12, 0xf6, 0xa0, 0xc5, 0xbd, 0x6e, 0xf0,
+    0x48, 0x8e, 0x54, 0x8f, 0xf9, 0x00, 0x13, 0x69, 0xff, 0xb1, 0xd2, 0xbc, 0xcd, 0xb5, 0x8e, 0x55,
+    0xac, 0xd8, 0xc3, 0x2d, 0xf7, 0x27, 0xa3, 0x34, 0xce, 0x55, 0xd0, 0xf0, 0xe3, 0x28, 0x4e, 0x7b,
+    0xec, 0x6f, 0xe1, 0xf1, 0xf1, 0xeb, 0xd7, 0x3f, 0xf7, 0xd9, 0x6d, 0x9c, 0x06, 0x02, 0x04, 0xf0,
+    0x89, 0x3e, 0x2b, 0x56, 0xe7, 0x63, 0xa9, 0xf1, 0x96, 0xf0, 0x20, 0x90, 0x6a, 0xd4, 0x63, 0xdd,
+    0x76, 0x72, 0xcf, 0x8e, 0xf1, 0xd1, 0x67, 0x21, 0xcc, 0x6d, 0x64, 0xf2, 0x0f, 0x61, 0xa9, 0x25,
+    0x3d, 0x61, 0xb8, 0x57, 0x51, 0xfb, 0xf8, 0xdd, 0xbb, 0x9f, 0x4f, 0xff, 0x2f, 0x8a, 0x32, 0xcd,
+    0xf5, 0xc6, 0x66, 0x8b, 0xbd, 0xb2, 0x29, 0x4f, 0x47, 0x12, 0x7b, 0x7f, 0xbd, 0x25, 0xd8, 0x69,
+    0x76, 0xc4, 0x94, 0x24, 0xfd, 0x28, 0xf6, 0x27, 0x7b, 0x45, 0xcb, 0x6a, 0xc0, 0x6b, 0xdf, 0xe7,
+    0x42, 0x8e, 0xc6, 0xba, 0x07, 0x9b, 0xa3, 0x60, 0x8d, 0xde, 0x21, 0xe3, 0xda, 0x80, 0x1b, 0xb4,
+    0x8a, 0x10, 0x0c, 0x5a, 0x26, 0x1f, 0x06, 0xb7, 0x71, 0xb0, 0xc0, 0xdb, 0xb8, 0xb3, 0x1d, 0x79,
+    0x50, 0x2a, 0x83, 0x40, 0xce, 0x98, 0x1f, 0xf1, 0x2c, 0xf3, 0xaa, 0xc6, 0x8e, 0x2a, 0x93, 0x41,
+    0xf1, 0x15, 0x4b, 0xd5, 0x61, 0xa3, 0xd1, 0x33, 0x7f, 0x83, 0x16, 0x5e, 0x09, 0xa6, 0x3b, 0x3c,
+    0x5b, 0x64, 0x0c, 0x81, 0x6b, 0xb1, 0xab, 0x38, 0xd4, 0x0c, 0xae, 0x05, 0x54, 0x17, 0x4b, 0x09,
+    0xfe, 0xad, 0xbb, 0x97, 0x88, 0xc5, 0xdb, 0x32, 0xd6, 0x55, 0x66, 0x92, 0xcd, 0xab, 0x5e, 0x3d,
+    0x7d, 0xd7, 0xd8, 0x20, 0xcb, 0x16, 0x99, 0x16, 0x48, 0x3c, 0x26, 0x59, 0xf4, 0xf4, 0x2d, 0xd3,
+    0xec, 0xf2, 0xc2, 0xea, 0x8f, 0xd5, 0x7b, 0xad, 0xaa, 0xc3, 0xcb, 0x8b, 0x41, 0xcb, 0x0a, 0x0f,
+    0x2b, 0xaf, 0xd4, 0x6d, 0x96, 0xf4, 0xcb, 0x9f, 0x2f, 0x6b, 0x0b, 0xc3, 0x02, 0x2a, 0x0c, 0x09,
+    0x6b, 0xa5, 0x9a, 0x6c, 0xbe, 0xfc, 0xf8, 0x91, 0x65, 0x51, 0x3e, 0x99, 0xc0, 0x86, 0x68, 0x81,
+    0x63, 0xc2, 0xe2, 0x11, 0x4b, 0x85, 0xce, 0x53, 0x25, 0x52, 0xd0, 0xb4, 0x8c, 0x18, 0xcf, 0x75,
+    0x3c, 0xe5, 0x5a, 0x4e, 0x9a, 0xd5, 0xe1, 0x52, 0x68, 0x6d, 0xcd, 0xa0, 0x95, 0x58, 0x67, 0xfc,
+    0x9b, 0xa7, 0x92, 0xdf, 0x8a, 0x88, 0xc1, 0x2b, 0xb3, 0xa7, 0xef, 0x69, 0x20, 0xb1, 0x99, 0xbf,
+    0xaf, 0x3c, 0x32, 0x90, 0x2a, 0xc9, 0x35, 0xd3, 0x8b, 0x04, 0xba, 0x53, 0x1c, 0x55, 0x51, 0x65,
+    0x53, 0xa9, 0xbc, 0x6a, 0x1b, 0x4f, 0x7e, 0xef, 0x55, 0x3b, 0x6d, 0x7c, 0x2b, 0x36, 0x90, 0x45,
+    0x12, 0x59, 0x68, 0xcd, 0x06, 0xdc, 0xf2, 0x75, 0xc6, 0xa3, 0x5c, 0x90, 0xc4, 0xd0, 0x6a, 0x4d,
+    0xa0, 0x14, 0x94, 0x1e, 0x1b, 0x64, 0x88, 0xa4, 0xe1, 0x0e, 0xc4, 0x34, 0xa6, 0x65, 0x22, 0xac,
+    0xb8, 0x20, 0x37, 0xd2, 0x6c, 0x1a, 0x07, 0x62, 0x8b, 0x93, 0x16, 0xe0, 0x5c, 0xda, 0x4f, 0x49,
+    0xa0, 0x94, 0x09, 0x94, 0xcb, 0xd5, 0xe1, 0xf9, 0xd3, 0xb7, 0x48, 0xb3, 0xb3, 0xdf, 0xfe, 0xc3,
+    0x8a, 0x8d, 0x79, 0x25, 0x9c, 0x28, 0xbf, 0x07, 0x4c, 0x49, 0xa7, 0x4d, 0x8f, 0x67, 0x40, 0x10,
+    0xe5, 0x44, 0xa4, 0x1c, 0x0e, 0xde, 0x00, 0x21, 0x72, 0x19, 0x85, 0xbd, 0x0a, 0xc4, 0xa8, 0x7f,
+    0x72, 0x00, 0xec, 0x3d, 0x4f, 0x63, 0x24, 0x8d, 0x48, 0x75, 0xba, 0x98, 0x6c, 0xe0, 0x25, 0xa9,
+    0xc8, 0xb2, 0x0d, 0xc0, 0xf1, 0x17, 0x7e, 0x00, 0xed, 0x33, 0x1d, 0x35, 0xe4, 0x50, 0x92, 0x3f,
+    0x67, 0x25, 0x96, 0x76, 0x0c, 0x7d, 0xde, 0x46, 0x3a, 0x1d, 0x40, 0x99, 0xe2, 0x8c, 0x29, 0xe4,
+    0x95, 0x2a, 0x87, 0x09, 0xb9, 0x46, 0x4b, 0x87, 0xbd, 0x76, 0x81, 0x5a, 0xc2, 0x27, 0x5a, 0xce,
+    0xca, 0xd2, 0x8a, 0xeb, 0x1f, 0x72, 0xf9, 0x95, 0x0c, 0x70, 0xac, 0xd8, 0x97, 0xcf, 0xff, 0x62,
+    0x1d, 0x9c, 0x52, 0x7a, 0x76, 0xf1, 0xa4, 0xd3, 0x0f, 0xcc, 0x32, 0x62, 0x22, 0xd3, 0xce, 0xc6,
+    0xb6, 0x5a, 0x9b, 0x8b, 0xdd, 0x67, 0x17, 0xc7, 0xf3, 0x6c, 0xbe, 0xcf, 0x98, 0x84, 0x99, 0xea,
+    0x43, 0xa1, 0xdd, 0xae, 0x66, 0xd5, 0x75, 0x79, 0x28, 0x78, 0xd6, 0xe5, 0xad, 0xf3, 0x06, 0xc5,
+    0xb1, 0x0a, 0x6f, 0xf9, 0x91, 0xf4, 0x27, 0x38, 0xb4, 0x49, 0xc6, 0x85, 0x56, 0x28, 0xbb, 0x6e,
+    0x0d, 0x99, 0x9a, 0x64, 0x28, 0x18, 0xf4, 0x56, 0x3a, 0x80, 0x3f, 0x0a, 0x35, 0x89, 0x55, 0x28,
+    0x47, 0x39, 0x8e, 0xf5, 0x59, 0x6c, 0xd0, 0xf0, 0xf8, 0x0b, 0x30, 0xa1, 0x8c, 0x04, 0x49, 0x7f,
+    0xc4, 0x33, 0x36, 0x59, 0x22, 0xd1, 0x2b, 0xd2, 0xed, 0x8a, 0x90, 0xf9, 0xa9, 0x4c, 0xf4, 0xb0,
+    0x12, 0xe6, 0xca, 0x27, 0x0e, 0x56, 0xde, 0x09, 0x7b, 0x60, 0xa8, 0xab, 0x46, 0xb2, 0x99, 0x8a,
+    0x24, 0xe2, 0xbe, 0x70, 0x9d, 0xd6, 0x9a, 0xa3, 0x89, 0x86, 0xee, 0xd4, 0xfa, 0xec, 0x71, 0x2d,
+    0xbe, 0x65, 0xfd, 0x7e, 0x84, 0x28, 0x1e, 0xf9, 0x86, 0x6f, 0x0f, 0x80, 0xb5, 0x7b, 0xbf, 0x1c,
+    0xad, 0xdd, 0xa6, 0xf1, 0x3c, 0x13, 0xe9, 0x1e, 0xc9, 0x38, 0x09, 0x38, 0xe2, 0x76, 0x5a, 0x14,
+    0x0c, 0x17, 0x1f, 0xc0, 0xa9, 0x40, 0x13, 0x0a, 0xf5, 0xb2, 0x8c, 0xe0, 0xa0, 0x04, 0xb1, 0x9f,
+    0x4f, 0x11, 0xe2, 0xe6, 0x48, 0xe8, 0x0f, 0x91, 0xa0, 0xaf, 0xef, 0x17, 0x9f, 0x03, 0xd7, 0x59,
+    0xf2, 0x00, 0xb7, 0x22, 0x43, 0x92, 0x67, 0x9e, 0xe7, 0xb1, 0x76, 0x6d, 0x25, 0xdd, 0x94, 0x0a,
+    0x3e, 0xfc, 0x74, 0x7d, 0x7e, 0x06, 0x1c, 0xe7, 0x32, 0x0c, 0x9d, 0x7e, 0x45, 0x44, 0x99, 0x60,
+    0x25, 0x76, 0x14, 0xc8, 0x67, 0x05, 0xd4, 0x92, 0x7f, 0xff, 0xfa, 0xb2, 0x36, 0x83, 0xab, 0xb4,
+    0x2f, 0xf4, 0x73, 0x57, 0xd5, 0x1e, 0x6c, 0xb9, 0x67, 0x6a, 0xd0, 0x69, 0xbf, 0x75, 0xda, 0xce,
+    0x91, 0xea, 0x29, 0x74, 0xcf, 0x19, 0x47, 0x57, 0x12, 0xe9, 0x4c, 0xa4, 0xd7, 0x12, 0xa3, 0x90,
+    0xca, 0xa3, 0xa8, 0xbf, 0x45, 0x7c, 0xa7, 0x0b, 0xf2, 0x0a, 0x31, 0x37, 0x9e, 0x3a, 0xa1, 0x9e,
+    0xe9, 0xd6, 0x1e, 0x68, 0xaf, 0x25, 0x08, 0xcf, 0x70, 0xd7, 0x8a, 0xf6, 0x62, 0xc1, 0x44, 0xc4,
+    0x93, 0x4c, 0x04, 0xde, 0x39, 0xd7, 0xe3, 0x66, 0x18, 0xc5, 0x71, 0xea, 0xba, 0xa7, 0x80, 0x68,
+    0xaa, 0x78, 0xee, 0xd6, 0x1a, 0x65, 0x5d, 0xb5, 0x16, 0x1c, 0xd0, 0xae, 0x59, 0x39, 0x68, 0x16,
+    0x73, 0x46, 0x9c, 0x25, 0x0d, 0xe4, 0x77, 0x7a, 0xba, 0xb5, 0xa3, 0x02, 0xf7, 0x1f, 0x85, 0xc8,
+    0xb3, 0x91, 0x59, 0xb6, 0x77, 0xa7, 0xd6, 0xa4, 0x73, 0x7a, 0x52, 0x4c, 0x79, 0x15, 0x72, 0x8d,
+    0xe1, 0xfe, 0x14, 0xe7, 0x69, 0xe6, 0xd6, 0x6a, 0x47, 0x4e, 0xcf, 0x39, 0x5a, 0x51, 0xcf, 0xa5,
+    0x42, 0x25, 0xdc, 0xa5, 0x5f, 0x09, 0x24, 0x45, 0x40, 0x74, 0x72, 0xf4, 0x4a, 0x2b, 0xe6, 0xa6,
+    0x0f, 0x33, 0x7c, 0x39, 0x93, 0x28, 0x47, 0x08, 0x8b, 0xeb, 0x9c, 0x5e, 0x9e, 0x17, 0xba, 0xce,
+    0x62, 0x1e, 0x88, 0xc0, 0xa9, 0xb3, 0xa5, 0x13, 0xdd, 0x75, 0x6e, 0xd9, 0xbe, 0xf7, 0x52, 0x66,
+    0xad, 0x9a, 0x23, 0xa5, 0x96, 0x15, 0x8a, 0x73, 0x4d, 0x8d, 0xf6, 0x40, 0x3a, 0x96, 0xf8, 0x69,
+    0xc2, 0x78, 0x89, 0xdd, 0x30, 0x94, 0xf8, 0xcd, 0x18, 0xf1, 0xa2, 0x80, 0xe1, 0x20, 0x09, 0x6b,
+    0xcb, 0x46, 0x2e, 0x5a, 0x73, 0x9b, 0xa6, 0x95, 0x83, 0x61, 0xeb, 0x68, 0x25, 0x34, 0xab, 0xa3,
+    0x11, 0xb9, 0x65, 0x36, 0xf2, 0x66, 0x84, 0xd1, 0x84, 0x8a, 0x7a, 0x9e, 0x9d, 0xd1, 0x8c, 0xe8,
+    0xb1, 0x90, 0x23, 0xdd, 0xb7, 0xe9, 0x14, 0xfd, 0xd8, 0x6c, 0xde, 0x26, 0x26, 0xad, 0x26, 0x42,
+    0xd1, 0xd4, 0x4a, 0xdd, 0x68, 0x49, 0x5e, 0xe5, 0xeb, 0x4c, 0x66, 0xa0, 0xbb, 0x33, 0x72, 0x79,
+    0x59, 0x23, 0x38, 0x67, 0x7b, 0xad, 0x9f, 0xbd, 0x60, 0xf2, 0xcc, 0x46, 0x7d, 0x05, 0x4e, 0xa9,
+    0x75, 0x65, 0x4c, 0xfb, 0xcd, 0x88, 0x98, 0xc0, 0x6e, 0xec, 0x41, 0xa7, 0xe4, 0x03, 0x19, 0x32,
+    0x77, 0x67, 0x0b, 0x35, 0x74, 0x32, 0xc1, 0xd3, 0xe2, 0x6d, 0xcf, 0x7a, 0xbf, 0xb2, 0x6f, 0xdb,
+    0x99, 0x3d, 0x01, 0x24, 0xb2, 0xce, 0xa7, 0x2d, 0xad, 0x85, 0xe7, 0x48, 0x6d, 0xc9, 0x37, 0x3f,
+    0x79, 0xd6, 0x3b, 0x54, 0x21, 0x0b, 0xb7, 0xac, 0x57, 0x51, 0x0f, 0x77, 0xdd, 0x88, 0x12, 0xf9,
+    0x58, 0x67, 0x9d, 0xae, 0x39, 0x61, 0x8f, 0x4b, 0xff, 0xc5, 0xca, 0x0e, 0x7a, 0xde, 0x66, 0x42,
+    0xef, 0xf1, 0xa5, 0x1e, 0xcb, 0xec, 0x60, 0x1e, 0xac, 0x99, 0x4c, 0x16, 0xec, 0xb8, 0x14, 0x9a,
+    0xfb, 0x6b, 0xd5, 0xb8, 0xeb, 0x61, 0xb0, 0xdc, 0xd6, 0x1d, 0x0a, 0xed, 0x8f, 0x51, 0xe5, 0xdf,
+    0xda, 0xf9, 0xd1, 0x61, 0x47, 0x25, 0xdd, 0x78, 0x71, 0x5e, 0x29, 0xb4, 0x04, 0x7f, 0x6c, 0x97,
+    0x4c, 0x29, 0xc2, 0x80, 0x1a, 0xc4, 0x53, 0xf7, 0x05, 0x9d, 0xe6, 0x54, 0x34, 0x8b, 0xae, 0xf8,
+    0x9c, 0x46, 0x34, 0x19, 0xb4, 0x93, 0x57, 0x54, 0x5d, 0xc6, 0x42, 0x6d, 0x86, 0x64, 0x33, 0xdd,
+    0x50, 0xa8, 0xf6, 0x26, 0x9c, 0xa5, 0x6f, 0x79, 0xa7, 0x63, 0x5c, 0xbe, 0xd7, 0xb0, 0xc2, 0x38,
+    0x73, 0x02, 0x0f, 0x5a, 0x17, 0x86, 0x3f, 0x6a, 0xde, 0x7e, 0xe3, 0xf6, 0x98, 0x76, 0xc0, 0xb0,
+    0xd5, 0xe1, 0xa0, 0x4e, 0x7f, 0x2d, 0x51, 0x36, 0xef, 0x35, 0x99, 0x44, 0x35, 0x3d, 0xf1, 0xf0,
+    0xd2, 0xcc, 0x92, 0x48, 0x6a, 0xb7, 0xf5, 0xf5, 0xbf, 0x8d, 0x1e, 0xbb, 0x69, 0x51, 0x9a, 0x97,
+    0x9a, 0xd0, 0xb2, 0xe6, 0x27, 0x5f, 0xdb, 0x37, 0xf5, 0xe4, 0x6b, 0xe7, 0xa6, 0xd1, 0xc1, 0xa3,
+    0x4b, 0xdf, 0x5f, 0xd3, 0xc7, 0x31, 0x7d, 0xbc, 0xb9, 0xd9, 0x90, 0x42, 0x97, 0x5a, 0x77, 0x94,
+    0x8d, 0x03, 0x8a, 0x34, 0xb7, 0x66, 0xba, 0x77, 0x64, 0x03, 0xba, 0x95, 0x83, 0x61, 0xde, 0xc1,
+    0x75, 0x9e, 0x81, 0xf0, 0x6c, 0x79, 0xb3, 0x03, 0x3f, 0x9c, 0x66, 0x5c, 0x71, 0x8d, 0xb6, 0x01,
+    0x57, 0xdc, 0x35, 0x41, 0x36, 0xdd, 0xdd, 0xa1, 0x11, 0xf9, 0x20, 0x48, 0x31, 0x47, 0xef, 0xa0,
+    0x10, 0xdd, 0xc2, 0x8c, 0x13, 0x7e, 0x10, 0x65, 0x39, 0xe6, 0xef, 0xc0, 0x40, 0xd8, 0xa2, 0x60,
+    0x64, 0x3f, 0x88, 0xb2, 0x1e, 0xeb, 0x77, 0x70, 0xb0, 0x64, 0x71, 0x68, 0x5a, 0x3f, 0xec, 0x19,
+    0x3b, 0xd5, 0xef, 0xa0, 0x10, 0xd1, 0xf3, 0x3a, 0x6f, 0x9d, 0x5f, 0x38, 0xda, 0xe5, 0x85, 0xb8,
+    0x73, 0x2c, 0x28, 0xe6, 0xf8, 0x83, 0x98, 0x76, 0xd6, 0xdf, 0x81, 0x04, 0x79, 0x1f, 0x22, 0xcd,
+    0xf1, 0x87, 0xbd, 0x66, 0x87, 0xfd, 0x5d, 0x33, 0x41, 0x5f, 0xc1, 0x74, 0x7f, 0x04, 0xa6, 0xfb,
+    0x0c, 0x4c, 0xb7, 0x08, 0x21, 0xee, 0x06, 0x07, 0x61, 0x8a, 0x0b, 0xc4, 0x6e, 0x08, 0x41, 0xb7,
+    0x30, 0x70, 0xeb, 0x12, 0xe5, 0x61, 0xab, 0x5b, 0xd4, 0x36, 0xeb, 0x32, 0xb2, 0x70, 0x91, 0x15,
+    0x93, 0x60, 0x51, 0xc4, 0x0d, 0xc9, 0xe4, 0x3d, 0xa0, 0x90, 0x5f, 0x38, 0x11, 0xb5, 0xd5, 0xe9,
+    0x2b, 0xde, 0x69, 0xb5, 0xd5, 0x62, 0x1f, 0x79, 0x14, 0xd1, 0x4f, 0x43, 0x2c, 0x8c, 0x53, 0x56,
+    0x8c, 0xc3, 0x82, 0xe5, 0x81, 0x50, 0xcc, 0x8c, 0x2f, 0x57, 0x98, 0x85, 0x7c, 0x51, 0x9a, 0x1f,
+    0xe3, 0x28, 0x2a, 0xc6, 0xf9, 0x35, 0x11, 0x85, 0x44, 0xbb, 0xfb, 0x0c, 0x5d, 0x8e, 0x7d, 0xcb,
+    0xea, 0x63, 0xd7, 0xee, 0x32, 0x5b, 0x23, 0x97, 0x35, 0x28, 0xf5, 0x86, 0x69, 0x93, 0x88, 0xa8,
+    0xbd, 0x5b, 0x55, 0xe9, 0x0e, 0x65, 0x69, 0x7d, 0x64, 0x1f, 0xb0, 0xad, 0xde, 0xdd, 0x57, 0x72,
+    0x0e, 0x4b, 0xd2, 0x98, 0xae, 0x56, 0xce, 0x4d, 0x9d, 0xe1, 0x14, 0x12, 0x75, 0xca, 0x39, 0x6e,
+    0xb4, 0x74, 0x9a, 0x41, 0xa3, 0xe4, 0xee, 0xd9, 0xa3, 0x55, 0x67, 0x38, 0x19, 0xf8, 0xfe, 0x29,
+    0xe1, 0xf5, 0x0a, 0x92, 0x1b, 0x5f, 0x4f, 0x6c, 0xf6, 0xd7, 0xcd, 0x5d, 0xb5, 0x67, 0xdc, 0xf5,
+    0xbf, 0x58, 0xbd, 0xed, 0xf4, 0xda, 0x20, 0x21, 0x23, 0x08, 0xae, 0xb8, 0x48, 0xe2, 0x15, 0x17,
+    0x49, 0x73, 0x1d, 0x15, 0x29, 0x76, 0x0e, 0xf0, 0x0a, 0x45, 0x7b, 0x8b, 0xa5, 0xbb, 0xc9, 0xc2,
+    0x28, 0x92, 0x25, 0x96, 0xe2, 0xfa, 0xb9, 0x85, 0x43, 0x81, 0xe8, 0xd9, 0x78, 0x98, 0x5a, 0x59,
+    0x6b, 0xe2, 0x96, 0x02, 0x47, 0x95, 0x8a, 0xb2, 0xa1, 0x57, 0xac, 0x83, 0xa9, 0xc2, 0x69, 0x73,
+    0x63, 0x47, 0xee, 0xb8, 0x44, 0xab, 0xb3, 0x37, 0xed, 0xa2, 0x15, 0x23, 0x96, 0x57, 0xa6, 0xfe,
+    0x35, 0xae, 0xe8, 0xea, 0x6d, 0x82, 0x97, 0xf5, 0x8a, 0x39, 0x89, 0x65, 0x93, 0xfc, 0xf6, 0x56,
+    0x64, 0x2c, 0x4c, 0xb9, 0xf9, 0x59, 0x33, 0x45, 0x18, 0x11, 0x68, 0xdc, 0x00, 0x9e, 0xbe, 0xa5,
+    0x4c, 0xc5, 0x48, 0x50, 0xf6, 0xf4, 0x5d, 0x05, 0xf4, 0xfb, 0x4f, 0x26, 0x47, 0x26, 0x90, 0x73,
+    0x89, 0x7e, 0x38, 0x6f, 0x96, 0xd2, 0x60, 0x59, 0xb5, 0x85, 0x99, 0x07, 0x50, 0x98, 0x4b, 0x6b,
+    0x88, 0xae, 0x30, 0x3a, 0x69, 0x06, 0x14, 0x19, 0xfa, 0xd0, 0x14, 0x75, 0x8a, 0x6f, 0x76, 0x66,
+    0x42, 0xc0, 0x04, 0xb4, 0xb0, 0xf3, 0x46, 0x11, 0xd5, 0x5f, 0xae, 0x2e, 0x2f, 0x9a, 0xa6, 0xf9,
+    0xbb, 0xa2, 0x89, 0xde, 0xc1, 0x6b, 0x74, 0x15, 0x63, 0xd6, 0x15, 0xf7, 0x90, 0x78, 0x64, 0xe8,
+    0x22, 0x8f, 0xcc, 0x64, 0xf8, 0x43, 0x65, 0x95, 0x81, 0x66, 0x00, 0x29, 0x39, 0xa4, 0x74, 0x11,
+    0xa9, 0xb3, 0xe2, 0x12, 0x40, 0xee, 0xc3, 0x25, 0xbd, 0xb8, 0x97, 0xe2, 0xbe, 0x4a, 0x3f, 0x07,
+    0x0e, 0x5a, 0xe6, 0x17, 0xe4, 0x3f, 0x01, 0x0e, 0xe2, 0x60, 0xa0, 0x51, 0x16, 0x00, 0x00,
+};
+
+// filebrowser.htm: 4472 -> 1726 bytes
+static const uint8_t webgz_filebrowser_htm[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x57, 0xfd, 0x6e, 0xdc, 0x44,
+    0x10, 0xff, 0xdf, 0x4f, 0xb1, 0x75, 0x4a, 0x62, 0x2b, 0x89, 0x7d, 0x69, 0x84, 0x68, 0xef, 0xab,
+    0xa2, 0x4d, 0x4a, 0x2b, 0x68, 0x1b, 0x91, 0x14, 0x09, 0x51, 0x44, 0x36, 0xf6, 0xfa, 0x6e, 0x9b,
+    0xf5, 0xae, 0x59, 0xef, 0xe5, 0x83, 0xf4, 0x24, 0x90, 0x80, 0x17, 0xe8, 0x03, 0xf0, 0x5f, 0x25,
+    0xde, 0x80, 0xff, 0xf3, 0x26, 0x3c, 0x01, 0x8f, 0xc0, 0xcc, 0xd8, 0xbe, 0xf3, 0x5d, 0x2e, 0x41,
+    0xe8, 0x74, 0xf2, 0x7a, 0x67, 0x76, 0x3e, 0x7f, 0x33, 0x3b, 0xee, 0xdf, 0xdb, 0x7b, 0xfd, 0xf4,
+    0xe8, 0xdb, 0x83, 0x7d, 0x36, 0x76, 0xb9, 0x1a, 0x7a, 0x7d, 0x7c, 0x30, 0xc5, 0xf5, 0x68, 0xe0,
+    0xa7, 0xdc, 0xc7, 0x0d, 0xc1, 0x53, 0x78, 0xe4, 0xc2, 0x71, 0x96, 0x8c, 0xb9, 0x2d, 0x85, 0x1b,
+    0xf8, 0x13, 0x97, 0x6d, 0x3f, 0x44, 0xaa, 0x93, 0x4e, 0x89, 0xe1, 0x33, 0xa9, 0x04, 0x7b, 0x62,
+    0xcd, 0x79, 0x29, 0x6c, 0x3f, 0xae, 0xf6, 0xbc, 0x7e, 0xe9, 0x2e, 0xf1, 0x79, 0x62, 0xd2, 0x4b,
+    0x76, 0xc5, 0x32, 0xa3, 0xdd, 0x76, 0xc6, 0x73, 0xa9, 0x2e, 0xbb, 0xac, 0xe4, 0xba, 0xdc, 0x06,
+    0x66, 0x99, 0xf5, 0xd8, 0x09, 0x4f, 0x4e, 0x47, 0xd6, 0x4c, 0x74, 0xda, 0x65, 0x6b, 0x59, 0x07,
+    0x7f, 0x3d, 0x36, 0xf5, 0xd6, 0x32, 0x10, 0xaa, 0x64, 0xe9, 0xe0, 0xec, 0xb9, 0x4c, 0xdd, 0xb8,
+    0xcb, 0x1e, 0x75, 0x3e, 0xe9, 0xb1, 0x9c, 0xdb, 0x91, 0xd4, 0x5d, 0xb6, 0xdb, 0x29, 0x2e, 0x18,
+    0x9f, 0x38, 0xb3, 0x2c, 0x21, 0x43, 0x99, 0xc6, 0xa6, 0xc2, 0x76, 0xd9, 0x0e, 0xf0, 0x94, 0x46,
+    0xc9, 0x94, 0xad, 0x25, 0x49, 0x82, 0x62, 0xdd, 0x78, 0x8b, 0xb9, 0x14, 0x64, 0x16, 0x3c, 0x4d,
+    0xa5, 0x1e, 0x75, 0xd9, 0xc3, 0xe2, 0xa2, 0x22, 0xc0, 0xe6, 0x82, 0x24, 0xd1, 0xc1, 0x1f, 0xd1,
+    0x6c, 0x77, 0x6c, 0xce, 0x84, 0x5d, 0xe6, 0xc8, 0x1e, 0xe1, 0x0f, 0x39, 0xa2, 0x54, 0x22, 0x35,
+    0x31, 0xca, 0x80, 0xda, 0xb5, 0x4e, 0xe7, 0xb3, 0x4e, 0x02, 0x47, 0x93, 0x89, 0x2d, 0x71, 0xa3,
+    0x30, 0x52, 0x3b, 0x61, 0x89, 0x13, 0xfd, 0x6a, 0xb1, 0xee, 0xee, 0xee, 0x92, 0xbb, 0x93, 0x42,
+    0x19, 0x9e, 0x3e, 0x33, 0x36, 0x07, 0x62, 0xe3, 0xe4, 0xce, 0xdc, 0x49, 0x27, 0x2e, 0xdc, 0x36,
+    0x57, 0x72, 0x04, 0xdb, 0x89, 0x68, 0xa4, 0xad, 0x15, 0x9c, 0x0c, 0xa7, 0xe8, 0x9e, 0x0b, 0x39,
+    0x1a, 0xbb, 0x2e, 0x78, 0xaf, 0x52, 0x24, 0x9e, 0x4c, 0x9c, 0x33, 0xba, 0x25, 0xae, 0xc3, 0x1e,
+    0x54, 0xce, 0xc2, 0xb1, 0x11, 0xb9, 0xb3, 0x4a, 0x6a, 0xc3, 0x5d, 0x07, 0xa6, 0x1f, 0xd7, 0x89,
+    0xec, 0xc7, 0x35, 0x16, 0x30, 0xa3, 0x88, 0x8c, 0x07, 0x98, 0xf8, 0x93, 0x26, 0xed, 0xf0, 0xea,
+    0xf5, 0x53, 0x79, 0xc6, 0x64, 0x0a, 0x00, 0x99, 0x79, 0x83, 0x28, 0x29, 0x0b, 0xae, 0x69, 0x1b,
+    0xad, 0xf5, 0x87, 0x31, 0x88, 0x84, 0x1d, 0x20, 0x48, 0x5d, 0x4c, 0x1c, 0x73, 0x97, 0x85, 0x18,
+    0xf8, 0x18, 0x17, 0x9f, 0xb8, 0x70, 0xf5, 0x02, 0x29, 0x3e, 0xcb, 0x27, 0xca, 0xc9, 0x42, 0x01,
+    0xb9, 0x59, 0xa1, 0xbc, 0xda, 0x31, 0xa3, 0x13, 0x25, 0x93, 0xd3, 0x99, 0x36, 0x38, 0x16, 0x84,
+    0xfe, 0xf0, 0x0d, 0xbd, 0xf5, 0xe3, 0x8a, 0x6b, 0xe8, 0xad, 0xeb, 0x93, 0xb2, 0xe8, 0xb1, 0x43,
+    0x63, 0xdd, 0xf5, 0x9f, 0xb6, 0x0b, 0xe6, 0x08, 0x25, 0x12, 0x47, 0xaa, 0x20, 0x3b, 0xa0, 0x05,
+    0x04, 0x8d, 0x01, 0xf2, 0xa0, 0x05, 0x4f, 0xee, 0x49, 0x1b, 0x40, 0xe2, 0x2c, 0x84, 0xe3, 0x00,
+    0xec, 0x0d, 0x51, 0xa3, 0x29, 0x9c, 0x04, 0x8d, 0x67, 0x5c, 0x4d, 0x80, 0xcb, 0x1f, 0xbe, 0xe2,
+    0x67, 0x9a, 0x05, 0x39, 0x2f, 0x0a, 0x81, 0x50, 0xd3, 0x61, 0x3f, 0xae, 0x58, 0x6e, 0xf0, 0xe6,
+    0x4e, 0xe6, 0x60, 0xf4, 0xab, 0x4b, 0x51, 0x3a, 0xc1, 0xb2, 0xeb, 0xbf, 0x6c, 0xe9, 0x6e, 0x65,
+    0x2e, 0xe5, 0x4f, 0xc0, 0x7b, 0xe8, 0x88, 0x6b, 0x05, 0x77, 0x5c, 0x99, 0x8e, 0x2b, 0x88, 0x34,
+    0xd6, 0x1f, 0x3f, 0x01, 0x34, 0x35, 0x41, 0xc3, 0x72, 0xa1, 0xaa, 0xac, 0x13, 0xe5, 0xec, 0x10,
+    0xd6, 0x64, 0x2c, 0x94, 0xe5, 0x98, 0x5e, 0x48, 0xb8, 0x15, 0xaa, 0x14, 0xb3, 0xad, 0xeb, 0xdf,
+    0x75, 0x6a, 0x85, 0x9b, 0xbd, 0x1f, 0x41, 0x3e, 0x66, 0x2f, 0xcf, 0xb9, 0x4e, 0x15, 0x14, 0x4a,
+    0xb5, 0x11, 0x83, 0x48, 0x0f, 0x97, 0xb5, 0x02, 0x2a, 0x6e, 0x54, 0x4f, 0x2b, 0x1f, 0x19, 0x6a,
+    0x74, 0xc4, 0x64, 0x5a, 0x0b, 0x12, 0x04, 0xb9, 0x56, 0xf6, 0x68, 0xcf, 0x8a, 0xb3, 0x27, 0x4e,
+    0xfb, 0xf3, 0x54, 0xae, 0x48, 0xc0, 0x16, 0xab, 0x5f, 0x5e, 0x67, 0x19, 0x74, 0x1f, 0xb6, 0xcd,
+    0x0e, 0x3e, 0xff, 0x62, 0x1f, 0xd2, 0xb2, 0xae, 0xf8, 0x8f, 0x13, 0x28, 0x0d, 0x80, 0x99, 0x95,
+    0x23, 0x31, 0xcf, 0x78, 0x1b, 0x70, 0x23, 0x21, 0x75, 0x66, 0xd0, 0xb2, 0x1a, 0x73, 0x2d, 0xf5,
+    0x1a, 0xd0, 0xff, 0xbf, 0xd5, 0x6f, 0x36, 0xea, 0x5f, 0x5d, 0x7f, 0xc4, 0x24, 0xad, 0x5b, 0xb2,
+    0xa2, 0xa5, 0xbd, 0xce, 0x0d, 0x3a, 0x4e, 0xa5, 0x03, 0xd1, 0x99, 0x97, 0x59, 0x5d, 0x65, 0xad,
+    0x40, 0xd4, 0x3c, 0x54, 0xc2, 0x08, 0x80, 0xee, 0xce, 0xa7, 0x50, 0x79, 0x2d, 0xa3, 0xa4, 0x4e,
+    0xc5, 0x05, 0x22, 0xfb, 0x4b, 0x60, 0xb1, 0x46, 0x41, 0xef, 0xd2, 0x42, 0xdd, 0x54, 0x58, 0x26,
+    0x56, 0x16, 0x00, 0x0e, 0x05, 0x56, 0xb6, 0x1c, 0x60, 0x03, 0xe6, 0xc7, 0x7e, 0xaf, 0xbd, 0x5d,
+    0xbb, 0x32, 0x60, 0x9d, 0x9e, 0x97, 0x18, 0x0d, 0x4d, 0x16, 0x7d, 0x82, 0xf7, 0x9d, 0x0e, 0xec,
+    0x64, 0x13, 0x9d, 0x10, 0x2a, 0x6b, 0xc5, 0xd0, 0x27, 0x94, 0x49, 0x38, 0x6e, 0x45, 0x56, 0x14,
+    0x8a, 0x27, 0x22, 0xd8, 0x88, 0x89, 0x18, 0xc1, 0x7d, 0xb1, 0x11, 0xf6, 0xa6, 0xf3, 0x33, 0x4d,
+    0x04, 0x0b, 0x0a, 0x9d, 0x21, 0x45, 0x20, 0xc1, 0x33, 0x8d, 0xca, 0x97, 0x40, 0x88, 0x72, 0x7e,
+    0x11, 0x74, 0x1a, 0x32, 0x7b, 0xff, 0x9e, 0x75, 0xc2, 0xca, 0x40, 0x2c, 0x48, 0x60, 0x4a, 0x4d,
+    0x32, 0xc9, 0xc1, 0xd0, 0x68, 0x24, 0xdc, 0xbe, 0x12, 0xb8, 0x7c, 0x72, 0xf9, 0x22, 0x0d, 0xaa,
+    0x82, 0x0d, 0x23, 0xaa, 0x97, 0xea, 0xc4, 0xc4, 0x2a, 0xf2, 0x10, 0x3a, 0x30, 0xe2, 0xff, 0x31,
+    0x2a, 0x1e, 0xf8, 0x90, 0x26, 0xa1, 0x13, 0x93, 0x8a, 0x37, 0x5f, 0xbf, 0x78, 0x6a, 0xf2, 0xc2,
+    0x68, 0x10, 0x41, 0x46, 0x85, 0x40, 0xf2, 0xd7, 0x2b, 0xcd, 0xc4, 0x67, 0x9a, 0xbc, 0xfa, 0xeb,
+    0x4a, 0xe6, 0xb2, 0xda, 0xc4, 0x78, 0xf4, 0x3c, 0x99, 0xb1, 0x00, 0x35, 0x86, 0xa4, 0x65, 0x13,
+    0xd4, 0xac, 0xe3, 0x2b, 0x71, 0xe0, 0x02, 0x62, 0x25, 0x5c, 0x32, 0x0e, 0x80, 0x1a, 0x7a, 0x11,
+    0x54, 0x85, 0x0e, 0xac, 0x28, 0x0b, 0x36, 0x18, 0x32, 0x7c, 0x46, 0xef, 0x4a, 0xa3, 0x83, 0xb0,
+    0x21, 0xa5, 0x1c, 0xee, 0x50, 0x20, 0x5d, 0x79, 0x8b, 0xd9, 0xc1, 0xfd, 0x08, 0x4d, 0xeb, 0x79,
+    0xcb, 0xf9, 0x21, 0x52, 0x65, 0x60, 0x1d, 0x9f, 0xb1, 0x39, 0xd7, 0x0d, 0x01, 0x38, 0xad, 0x14,
+    0x65, 0xa4, 0x84, 0x1e, 0xe1, 0xe9, 0x5b, 0xa3, 0x36, 0x2b, 0x83, 0x30, 0x42, 0x28, 0x3e, 0x05,
+    0x1c, 0x01, 0x8d, 0x0d, 0xbc, 0xa0, 0x92, 0xf7, 0x98, 0x05, 0x2d, 0x4d, 0xe0, 0xdc, 0x0e, 0x45,
+    0xe9, 0xef, 0x9f, 0x3f, 0xa0, 0xa7, 0x4b, 0x34, 0x3a, 0x12, 0xb2, 0x2e, 0xf3, 0x3b, 0x3e, 0xb1,
+    0x31, 0x9e, 0x31, 0xe4, 0x23, 0x36, 0x67, 0x1c, 0x57, 0x77, 0x99, 0x52, 0x97, 0x7c, 0x08, 0x57,
+    0x66, 0x89, 0x2d, 0x22, 0x5d, 0x74, 0x93, 0x0d, 0x08, 0x95, 0xb7, 0x9e, 0x6f, 0x6a, 0xf6, 0xd6,
+    0xf3, 0xb5, 0x81, 0x6c, 0x38, 0x68, 0x19, 0x84, 0x10, 0xab, 0x43, 0x77, 0xb7, 0x78, 0xba, 0xa1,
+    0x96, 0xa2, 0xd4, 0x2e, 0xa6, 0x2a, 0x0b, 0x55, 0xdf, 0xbb, 0x03, 0xa6, 0x55, 0x3b, 0x04, 0x4c,
+    0xd3, 0x22, 0x92, 0x5a, 0x0b, 0xfb, 0xfc, 0xe8, 0xe5, 0x57, 0x88, 0x54, 0xbf, 0xc2, 0x55, 0x1b,
+    0x03, 0xf7, 0x06, 0x54, 0xa3, 0x58, 0x27, 0x04, 0xe9, 0x62, 0x51, 0xe9, 0xac, 0xea, 0xe2, 0xb7,
+    0x6f, 0xe3, 0xd1, 0x16, 0xdb, 0x88, 0x37, 0xc2, 0xd6, 0x5e, 0xbc, 0x79, 0x3f, 0x86, 0x4d, 0xd8,
+    0x2b, 0x0b, 0x25, 0x5d, 0x80, 0xe4, 0x9e, 0x37, 0x29, 0xa2, 0xc2, 0x14, 0x41, 0x5d, 0x57, 0x93,
+    0xa2, 0x06, 0x1b, 0x6c, 0x57, 0x70, 0x61, 0x43, 0xb6, 0x03, 0x89, 0x87, 0xf7, 0x77, 0x30, 0x9d,
+    0xd0, 0x21, 0xcc, 0x29, 0x76, 0x8a, 0x65, 0xa3, 0x01, 0xf8, 0xc7, 0x7d, 0xea, 0xfc, 0x30, 0x3a,
+    0x25, 0x8a, 0x97, 0x25, 0x4c, 0x87, 0xd2, 0xae, 0xe8, 0x9b, 0x1b, 0xf7, 0xaf, 0x2a, 0x4d, 0xd3,
+    0x0d, 0xe8, 0x57, 0x51, 0xc4, 0x02, 0x53, 0xc0, 0xdd, 0xe8, 0xe8, 0xb2, 0x48, 0x87, 0xb4, 0xba,
+    0x63, 0xe1, 0xd1, 0x05, 0x73, 0xdc, 0xf3, 0xa6, 0xde, 0x02, 0xc0, 0x33, 0x63, 0xf7, 0x39, 0xd4,
+    0x99, 0xa8, 0xca, 0x07, 0x1d, 0x92, 0xd0, 0xb7, 0xc0, 0x1d, 0x11, 0xc9, 0x12, 0x14, 0x83, 0x23,
+    0xfe, 0x3f, 0x7f, 0x7c, 0xf8, 0xc5, 0x47, 0x17, 0x60, 0xf1, 0x6b, 0xdd, 0xef, 0x78, 0xd5, 0x94,
+    0x5a, 0x7c, 0xde, 0xf1, 0x8d, 0xf1, 0xa1, 0x65, 0xbc, 0xa0, 0x3a, 0x24, 0xe3, 0xaf, 0x7f, 0x3b,
+    0xd1, 0xb3, 0x1e, 0x7b, 0xcc, 0xba, 0x70, 0x90, 0xb3, 0xb1, 0x15, 0xd9, 0x00, 0x7a, 0x0d, 0x20,
+    0x09, 0x4f, 0x55, 0xcd, 0x06, 0x8e, 0xdd, 0x6c, 0x35, 0x95, 0xa4, 0x70, 0xea, 0x33, 0x07, 0xf3,
+    0x14, 0xb6, 0x9a, 0x1f, 0x4e, 0x60, 0xae, 0x3e, 0xf5, 0x87, 0x7b, 0xf5, 0xe1, 0x7e, 0xcc, 0x57,
+    0xcc, 0x32, 0x29, 0xdc, 0xf0, 0x4e, 0xd0, 0x2c, 0xb3, 0x68, 0xcf, 0xa1, 0xc2, 0x2b, 0xba, 0xb1,
+    0x67, 0x75, 0x92, 0xbc, 0xe5, 0x2c, 0xa1, 0x84, 0x59, 0x80, 0x28, 0x65, 0x10, 0x1f, 0x9a, 0xb4,
+    0xa6, 0xad, 0xec, 0xb5, 0xb9, 0x8e, 0x57, 0x45, 0xe3, 0x18, 0x8f, 0xc1, 0x91, 0xe1, 0xfd, 0x2b,
+    0x8c, 0xfb, 0x94, 0x21, 0x4d, 0xf3, 0x5c, 0x4c, 0xe7, 0xb9, 0x5d, 0x50, 0x85, 0x7a, 0x44, 0x84,
+    0xb7, 0xd9, 0x12, 0x07, 0x8d, 0x43, 0x58, 0x8d, 0x20, 0xee, 0x96, 0xb3, 0x2f, 0x71, 0xaa, 0x22,
+    0x43, 0x21, 0x0a, 0x8b, 0x5c, 0x55, 0x3a, 0xa7, 0x2d, 0xac, 0x78, 0x08, 0x96, 0xb0, 0xfe, 0xcf,
+    0x6f, 0xa1, 0x56, 0x14, 0xab, 0x9e, 0x7f, 0x45, 0x35, 0x77, 0x0f, 0x8c, 0xcf, 0xa4, 0xcd, 0x03,
+    0x1f, 0xa3, 0xc9, 0x30, 0x10, 0xfa, 0xb1, 0x1f, 0x86, 0xd0, 0xad, 0xdd, 0xc4, 0xea, 0xa6, 0x9d,
+    0x43, 0x82, 0xe9, 0xfc, 0x7f, 0xdf, 0x25, 0x4d, 0x6b, 0x87, 0x4b, 0x12, 0x90, 0xf9, 0xdf, 0xd3,
+    0x43, 0xb8, 0x68, 0x66, 0x7b, 0x70, 0x6d, 0x70, 0x4d, 0x23, 0xf1, 0x1d, 0xad, 0x65, 0x3e, 0x1d,
+    0x87, 0x55, 0x23, 0xb9, 0x47, 0x47, 0xe8, 0xbb, 0xa2, 0xb9, 0x0a, 0x1a, 0x87, 0x18, 0x57, 0xc2,
+    0xba, 0xc0, 0xff, 0xe6, 0xfa, 0xa3, 0x1a, 0xa1, 0xbb, 0x7e, 0xdd, 0x0e, 0x32, 0xfc, 0xce, 0x18,
+    0x30, 0x2d, 0xce, 0x71, 0x7a, 0xca, 0xf7, 0xa0, 0xd8, 0xb0, 0x53, 0xe0, 0x76, 0x84, 0xe1, 0xd7,
+    0x4d, 0x2b, 0xdc, 0x6a, 0xf7, 0xa1, 0xb0, 0xc7, 0x18, 0x8b, 0x63, 0xf6, 0x0c, 0x46, 0x48, 0x0a,
+    0x9e, 0xd5, 0x02, 0x3e, 0xe6, 0x84, 0x85, 0x6f, 0x23, 0x81, 0x83, 0x8c, 0x15, 0x80, 0x09, 0x0b,
+    0xd1, 0xcf, 0x19, 0x80, 0x4d, 0x9c, 0xc2, 0x78, 0xe4, 0xa4, 0x62, 0x87, 0x7b, 0x28, 0x99, 0x05,
+    0xe4, 0x1f, 0x4d, 0x1d, 0xf0, 0xe8, 0xb3, 0x9b, 0x76, 0xc3, 0xfe, 0xe6, 0x26, 0x46, 0x62, 0xc1,
+    0x10, 0xc2, 0xeb, 0x56, 0x9b, 0xfd, 0x3b, 0xf9, 0x7d, 0x15, 0xc8, 0x3a, 0x5d, 0x55, 0x1c, 0xef,
+    0x4c, 0x57, 0xdb, 0x8d, 0x2d, 0x76, 0x05, 0xdf, 0xb3, 0x63, 0x03, 0xdf, 0x70, 0xfe, 0xc1, 0xeb,
+    0xc3, 0x23, 0x10, 0x8e, 0xc5, 0xd4, 0xa5, 0xb0, 0x4c, 0x17, 0x73, 0x7a, 0x55, 0xeb, 0xa5, 0x89,
+    0xa3, 0x6a, 0xdf, 0xab, 0xf2, 0x0c, 0xa1, 0xa9, 0x20, 0x78, 0x0e, 0x73, 0x91, 0x39, 0x8f, 0x0c,
+    0x95, 0x38, 0xf0, 0x2f, 0x22, 0x03, 0x9b, 0x7c, 0x0f, 0xe7, 0xf8, 0x7a, 0x54, 0x83, 0x82, 0xae,
+    0xc7, 0x65, 0xfa, 0xfe, 0xfe, 0x17, 0xbd, 0xd0, 0x73, 0x6b, 0x8f, 0x0f, 0x00, 0x00,
+};
+
+// opsaetning.css: 496 -> 291 bytes
+static const uint8_t webgz_opsaetning_css[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x75, 0x90, 0x41, 0x4f, 0x84, 0x30,
+    0x10, 0x85, 0xef, 0xfe, 0x8a, 0x66, 0xf7, 0x0c, 0x81, 0x35, 0xac, 0x0a, 0xf1, 0xe0, 0xef, 0x30,
+    0x1e, 0x5a, 0x3a, 0xc0, 0x64, 0x87, 0xb6, 0x81, 0x22, 0xa0, 0xf1, 0xbf, 0x3b, 0x85, 0x74, 0x83,
+    0x07, 0x8f, 0x7d, 0xf3, 0xe6, 0x9b, 0xf7, 0xaa, 0xac, 0x5e, 0xc5, 0xb7, 0x68, 0xac, 0xf1, 0x49,
+    0x23, 0x7b, 0xa4, 0xb5, 0x14, 0x6f, 0x03, 0x4a, 0xaa, 0x44, 0x2f, 0x97, 0x64, 0x46, 0xed, 0xbb,
+    0x52, 0x3c, 0x5d, 0x33, 0xb7, 0x04, 0x65, 0x68, 0xd1, 0x94, 0x42, 0x4e, 0xde, 0x56, 0xe2, 0xe7,
+    0xa1, 0xcb, 0x79, 0xd5, 0xc3, 0xe2, 0x13, 0x49, 0xd8, 0xf2, 0xa0, 0x06, 0xe3, 0x61, 0x08, 0xa3,
+    0x74, 0x24, 0xd4, 0x30, 0x24, 0x8a, 0x6c, 0x7d, 0x63, 0x57, 0x5c, 0xcd, 0x9f, 0xdd, 0x22, 0xb2,
+    0xe0, 0x20, 0xa9, 0x80, 0xc2, 0x04, 0x4d, 0x3c, 0x73, 0xc9, 0xb7, 0x33, 0x1a, 0x47, 0x47, 0x92,
+    0x83, 0xa0, 0x21, 0x34, 0xb0, 0x33, 0x36, 0xe8, 0xa7, 0xa4, 0x09, 0x62, 0xdc, 0x19, 0xb0, 0xed,
+    0x7c, 0x29, 0x94, 0x25, 0x1d, 0xb3, 0x25, 0x04, 0x0d, 0x4b, 0xf9, 0x35, 0x70, 0x78, 0xa1, 0xb7,
+    0x1a, 0xfe, 0xcd, 0xe0, 0xa4, 0xd6, 0x68, 0x5a, 0x16, 0xb6, 0xb3, 0xca, 0x0e, 0x21, 0xb1, 0xb7,
+    0x8e, 0x15, 0x76, 0x8c, 0x96, 0x2b, 0x88, 0x33, 0x00, 0xec, 0x85, 0xa0, 0xed, 0xb9, 0x5e, 0xa2,
+    0xec, 0xc2, 0xac, 0xdd, 0xfc, 0xc7, 0xa8, 0xb5, 0x3e, 0x32, 0x2f, 0xc7, 0x1f, 0x0b, 0xaf, 0xbd,
+    0x76, 0xda, 0xa1, 0xf1, 0xb1, 0xc2, 0x88, 0x5f, 0x50, 0x8a, 0x2c, 0x7d, 0x81, 0xbe, 0x12, 0xb5,
+    0x25, 0xcb, 0xc4, 0x73, 0x51, 0x14, 0xf7, 0x3a, 0x5b, 0x98, 0x58, 0x66, 0x06, 0xb8, 0x69, 0xb9,
+    0x8e, 0xc7, 0x2a, 0x59, 0xe4, 0xa2, 0x71, 0x93, 0x7f, 0xf7, 0xab, 0x83, 0xd7, 0x93, 0x99, 0x7a,
+    0x05, 0xc3, 0xe9, 0x83, 0x8d, 0xf7, 0x3c, 0x8f, 0x1b, 0xe4, 0x17, 0x05, 0x03, 0x2d, 0x09, 0xef,
+    0x01, 0x00, 0x00,
+};
+
+// opsaetning.js: 1902 -> 807 bytes
+static const uint8_t webgz_opsaetning_js[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x55, 0xcd, 0x6e, 0xdc, 0x36,
+    0x10, 0xbe, 0xeb, 0x29, 0xa6, 0x46, 0x00, 0x52, 0xf5, 0xae, 0xf6, 0xa7, 0xe8, 0x65, 0x17, 0x0b,
+    0x23, 0x35, 0x7c, 0x30, 0x90, 0x02, 0x41, 0x93, 0xf4, 0xb2, 0xde, 0x1a, 0xac, 0x38, 0xab, 0x55,
+    0x44, 0x91, 0x2a, 0x49, 0xc9, 0x36, 0x62, 0x03, 0x3d, 0xe5, 0x01, 0xfa, 0x10, 0x7e, 0x91, 0xbc,
+    0x49, 0x9e, 0xa4, 0x43, 0x49, 0x1b, 0x7b, 0x61, 0x05, 0xd9, 0x83, 0x80, 0x21, 0x67, 0xbe, 0x8f,
+    0xf3, 0xf3, 0x91, 0xda, 0xd6, 0x3a, 0xf5, 0xb9, 0xd1, 0x90, 0x6b, 0x89, 0xb7, 0x3c, 0x86, 0x4f,
+    0xa0, 0x4c, 0x2a, 0xc2, 0x56, 0x62, 0xb1, 0x52, 0x22, 0x45, 0xce, 0x26, 0xad, 0x33, 0xd9, 0xf9,
+    0x92, 0xc5, 0x4b, 0x78, 0x88, 0xb6, 0x7b, 0x50, 0x69, 0x24, 0xbe, 0xb5, 0xd8, 0xe4, 0x78, 0x73,
+    0xbe, 0x13, 0x3a, 0x43, 0xc9, 0x1b, 0xa1, 0x88, 0x24, 0x1a, 0x20, 0x31, 0x95, 0x13, 0xe8, 0x75,
+    0xae, 0xb3, 0xc0, 0x74, 0x56, 0x75, 0xb8, 0xdf, 0x89, 0x62, 0xc5, 0xe0, 0x14, 0x50, 0xa7, 0x64,
+    0x7e, 0xf8, 0xe3, 0xf2, 0xdc, 0x94, 0x95, 0xd1, 0xa8, 0x7d, 0xcb, 0x15, 0x2f, 0xa3, 0x67, 0x07,
+    0xd6, 0x95, 0x14, 0x1e, 0xff, 0x14, 0xaa, 0x46, 0x17, 0x92, 0x8d, 0xa4, 0x49, 0xeb, 0x92, 0x62,
+    0x93, 0x0c, 0xfd, 0x85, 0xc2, 0x60, 0xfe, 0x76, 0x77, 0x29, 0x39, 0x23, 0xec, 0x75, 0x75, 0x53,
+    0x0a, 0x16, 0x27, 0x1e, 0x6f, 0xfd, 0xb9, 0xd1, 0x9e, 0x7c, 0xb0, 0x82, 0xb0, 0x99, 0x34, 0x81,
+    0x61, 0xf9, 0x43, 0x74, 0x3a, 0x84, 0x4e, 0x8f, 0x45, 0xe3, 0x10, 0x1a, 0x8f, 0x45, 0x67, 0x43,
+    0xe8, 0xec, 0x28, 0xb4, 0xaa, 0x6f, 0x9d, 0x17, 0xd6, 0xbf, 0x60, 0xd8, 0x3b, 0x8e, 0x62, 0x91,
+    0xa8, 0xc4, 0xdd, 0x0b, 0x8a, 0x76, 0xf7, 0x28, 0xbc, 0xf3, 0x58, 0x6d, 0x2d, 0x16, 0x0d, 0x6a,
+    0xf7, 0x82, 0xe6, 0xb9, 0x73, 0xcf, 0xf6, 0x10, 0x1d, 0x8e, 0x77, 0x19, 0x4d, 0x26, 0xf0, 0x3e,
+    0x57, 0xea, 0xcb, 0x63, 0xe6, 0x1c, 0x66, 0x81, 0x1e, 0xed, 0x02, 0x4e, 0xe6, 0xf3, 0xc5, 0x74,
+    0x7a, 0x02, 0x5f, 0x3f, 0xff, 0x17, 0x6c, 0x32, 0x47, 0x70, 0xe2, 0x8c, 0xd2, 0x28, 0x33, 0x12,
+    0xe1, 0xe9, 0xec, 0xd7, 0xde, 0xe7, 0xc8, 0xea, 0x5c, 0xa6, 0x0a, 0x9e, 0xf1, 0x2f, 0x7b, 0x94,
+    0x0d, 0xe6, 0x93, 0xac, 0x88, 0xfc, 0xbd, 0x29, 0x50, 0xf3, 0x26, 0x68, 0xaa, 0xa1, 0xfc, 0x9a,
+    0xc4, 0xdb, 0xbc, 0xe4, 0x94, 0xb6, 0x79, 0x63, 0x6e, 0xd0, 0x9e, 0x0b, 0x87, 0x21, 0xa3, 0x46,
+    0x58, 0x28, 0x5b, 0x7f, 0x29, 0x7c, 0xba, 0xe3, 0x93, 0xbf, 0xf8, 0x95, 0xfc, 0x34, 0x1b, 0xcd,
+    0x1f, 0xe2, 0xf5, 0x22, 0xd9, 0x84, 0x05, 0x99, 0xaf, 0x26, 0x14, 0x9a, 0x6f, 0x81, 0x97, 0x31,
+    0x58, 0xf4, 0xb5, 0xd5, 0xc0, 0xd9, 0x34, 0xa8, 0xbc, 0x5c, 0xcf, 0x36, 0x71, 0xe2, 0x54, 0x4e,
+    0x57, 0x62, 0x3c, 0x8f, 0xdb, 0x9d, 0xf9, 0x66, 0x19, 0x1d, 0x72, 0x52, 0xc6, 0xbc, 0xaf, 0xe6,
+    0xbe, 0x4b, 0x3d, 0xbe, 0x72, 0x3f, 0xf3, 0xf5, 0xe9, 0x78, 0x73, 0x25, 0x4f, 0xe3, 0xb3, 0x21,
+    0xfe, 0xc0, 0x0c, 0xab, 0x15, 0xb0, 0x1e, 0xc8, 0xe0, 0x0c, 0x98, 0x63, 0xb0, 0x00, 0x66, 0x59,
+    0x38, 0x88, 0x87, 0x93, 0x68, 0xb3, 0x12, 0xd6, 0xe1, 0x25, 0x5d, 0xaf, 0xb0, 0x1e, 0xc1, 0x6c,
+    0x1a, 0x87, 0x18, 0xba, 0xd9, 0x51, 0x4f, 0xa5, 0x6b, 0xa5, 0xc2, 0x34, 0xa8, 0xfb, 0x6f, 0x45,
+    0x01, 0x7d, 0xe7, 0xc7, 0xf6, 0xcb, 0x63, 0x51, 0xa0, 0xd5, 0x08, 0x39, 0xa9, 0xc0, 0x83, 0x2b,
+    0x3e, 0xd6, 0xca, 0x23, 0x6c, 0x51, 0x79, 0x6a, 0x32, 0x66, 0xee, 0x64, 0x01, 0x74, 0xe3, 0x4b,
+    0xe1, 0x8a, 0x44, 0xe7, 0x0d, 0x8a, 0x3a, 0xe9, 0xd4, 0xe6, 0x54, 0xed, 0xaf, 0xbf, 0xfe, 0xfb,
+    0x08, 0xbc, 0xe7, 0x80, 0x5a, 0x22, 0x75, 0x3d, 0x38, 0x27, 0xc1, 0x19, 0xd6, 0x4a, 0x48, 0x74,
+    0xf1, 0xd3, 0x4c, 0x2a, 0x91, 0x16, 0xef, 0xba, 0xa3, 0xbb, 0xab, 0x1e, 0x5a, 0x6f, 0xea, 0x56,
+    0x83, 0xdf, 0x93, 0x5d, 0x48, 0x82, 0xf5, 0xad, 0xf9, 0x89, 0x62, 0xf7, 0xdd, 0xe9, 0xe6, 0x66,
+    0xcd, 0x8d, 0x23, 0xf4, 0x7a, 0xf3, 0x4c, 0xb8, 0xff, 0xd4, 0x68, 0xef, 0xde, 0xa1, 0xc2, 0xd4,
+    0x1b, 0xfb, 0x5a, 0x29, 0xce, 0x12, 0x22, 0x19, 0x53, 0x28, 0x49, 0x76, 0x6b, 0xec, 0x85, 0xa0,
+    0x81, 0x7c, 0xcb, 0x89, 0xdb, 0x7d, 0x22, 0x81, 0xe8, 0x9b, 0x6a, 0xec, 0x21, 0x4d, 0xcf, 0xb1,
+    0xbf, 0x82, 0xad, 0xba, 0x7b, 0xe9, 0xe0, 0x8f, 0x61, 0xa8, 0xe5, 0x33, 0x50, 0xa8, 0x84, 0xce,
+    0xa2, 0xb9, 0x86, 0xa9, 0xc0, 0xfd, 0x7d, 0xa0, 0xe8, 0x57, 0x87, 0xd5, 0x85, 0xb6, 0x13, 0xfb,
+    0x94, 0xc6, 0xf8, 0xbd, 0xaa, 0xa4, 0xb8, 0x5b, 0xa4, 0x3b, 0x4c, 0x0b, 0x94, 0x83, 0xd5, 0xc9,
+    0xf0, 0xfc, 0xb7, 0x3c, 0xf7, 0xab, 0x27, 0x99, 0xc8, 0x2e, 0x99, 0x56, 0x29, 0xf4, 0xfa, 0x07,
+    0x9d, 0x50, 0x23, 0x93, 0xaa, 0x76, 0x3b, 0xbe, 0x1e, 0xae, 0xc1, 0x68, 0xe2, 0xef, 0x4f, 0x22,
+    0xc5, 0xcd, 0x48, 0x60, 0xd3, 0x51, 0xcb, 0x3c, 0x8a, 0x86, 0x11, 0x0a, 0x1b, 0x54, 0xfb, 0xba,
+    0xfb, 0xbb, 0x37, 0x02, 0x37, 0x02, 0xdc, 0x24, 0x1f, 0x4d, 0xae, 0x29, 0x8c, 0xb5, 0xff, 0x02,
+    0xfa, 0x68, 0xb0, 0x5d, 0x1c, 0x95, 0xdb, 0xa6, 0xd2, 0x05, 0x5c, 0xb3, 0xf6, 0x5f, 0x31, 0x3c,
+    0x5a, 0xce, 0xa8, 0x5c, 0xfa, 0x7d, 0x25, 0x42, 0xca, 0x0b, 0x7a, 0x74, 0xfc, 0x9b, 0x9c, 0x9e,
+    0x20, 0x8d, 0xe4, 0x70, 0xf5, 0xdf, 0x65, 0xee, 0xd9, 0xe8, 0x40, 0x71, 0xf1, 0xf2, 0x7f, 0x14,
+    0xb8, 0xf0, 0x34, 0x1a, 0x07, 0x00, 0x00,
+};
+
+enum WebStaticId : uint8_t {
+    WEBSTATIC_INDEX_HTM,
+    WEBSTATIC_FILEBROWSER_HTM,
+    WEBSTATIC_OPSAETNING_CSS,
+    WEBSTATIC_OPSAETNING_JS,
+    WEBSTATIC_COUNT
+};
+
+static const WebStaticFile webStaticFiles[WEBSTATIC_COUNT] = {
+    { "/index.htm", "text/html; charset=utf-8", webgz_index_htm, 2111, 6107, "\"8664b5db\"" },
+    { "/filebrowser.htm", "text/html; charset=utf-8", webgz_filebrowser_htm, 1726, 4472, "\"5e05f752\"" },
+    { "/opsaetning.css", "text/css; charset=utf-8", webgz_opsaetning_css, 291, 496, "\"e3e5e007\"" },
+    { "/opsaetning.js", "application/javascript; charset=utf-8", webgz_opsaetning_js, 807, 1902, "\"107cfe5a\"" },
+};
@@ -0,0 +1,57 @@
+#pragma once
+/**
+ * @file WebTemplate.h
+ * @brief Streamende HTML-template renderer (ingen String, ingen replace()).
+ *
+ * Templaten er en const char[] (ligger i flash på RP2040) med pladsholdere
+ * på formen %NAVN% (A-Z, 0-9, _). Den gennemløbes én gang: tekst mellem
+ * pladsholdere skrives direkte til en Print, og for hver pladsholder kaldes
+ * fill(out, navn), som skriver værdien (eller en under-template) selv.
+ *
+ * Et '%' der ikke efterfølges af NAVN% skrives uændret (fx "PwmA (%):").
+ *
+ * Content-Length: render først til WebCountingPrint (tæller kun bytes),
+ * derefter til klienten – samme fill giver samme output begge gange.
+ */
+
+#include <Arduino.h>
+#include <cstdint>
+
+#include "HttpRequest.h"
+
+/** Print der kun tæller bytes (bruges til Content-Length før selve afsendelsen). */
+class WebCountingPrint : public Print {
+public:
+    size_t count = 0;
+    size_t write(uint8_t) override { count++; return 1; }
+    size_t write(const uint8_t*, size_t n) override { count += n; return n; }
+};
+
+namespace webtemplate {
+inline bool isNameChar(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+}
+
+/**
+ * @brief Render tpl til out.
+ * @param fill Kaldes som fill(Print& out, const HttpSlice& navn) for hver pladsholder.
+ */
+template <typename Fill>
+void webTemplateRender(Print& out, const char* tpl, Fill& fill) {
+    const char* run = tpl;      // Start af uskrevet tekst
+    const char* p = tpl;
+    while (*p) {
+        if (*p != '%') { p++; continue; }
+
+        const char* n = p + 1;
+        while (webtemplate::isNameChar(*n)) n++;
+        if (*n != '%' || n == p + 1) { p++; continue; }   // Ikke en pladsholder
+
+        if (p > run) out.write((const uint8_t*)run, p - run);
+        HttpSlice name{p + 1, (uint16_t)(n - p - 1)};
+        fill(out, name);
+        p = run = n + 1;
+    }
+    if (p > run) out.write((const uint8_t*)run, p - run);
+}
@@ -0,0 +1,106 @@
+#pragma once
+/**
+ * @file WebTxBuffer.h
+ * @brief Samlende TX-buffer til HTTP-svar (én TCP MSS).
+ *
+ * Alle svar fra WebServerHandler skrives gennem WebTxBuffer i stedet for
+ * direkte til WiFiClient. Headere og body samles i en fast buffer på
+ * WEB_TX_BUF bytes og sendes først når bufferen er fuld eller svaret er
+ * færdigt (flush). Derved bliver fx /status.htm ét TCP-segment i stedet
+ * for en stribe små print()-pakker.
+ *
+ * Store writes (fx fil-download) går uden om bufferen i hele segmenter.
+ *
+ * Tællere (stats) viser effekten: antal svar, bytes og socket-writes, samt
+ * et estimat af antal segmenter (ceil(bytes / MSS) pr. write).
+ */
+
+#include <WiFi.h>
+#include <Arduino.h>
+#include <cstdint>
+#include <cstring>
+
+#ifndef WEB_TX_BUF
+#define WEB_TX_BUF 1460     // lwIP TCP_MSS på Pico W
+#endif
+
+struct WebTxStats {
+    uint32_t responses = 0;     // Antal afsluttede svar (end())
+    uint32_t bytes = 0;         // Bytes sendt til socket
+    uint32_t writes = 0;        // WiFiClient::write() kald
+    uint32_t segments = 0;      // Estimerede TCP-segmenter
+};
+
+class WebTxBuffer : public Print {
+public:
+    WebTxStats stats;
+
+    /** Bind bufferen til en forbindelse – kaldes før hvert svar. */
+    void begin(WiFiClient& c) {
+        cl = &c;
+        len = 0;
+        failed = false;
+    }
+
+    /** Svar færdigt: send resten og tæl svaret. */
+    void end() {
+        flush();
+        stats.responses++;
+    }
+
+    /** Underliggende socket (til læsning af request-body, fx upload). */
+    WiFiClient& client() { return *cl; }
+
+    /** false hvis en socket-write er fejlet siden begin(). */
+    bool ok() const { return !failed; }
+
+    size_t write(uint8_t b) override {
+        if (len == WEB_TX_BUF) flush();
+        buf[len++] = b;
+        return 1;
+    }
+
+    size_t write(const uint8_t* p, size_t n) override {
+        size_t done = 0;
+        while (done < n) {
+            size_t left = n - done;
+            if (len == 0 && left >= WEB_TX_BUF) {
+                // Tom buffer og mindst ét helt segment: send direkte uden kopi
+                size_t chunk = left - (left % WEB_TX_BUF);
+                send(p + done, chunk);
+                done += chunk;
+                continue;
+            }
+            size_t k = WEB_TX_BUF - len;
+            if (k > left) k = left;
+            memcpy(buf + len, p + done, k);
+            len += (uint16_t)k;
+            done += k;
+            if (len == WEB_TX_BUF) flush();
+        }
+        return n;
+    }
+
+    using Print::write;
+
+    /** Send det bufferede nu. */
+    void flush() override {
+        if (len == 0 || !cl) return;
+        send(buf, len);
+        len = 0;
+    }
+
+private:
+    WiFiClient* cl = nullptr;
+    uint16_t len = 0;
+    bool failed = false;
+    uint8_t buf[WEB_TX_BUF];
+
+    void send(const uint8_t* p, size_t n) {
+        if (failed) return;
+        if (cl->write(p, n) != n) failed = true;
+        stats.bytes += n;
+        stats.writes++;
+        stats.segments += (n + WEB_TX_BUF - 1) / WEB_TX_BUF;
+    }
+};
@@ -8,69 +8,596 @@
  *   /pir.log       – PIR/HW/SW events (styret af logpirdetection flag).
  *   /hardware.log  – watchdog, I2C-resets, WiFi, astro-data (ALTID aktiv).
  *
- * Alle entries tidsstemples via RTC.
+ * Binær mode (logbinary): events skrives i stedet som 12-byte EventRecord i
+ * /events.bin (ca. 4× mindre end tekstlinjerne). Astro-linjen er fri tekst og
+ * går altid til hardware.log. tools/eventdump.cpp dekoder filen til samme
+ * tekstformat eller CSV.
+ *
+ * Entries tidsstemples med eventets egen UTC-tid (fx fra EventRing) når den
+ * kendes, ellers med RTC ved skrivning. Linjer formateres i en stakbuffer via
+ * eventText() (EventRecord.h) – ingen String pr. event.
+ *
+ * Group commit: filerne holdes åbne, og linjer samles i en RAM-buffer pr. fil
+ * (LYSLOG_BUF, én SD-sektor). En buffer skrives når den er fuld; alle buffere
+ * skrives og sync'es (data + FAT/dir-entry) når ældste ventende linje er
+ * LYSLOG_FLUSH_MS gammel (poll() fra loop()), før reboot, og når flush() kaldes
+ * (fx før download eller hvis core1 ser ud til at hænge, før watchdog slår til).
+ * Tidligere: open + seekEnd (følger hele FAT-kæden) + write + close pr. linje.
+ * Ved strømsvigt kan højst de sidste LYSLOG_FLUSH_MS af log-linjer mistes.
+ *
+ * Rotation: den aktive fil hedder altid det samme (/pir.log osv.). Første linje
+ * i en ny måned (lokal tid) flytter den til /log/YYYY-MM-pir.log, så navnene
+ * sorterer kronologisk. Når filerne i alt fylder mere end setMaxMB(), slettes
+ * ældste arkiv først. Fejler flytningen, fortsætter den aktive fil uden nye
+ * indeks-entries (fejlen tælles), og rotationen prøves igen ved næste dato.
+ *
+ * Dato-indeks: /log/<navn>.idx er LogIndexEntry-records (YYYYMMDD + offset),
+ * én pr. dag med linjer, stigende. locateDay() finder fil og offset for en dato
+ * med binær søgning i indekset – derefter ét seek i stedet for at scanne filen.
+ * Offset peger i den aktive fil hvis datoen er i samme måned som sidste entry,
+ * ellers i månedens arkiv. En entry skrives først når data før offset er sync'et.
+ *
+ * Forespørgsler (/api/log, /api/log/tail): query() og tail() finder det
+ * sammenhængende byte-interval der matcher (linjerne er kronologiske), og
+ * returnerer filen positioneret ved første byte. Selve afsendelsen sker som en
+ * almindelig download. tail() læser baglæns fra filens slutning i
+ * LYSLOG_SCAN_BUF-blokke på blokgrænser; query() springer til startdatoen via
+ * dato-indekset og tæller kun linjer frem til limit.
  */
 
 #include <SdFat.h>
 #include <Arduino.h>
 #include "hardware/rtc.h"
 
+#include "EpochClock.h"
+#include "EventRecord.h"
+
 #define NATLOG_FILENAME      "/nataktiv.log"
 #define PIRLOG_FILENAME      "/pir.log"
 #define HARDWARELOG_FILENAME  "/hardware.log"
+#define EVENTLOG_FILENAME    "/events.bin"
+#define LOGARCHIVE_DIR       "/log"
+
+#define LYSLOG_BUF       512     // RAM-buffer pr. logfil (én SD-sektor)
+#define LYSLOG_FLUSH_MS  5000    // Max alder af en bufferet linje før flush + sync
+#define LYSLOG_MAX_MB    64      // Standard loftsgrænse for alle logfiler (aktive + arkiv)
+#define LYSLOG_SCAN_BUF  4096    // Læseblok til query()/tail() (multiplum af 512)
+
+/** Dato-indeks record i /log/<navn>.idx. */
+struct LogIndexEntry {
+    uint32_t day;       // Lokal dato YYYYMMDD
+    uint32_t offset;    // Byte-offset for dagens første linje/record
+};
 
 class LysLog {
 public:
-    LysLog(SdFat &sd, bool natLogEnabled = true, bool pirLogEnabled = true)
-        : sd(sd), natLogEnabled(natLogEnabled), pirLogEnabled(pirLogEnabled) {}
+    LysLog(SdFat &sd, bool natLogEnabled = true, bool pirLogEnabled = true, bool binary = false)
+        : sd(sd), natLogEnabled(natLogEnabled), pirLogEnabled(pirLogEnabled), binary(binary) {}
 
-    /** Log nat/dag overgang (respekterer natLogEnabled). */
-    void logNatAktiv(bool aktiv) {
-        if (!natLogEnabled) return;
-        appendToFile(NATLOG_FILENAME, makeTimeLine("NAT_AKTIV_" + String(aktiv ? "ON" : "OFF")));
-    }
+    /**
+     * @brief Log et event (lyslogstate). Nat/PIR-events respekterer deres log-flag,
+     *        hardware-events logges altid.
+     * @param epochMs UTC i ms da eventet skete; 0 → nu.
+     */
+    void logEvent(uint8_t code, uint32_t arg = 0, uint64_t epochMs = 0) {
+        LogFileId f = eventLogFile(code);
+        if (f == LOG_NONE) return;
+        if (f == LOG_NAT && !natLogEnabled) return;
+        if (f == LOG_PIR && !pirLogEnabled) return;
 
-    /** Log PIR/HW/SW event (respekterer pirLogEnabled). */
-    void logPIR(const String& pirNavn) {
-        if (!pirLogEnabled) return;
-        appendToFile(PIRLOG_FILENAME, makeTimeLine(pirNavn + "_ACTIVATED"));
+        if (binary) {
+            if (epochMs == 0) epochMs = epochClock.nowMs();
+            EventRecord r;
+            r.epoch = (uint32_t)(epochMs / 1000);
+            r.ms    = (uint16_t)(epochMs % 1000);
+            r.code  = code;
+            r.magic = EVENT_RECORD_MAGIC;
+            r.arg   = arg;
+            append(SLOT_BIN, (const char*)&r, sizeof(r), EpochClock::localDay(r.epoch));
+            return;
+        }
+
+        uint32_t epoch = (uint32_t)(epochMs / 1000);
+        char line[112];
+        int n = timePrefix(epoch, line, sizeof(line));
+        n += eventText(code, arg, line + n, sizeof(line) - n - 1);
+        if (n > (int)sizeof(line) - 2) n = sizeof(line) - 2;
+        line[n++] = '\n';
+        append(f, line, n, EpochClock::localDay(epoch ? epoch : epochClock.now()));
     }
 
-    /** Log hardware-event (ALTID aktiv, uanset flag). */
-    void logHardware(const String& event) {
-        appendToFile(HARDWARELOG_FILENAME, makeTimeLine(event));
+    /** Fri tekst til hardware.log (ALTID aktiv, også i binær mode) – fx astro-linjen. */
+    void logHardware(const char* text, uint32_t epoch = 0) {
+        char line[224];
+        int n = timePrefix(epoch, line, sizeof(line));
+        n += snprintf(line + n, sizeof(line) - n, "%s\n", text);
+        if (n >= (int)sizeof(line)) {
+            n = sizeof(line) - 1;
+            line[n - 1] = '\n';
+        }
+        append(LOG_HW, line, n, EpochClock::localDay(epoch ? epoch : epochClock.now()));
     }
+    void logHardware(const String& text, uint32_t epoch = 0) { logHardware(text.c_str(), epoch); }
 
-    void logWatchdogReset()                 { logHardware("WATCHDOG_RESET"); }
-    void logI2CReset(const char* bus)       { logHardware(String("I2C_RESET_") + bus); }
-    void logWiFiReconnect(const String& ip) { logHardware(String("WIFI_RECONNECT ") + ip); }
-    void logBootReboot(const char* reason)  { logHardware(String("BOOT_REBOOT ") + reason); }
+    void logWiFiReconnect(uint32_t ipv4)   { logEvent(wifi_reconnect, ipv4); }
+    void logBootReboot(BootReason reason)  { logEvent(boot_reboot, reason); flush(); }
 
     void setLogNatAktiv(bool enabled) { natLogEnabled = enabled; }
     void setLogPIRAktiv(bool enabled) { pirLogEnabled = enabled; }
 
+    /** Skift mellem tekstlog og /events.bin (ventende data skrives først). */
+    void setBinary(bool enabled) {
+        if (enabled == binary) return;
+        flush();
+        binary = enabled;
+    }
+
+    /** Kald fra loop(): flush + sync når ældste bufferede linje er LYSLOG_FLUSH_MS gammel. */
+    void poll() {
+        if (pending && millis() - oldestMs >= LYSLOG_FLUSH_MS) flush();
+    }
+
+    /** Skriv alle buffere og sync filerne (group commit). */
+    void flush() {
+        for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+            writeBuf(logs[i]);
+            if (logs[i].dirty) {
+                if (logs[i].file.sync()) syncs++;
+                else errors++;
+            }
+            logs[i].dirty = false;
+        }
+        pending = false;
+    }
+
+    /** flush() og luk filerne – før en logfil slettes/overskrives udefra. Genåbnes ved næste linje. */
+    void release() {
+        flush();
+        for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+            if (logs[i].file.isOpen()) logs[i].file.close();
+        }
+    }
+
+    /** Loft for alle logfiler i MB (aktive + /log arkiver). Ældste arkiver slettes straks ved overskridelse. */
+    void setMaxMB(uint16_t mb) {
+        maxBytes = (uint64_t)(mb ? mb : 1) * 1024u * 1024u;
+        enforceCap();
+    }
+
+    /**
+     * @brief Find første linje/record på eller efter en lokal dato via dato-indekset.
+     * @param slot LOG_NAT, LOG_PIR, LOG_HW eller SLOT_BIN.
+     * @param day  YYYYMMDD.
+     * @param path Modtager filnavnet (aktiv fil eller /log arkiv).
+     * @param offset Modtager byte-offset i filen.
+     * @param found Modtager den fundne indeks-dato (kan være senere end day).
+     * @return false hvis indekset ikke har nogen dato ≥ day.
+     */
+    bool locateDay(uint8_t slot, uint32_t day, char* path, size_t size,
+                   uint32_t& offset, uint32_t* found = nullptr) {
+        if (slot >= SLOT_COUNT) return false;
+        char idxPath[32];
+        indexName(slot, idxPath, sizeof(idxPath));
+        FsFile idx = sd.open(idxPath, O_RDONLY);
+        if (!idx) return false;
+        uint32_t n = (uint32_t)(idx.fileSize() / sizeof(LogIndexEntry));
+        LogIndexEntry last, e;
+        if (n == 0 || !readIndex(idx, n - 1, last)) return false;
+
+        // Første entry med e.day >= day (indekset er stigende)
+        uint32_t lo = 0, hi = n;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (!readIndex(idx, mid, e)) return false;
+            if (e.day < day) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo == n || !readIndex(idx, lo, e)) return false;
+        idx.close();
+
+        if (e.day / 100 == last.day / 100) snprintf(path, size, "%s", fileName(slot));
+        else archiveName(slot, e.day / 100, path, size);
+        offset = e.offset;
+        if (found) *found = e.day;
+        return true;
+    }
+
+    /**
+     * @brief Linjer (records for SLOT_BIN) fra og med fromDay til og med toDay.
+     *        Resultatet ligger altid i én fil: starter datoen i et arkiv, slutter svaret
+     *        ved arkivets slutning, og more sættes – næste måned hentes med en ny forespørgsel.
+     * @param fromDay YYYYMMDD; 0 = fra starten af den aktive fil.
+     * @param toDay   YYYYMMDD; 0 = til filens slutning.
+     * @param limit   Max antal linjer/records; 0 = ubegrænset.
+     * @param file    Modtager filen, positioneret ved første byte.
+     * @param len     Modtager antal bytes der skal sendes.
+     * @param more    true hvis der er flere linjer end sendt (limit eller måneds-arkiv).
+     * @return false hvis filen ikke findes eller ingen dato ≥ fromDay er indekseret.
+     */
+    bool query(uint8_t slot, uint32_t fromDay, uint32_t toDay, uint32_t limit,
+               FsFile& file, uint32_t& len, bool& more) {
+        if (slot >= SLOT_COUNT) return false;
+        flush();
+        char path[48];
+        uint32_t start = 0, found = 0;
+        snprintf(path, sizeof(path), "%s", fileName(slot));
+        if (fromDay && !locateDay(slot, fromDay, path, sizeof(path), start, &found)) return false;
+
+        file = sd.open(path, O_RDONLY);
+        if (!file) return false;
+        uint32_t end = (uint32_t)file.fileSize();
+        bool archive = strcmp(path, fileName(slot)) != 0;
+        more = archive && (toDay == 0 || toDay / 100 > found / 100);
+
+        if (toDay) {
+            // Første entry efter toDay (YYYYMMDD + 1 sorterer før næste dato, også ved månedsskift)
+            char nextPath[48];
+            uint32_t nextOff = 0, nextDay = 0;
+            if (locateDay(slot, toDay + 1, nextPath, sizeof(nextPath), nextOff, &nextDay)) {
+                if (strcmp(nextPath, path) == 0) {
+                    if (nextOff < end) end = nextOff;
+                } else if (!archive || nextDay / 100 < found / 100) {
+                    // Første dato efter toDay ligger i en tidligere fil (arkiverne går forud for
+                    // den aktive fil): alt i den åbnede fil er efter toDay
+                    end = start;
+                    more = false;
+                }
+            }
+        }
+        if (start > end) start = end;
+        if (!file.seekSet(start)) return false;
+
+        if (limit) {
+            uint32_t stop = (slot == SLOT_BIN) ? recordsEnd(start, end, limit)
+                                               : scanForward(file, start, end, limit);
+            if (stop < end) more = true;
+            end = stop;
+            if (!file.seekSet(start)) return false;
+        }
+        len = end - start;
+        return true;
+    }
+
+    /**
+     * @brief De sidste n linjer (records for SLOT_BIN) af den aktive fil.
+     *        Tekstfiler læses baglæns i LYSLOG_SCAN_BUF-blokke indtil n linjeskift er fundet.
+     */
+    bool tail(uint8_t slot, uint32_t n, FsFile& file, uint32_t& len) {
+        if (slot >= SLOT_COUNT) return false;
+        flush();
+        file = sd.open(fileName(slot), O_RDONLY);
+        if (!file) return false;
+        uint32_t size = (uint32_t)file.fileSize();
+        uint32_t start = 0;
+        if (slot == SLOT_BIN) {
+            uint32_t recs = size / sizeof(EventRecord);
+            start = (recs > n ? recs - n : 0) * (uint32_t)sizeof(EventRecord);
+        } else if (n == 0) {
+            start = size;
+        } else if (size > 1) {
+            start = scanBackward(file, size - 1, n);    // Sidste byte er normalt linjens '\n'
+        }
+        if (!file.seekSet(start)) return false;
+        len = size - start;
+        return true;
+    }
+
+    static constexpr uint8_t SLOT_BIN = 3;      // /events.bin (LOG_NAT/LOG_PIR/LOG_HW er 0-2)
+
+    uint32_t syncCount() const { return syncs; }      // Antal fil-sync (SD-commits)
+    uint32_t lineCount() const { return lines; }      // Antal log-linjer/records
+    uint32_t writeCount() const { return writes; }    // Antal buffer-writes til SD
+    uint32_t errorCount() const { return errors; }    // Fejlede SD-writes/syncs/åbninger
+
 private:
+    // Buffer-pladser: LOG_NAT, LOG_PIR, LOG_HW (EventRecord.h) + /events.bin (SLOT_BIN)
+    static constexpr uint8_t SLOT_COUNT = 4;
+
+    struct LogBuf {
+        FsFile   file;
+        uint32_t size = 0;          // Filstørrelse inkl. bufferede bytes (offset for næste linje)
+        uint32_t day = 0;           // Seneste dato i indekset (0 = ikke læst endnu)
+        uint32_t rotateFailDay = 0; // Dato hvor rotation sidst fejlede (næste forsøg dagen efter)
+        uint16_t len = 0;
+        bool     dirty = false;     // Skrevet siden sidste sync
+        char     data[LYSLOG_BUF];
+    };
+
     SdFat &sd;
     bool natLogEnabled;
     bool pirLogEnabled;
+    bool binary;
+
+    LogBuf   logs[SLOT_COUNT];
+    bool     pending = false;       // Mindst én linje venter i RAM
+    uint32_t oldestMs = 0;          // millis() for ældste ventende linje
+    uint32_t syncs = 0;
+    uint32_t lines = 0;
+    uint32_t writes = 0;
+    uint32_t errors = 0;
+    uint64_t maxBytes = (uint64_t)LYSLOG_MAX_MB * 1024u * 1024u;
 
-    /** Opret tidsstemplet log-linje fra RTC. */
-    String makeTimeLine(const String& event) {
-        datetime_t t;
-        rtc_get_datetime(&t);
-        char tidBuf[32];
-        snprintf(tidBuf, sizeof(tidBuf), "%04d-%02d-%02d %02d:%02d:%02d",
-                 t.year, t.month, t.day, t.hour, t.min, t.sec);
-        return "[" + String(tidBuf) + "] " + event + "\n";
+    char     scan[LYSLOG_SCAN_BUF];     // query()/tail() læseblok
+
+    static const char* fileName(uint8_t id) {
+        switch (id) {
+            case LOG_NAT: return NATLOG_FILENAME;
+            case LOG_PIR: return PIRLOG_FILENAME;
+            case LOG_HW:  return HARDWARELOG_FILENAME;
+            default:      return EVENTLOG_FILENAME;
+        }
+    }
+
+    /** Navn uden mappe og endelse – bruges til arkiv- og indeksfiler. */
+    static const char* baseName(uint8_t id) {
+        switch (id) {
+            case LOG_NAT: return "nataktiv";
+            case LOG_PIR: return "pir";
+            case LOG_HW:  return "hardware";
+            default:      return "events";
+        }
     }
 
-    /** Append linje til fil på SD-kort. */
-    void appendToFile(const char *filename, const String& line) {
-        FsFile file = sd.open(filename, FILE_WRITE);
-        if (file) {
-            file.seekEnd();
-            file.print(line);
-            file.close();
+    static void archiveName(uint8_t id, uint32_t month, char* buf, size_t size) {
+        snprintf(buf, size, LOGARCHIVE_DIR "/%04lu-%02lu-%s%s", (unsigned long)(month / 100),
+                 (unsigned long)(month % 100), baseName(id), id == SLOT_BIN ? ".bin" : ".log");
+    }
+
+    static void indexName(uint8_t id, char* buf, size_t size) {
+        snprintf(buf, size, LOGARCHIVE_DIR "/%s.idx", baseName(id));
+    }
+
+    static bool readIndex(FsFile& idx, uint32_t i, LogIndexEntry& e) {
+        return idx.seekSet((uint64_t)i * sizeof(e)) && idx.read(&e, sizeof(e)) == (int)sizeof(e);
+    }
+
+    // ------------------ Forespørgsler ------------------
+    /** Offset lige efter den n'te linje fra pos (højst end). Filen skal stå ved pos. */
+    uint32_t scanForward(FsFile& f, uint32_t pos, uint32_t end, uint32_t n) {
+        while (pos < end) {
+            uint32_t k = end - pos;
+            if (k > LYSLOG_SCAN_BUF) k = LYSLOG_SCAN_BUF;
+            int r = f.read(scan, k);
+            if (r <= 0) break;
+            for (int i = 0; i < r; i++) {
+                if (scan[i] == '\n' && --n == 0) return pos + (uint32_t)i + 1;
+            }
+            pos += (uint32_t)r;
+        }
+        return end;
+    }
+
+    /** Start af de sidste n linjer før pos: læser baglæns i blokke justeret til LYSLOG_SCAN_BUF. */
+    uint32_t scanBackward(FsFile& f, uint32_t pos, uint32_t n) {
+        while (pos > 0) {
+            uint32_t blk = (pos - 1) & ~(uint32_t)(LYSLOG_SCAN_BUF - 1);
+            uint32_t k = pos - blk;
+            if (!f.seekSet(blk) || f.read(scan, k) != (int)k) break;
+            for (uint32_t i = k; i-- > 0;) {
+                if (scan[i] == '\n' && --n == 0) return blk + i + 1;
+            }
+            pos = blk;
+        }
+        return 0;
+    }
+
+    static uint32_t recordsEnd(uint32_t start, uint32_t end, uint32_t n) {
+        uint32_t bytes = (uint32_t)sizeof(EventRecord) * n;
+        return (n > (end - start) / sizeof(EventRecord)) ? end : start + bytes;
+    }
+
+    /** "[YYYY-MM-DD HH:MM:SS] " i lokal tid (epoch = 0 → RTC nu). Returnerer længden. */
+    static int timePrefix(uint32_t epoch, char* buf, size_t size) {
+        char tidBuf[24];
+        if (epoch) {
+            EpochClock::formatLocal(epoch, tidBuf, sizeof(tidBuf));
+        } else {
+            datetime_t t = {};      // Nuller hvis RTC'en ikke er sat
+            rtc_get_datetime(&t);
+            snprintf(tidBuf, sizeof(tidBuf), "%04u-%02u-%02u %02u:%02u:%02u",
+                     (unsigned)t.year % 10000u, (unsigned)t.month % 100u, (unsigned)t.day % 100u,
+                     (unsigned)t.hour % 100u, (unsigned)t.min % 100u, (unsigned)t.sec % 100u);
+        }
+        return snprintf(buf, size, "[%s] ", tidBuf);
+    }
+
+    /**
+     * @brief Læg data i pladsens RAM-buffer (skrives først når bufferen er fuld eller ved flush).
+     * @param day Lokal dato (YYYYMMDD) for linjen; 0 = ukendt (ingen indeks/rotation).
+     */
+    void append(uint8_t slot, const char* p, size_t n, uint32_t day) {
+        LogBuf& b = logs[slot];
+        if (!b.file.isOpen()) openSlot(slot);
+        if (day) noteDay(slot, day);
+        if (b.len + n > LYSLOG_BUF) writeBuf(b);
+        memcpy(b.data + b.len, p, n);       // n ≤ 224 < LYSLOG_BUF
+        b.len += (uint16_t)n;
+        b.size += (uint32_t)n;
+        if (!pending) {
+            pending = true;
+            oldestMs = millis();
+        }
+        lines++;
+    }
+
+    void writeBuf(LogBuf& b) {
+        if (b.len == 0) return;
+        writeRaw(b, b.data, b.len);
+        b.len = 0;
+    }
+
+    void writeRaw(LogBuf& b, const char* p, size_t n) {
+        if (!b.file.isOpen() && !openSlot((uint8_t)(&b - logs))) {
+            errors++;
+            return;
+        }
+        if (b.file.write(p, n) != n) errors++;
+        b.dirty = true;
+        writes++;
+    }
+
+    bool openSlot(uint8_t slot) {
+        LogBuf& b = logs[slot];
+        b.file = sd.open(fileName(slot), O_WRONLY | O_CREAT | O_APPEND);
+        if (!b.file) return false;
+        b.size = (uint32_t)b.file.fileSize() + b.len;
+        return true;
+    }
+
+    // ------------------ Rotation og dato-indeks ------------------
+    /**
+     * Ny dag → indeks-entry; ny måned → rotér først. Datoer før seneste ignoreres (ur stillet tilbage).
+     * Fejler rotationen, skrives ingen indeks-entries (og b.day står stille), så indekset aldrig
+     * peger ind i en fil med to måneders linjer; der prøves igen ved næste nye dato.
+     */
+    void noteDay(uint8_t slot, uint32_t day) {
+        LogBuf& b = logs[slot];
+        if (b.day == 0) b.day = lastIndexedDay(slot);       // Efter boot
+        if (day <= b.day) return;
+        if (b.day != 0 && day / 100 != b.day / 100) {
+            if (day <= b.rotateFailDay) return;
+            if (!rotate(slot, b.day / 100)) {
+                b.rotateFailDay = day;
+                return;
+            }
+        }
+        b.day = day;
+
+        // Entry'en peger på filens nuværende slutning: skriv og sync bufferen først, så indekset
+        // aldrig peger forbi data der kan gå tabt ved strømsvigt (efter reboot skrives ingen ny entry)
+        writeBuf(b);
+        if (b.dirty) {
+            if (!b.file.sync()) {
+                errors++;
+                return;
+            }
+            syncs++;
+            b.dirty = false;
+        }
+
+        LogIndexEntry e{day, b.size};
+        char idxPath[32];
+        indexName(slot, idxPath, sizeof(idxPath));
+        if (!sd.exists(LOGARCHIVE_DIR)) sd.mkdir(LOGARCHIVE_DIR);
+        FsFile idx = sd.open(idxPath, O_WRONLY | O_CREAT | O_APPEND);
+        if (!idx) return;
+        idx.write(&e, sizeof(e));
+        idx.close();
+    }
+
+    uint32_t lastIndexedDay(uint8_t slot) {
+        char idxPath[32];
+        indexName(slot, idxPath, sizeof(idxPath));
+        FsFile idx = sd.open(idxPath, O_RDONLY);
+        if (!idx) return 0;
+        uint32_t n = (uint32_t)(idx.fileSize() / sizeof(LogIndexEntry));
+        LogIndexEntry e;
+        return (n && readIndex(idx, n - 1, e)) ? e.day : 0;
+    }
+
+    /**
+     * Flyt aktiv fil til /log/YYYY-MM-<navn> (month = YYYYMM) og håndhæv loftet.
+     * @return false hvis filen ikke kunne flyttes – den aktive fil fortsætter uændret.
+     */
+    bool rotate(uint8_t slot, uint32_t month) {
+        LogBuf& b = logs[slot];
+        writeBuf(b);
+        if (b.file.isOpen()) b.file.close();        // close() sync'er
+        b.dirty = false;
+
+        char arch[40];
+        archiveName(slot, month, arch, sizeof(arch));
+        if (!sd.exists(LOGARCHIVE_DIR)) sd.mkdir(LOGARCHIVE_DIR);
+        bool ok = (!sd.exists(arch) || moveAside(arch)) && sd.rename(fileName(slot), arch);
+        if (ok) {
+            b.size = 0;
+        } else {
+            errors++;
+            Serial.printf("LysLog: rotation af %s til %s fejlede – intet dato-indeks indtil den lykkes\n",
+                          fileName(slot), arch);
+        }
+        openSlot(slot);
+        if (ok) enforceCap();
+        return ok;
+    }
+
+    /**
+     * Arkivnavnet er optaget (fx efter et slettet indeks): omdøb det gamle arkiv til
+     * YYYY-MM-<navn>-N.<ext>. Det slettes stadig af enforceCap(), men indekset peger ikke ind i det.
+     */
+    bool moveAside(const char* arch) {
+        const char* dot = strrchr(arch, '.');
+        char alt[48];
+        for (uint8_t n = 1; n <= 9; n++) {
+            snprintf(alt, sizeof(alt), "%.*s-%u%s", (int)(dot - arch), arch, n, dot);
+            if (!sd.exists(alt)) return sd.rename(arch, alt);
+        }
+        return false;
+    }
+
+    /** Aktiv fils størrelse: b.size når pladsen er åben (inkl. buffer), ellers læst fra SD (fx ved boot). */
+    uint32_t activeSize(uint8_t slot) {
+        if (logs[slot].file.isOpen()) return logs[slot].size;
+        FsFile f = sd.open(fileName(slot), O_RDONLY);
+        return f ? (uint32_t)f.fileSize() : 0;
+    }
+
+    /** Slet ældste arkiver (navnene sorterer kronologisk) til alle logfiler er under maxBytes. */
+    void enforceCap() {
+        for (;;) {
+            uint64_t total = 0;
+            for (uint8_t i = 0; i < SLOT_COUNT; i++) total += activeSize(i);
+
+            char oldest[40] = "";
+            FsFile dir = sd.open(LOGARCHIVE_DIR, O_RDONLY);
+            if (!dir) return;
+            FsFile e;
+            char name[40];
+            while (e.openNext(&dir, O_RDONLY)) {
+                if (!e.isDir()) {
+                    total += e.fileSize();
+                    e.getName(name, sizeof(name));
+                    size_t nl = strlen(name);
+                    bool archive = nl > 8 && name[4] == '-' && name[7] == '-' &&
+                                   strcmp(name + nl - 4, ".idx") != 0;
+                    if (archive && (oldest[0] == '\0' || strcmp(name, oldest) < 0)) {
+                        snprintf(oldest, sizeof(oldest), "%s", name);
+                    }
+                }
+                e.close();
+            }
+            dir.close();
+            if (total <= maxBytes || oldest[0] == '\0') return;
+
+            char path[48];
+            snprintf(path, sizeof(path), LOGARCHIVE_DIR "/%s", oldest);
+            if (!sd.remove(path)) return;
+            Serial.printf("LysLog: loft nået, slettede %s\n", path);
+
+            uint32_t month = (uint32_t)atoi(oldest) * 100u + (uint32_t)atoi(oldest + 5);
+            for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+                if (strcmp(oldest + 8, strrchr(fileName(i), '/') + 1) == 0) pruneIndex(i, month);
+            }
+        }
+    }
+
+    /** Fjern indeks-entries til og med month (YYYYMM) – arkivet er slettet. */
+    void pruneIndex(uint8_t slot, uint32_t month) {
+        char idxPath[32], tmpPath[32];
+        indexName(slot, idxPath, sizeof(idxPath));
+        snprintf(tmpPath, sizeof(tmpPath), LOGARCHIVE_DIR "/%s.tmp", baseName(slot));
+
+        FsFile idx = sd.open(idxPath, O_RDONLY);
+        if (!idx) return;
+        FsFile tmp = sd.open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC);
+        if (!tmp) return;
+        LogIndexEntry e;
+        while (idx.read(&e, sizeof(e)) == (int)sizeof(e)) {
+            if (e.day / 100 > month) tmp.write(&e, sizeof(e));
         }
+        idx.close();
+        tmp.close();
+        sd.remove(idxPath);
+        sd.rename(tmpPath, idxPath);
     }
 };
@@ -3,7 +3,7 @@
  * @brief Lysstyring til hus – Raspberry Pi Pico W (RP2040) + Earl Philhower Arduino core.
  *
  * Dual-core arkitektur:
- *   Core0: WiFi, NTP/RTC, SD-kort, webserver, filbrowser og FIFO-log-consumer.
+ *   Core0: WiFi, NTP/RTC, SD-kort, webserver, filbrowser og log-consumer (EventRing).
  *   Core1: Sensorlæsning (VEML7700 lux, BMP280 tryk/temp), PIR/HW-switch,
  *          lys-automatik (Tid/Klokken/Astro), dimmerstyring og watchdog.
  *
@@ -18,16 +18,22 @@
 #include "hardware/rtc.h"
 #include <SdFat.h>
 #include "pico/mutex.h"
-#include <queue>
 #include <ctime>
 #include <cstring>
 
 #include "WebServerHandler.h"
+#include "WebServerEngine.h"
 #include "LysAutomatik.h"
 #include "mitjason.h"
 #include "LysParam.h"
-#include "SimpleHardwareTimer.h"
 #include "lyslog.h"
+#include "StatusSnapshot.h"
+#include "EpochClock.h"
+#include "EventRing.h"
+#include "SensorHistory.h"
+#include "LoopTiming.h"
+#include "CrashTrail.h"
+#include "hardware/watchdog.h"
 #include <Ticker.h>
 
 // -------------------- SD-kort pins (SPI) --------------------
@@ -46,13 +52,33 @@
 #define pir2def          15      // GPIO til PIR sensor 2
 #define hwswdef          13      // GPIO til hardware switch (kontakt)
 #define ntpupdatetimer   10000   // Interval for periodisk NTP-sync (ms)
+#define eventpollms      100     // Tøm EventRing mindst så ofte, også uden dørklokke (ms)
+#define core1stallms     1500    // Ingen status fra core1 så længe → flush log før watchdog (3 s)
 
 // -------------------- Mutex (delt mellem core0 og core1) --------------------
-mutex_t lys_mutex;     // Beskytter dimmer-værdier
-mutex_t nat_mutex;     // Beskytter nataktiv-status
+mutex_t lys_mutex;     // Beskytter dimmer-kommandoer fra web (slider/on/off)
 mutex_t param_mutex;   // Beskytter LysParam konfiguration
-mutex_t pir_mutex;     // Beskytter PIR-tidsstempler
-mutex_t epoch_mutex;   // Beskytter NTP-epoch deling
+
+// Lock-free deling (SeqLock): status core1 → core0, UTC-tid core0 → core1
+SeqLock<StatusSnapshot> statusSnapshot;
+EpochClock epochClock;
+
+// Lock-free SPSC ring: log-events core1 → core0 (FIFO bruges kun som dørklokke)
+EventRing eventRing;
+
+// Sensorhistorik (skrives af core1 hvert sekund, læses af /history). Fast RAM, ingen allokering
+SensorHistoryBuf<HISTORY_LUX_1S_LEN, HISTORY_LUX_1M_LEN, HISTORY_LUX_15M_LEN> luxHistory(HIST_LUX);
+SensorHistoryBuf<HISTORY_ENV_1S_LEN, HISTORY_ENV_1M_LEN, HISTORY_ENV_15M_LEN> tempHistory(HIST_TEMP);
+SensorHistoryBuf<HISTORY_ENV_1S_LEN, HISTORY_ENV_1M_LEN, HISTORY_ENV_15M_LEN> pressureHistory(HIST_PRESSURE);
+SensorHistory* const sensorHistory[HIST_SENSOR_COUNT] = {&luxHistory, &tempHistory, &pressureHistory};
+
+// Brødkrummer fra core1 – no-init RAM, overlever watchdog-reset (dumpes i setup())
+volatile CrashTrailData crashTrail __attribute__((section(".uninitialized_data.crashtrail")));
+
+#if LYS_TIMING
+// Sektionstider i loop1 (skrives af core1, læses af /debug/timing)
+LoopTiming loopTiming;
+#endif
 
 // -------------------- System / state --------------------
 #define systemNavn "lyskontrol"
@@ -62,9 +88,9 @@ bool core1_separate_stack = true;
 
 bool swaktiv = false;          // Software-on flag (sat fra web)
 int  last_lysprocent = 0;      // Aktuel lysprocent (læses fra dimmer)
-bool kopinatstatus = false;    // Kopi af nataktiv for webvisning
 
 LysParam lysparam;
+uint32_t lysparamRev = 0;      // Se LysParam.h
 
 // -------------------- NTP / WiFi --------------------
 WiFiUDP ntpUDP;
@@ -72,13 +98,12 @@ WiFiUDP ntpUDP;
 NTPClient timeClient(ntpUDP, "dk.pool.ntp.org", 0, 60000);
 WiFiServer server(80);
 
-volatile uint32_t ntpEpochCopy = 0;   // UTC epoch delt med core1
 unsigned long lastPeriodicNtpMs = 0;
 
 // -------------------- Konfiguration / Web / Log --------------------
 MitJsonWiFi* mitjason = new MitJsonWiFi;
 
-// Runtime data (produceres på core1, læses på core0 via mutex)
+// Runtime data (produceres på core1, publiceres til web via StatusSnapshot)
 float last_lux = 0.0f;
 float last_temp = 0.0f;
 float last_pressure = 0.0f;
@@ -87,49 +112,25 @@ bool  hwaktiv = false;
 bool  updatelysprocent = false;
 int   nyupdatevaerdi = 0;
 bool  tvungeton = false;
-String sidste1pirtid = "";
-String sidste2pirtid = "";
-String sidstehwswtid = "";
 
 // Automatik (oprettes på core1 i setup1)
 LysAutomatik* automatik = nullptr;
 
 WebServerHandler* webHandler = new WebServerHandler(
-    last_lysprocent,
-    internaltemp,
-    tvungeton,
-    hwaktiv,
-    last_lux,
-    last_temp,
-    last_pressure,
     swaktiv,
     updatelysprocent,
-    nyupdatevaerdi,
-    kopinatstatus,
-    &sidste1pirtid,
-    &sidste2pirtid,
-    &sidstehwswtid
+    nyupdatevaerdi
 );
 
-SimpleHardwareTimer* fifoTimer = new SimpleHardwareTimer;
-volatile bool queueDirty = false;
-std::queue<uint32_t> logQueue;
+// Forbindelsestabel – servicerer flere klienter samtidigt uden at blokere loop()
+WebServerEngine* webEngine = new WebServerEngine(server, *webHandler);
 
 SdFat sd;
 bool ntpsat = false;
+uint32_t wifiReconnects = 0;   // Vellykkede WiFi-reconnects siden boot (/metrics)
 
 LysLog* lyslog = nullptr;
 
-// -------------------- FIFO callback (læs events fra core1) --------------------
-void fifoTimerCallback() {
-    while (rp2040.fifo.available()) {
-        uint32_t code;
-        rp2040.fifo.pop_nb(&code);
-        logQueue.push(code);
-        queueDirty = true;
-    }
-}
-
 // -------------------- NTP init + første sync --------------------
 static bool setupWiFiAndNTP() {
     Serial.println("Forbinder til WiFi...");
@@ -191,9 +192,7 @@ static bool setupWiFiAndNTP() {
     rtc_set_datetime(&t);
 
     // Del UTC-epoch med core1
-    mutex_enter_blocking(&epoch_mutex);
-    ntpEpochCopy = (uint32_t)rawTime;
-    mutex_exit(&epoch_mutex);
+    epochClock.set((uint32_t)rawTime);
 
     Serial.println("RTC sat ud fra NTP (lokal tid via TZ)!");
     return true;
@@ -223,19 +222,17 @@ static void periodicNtpUpdate() {
             rtc_set_datetime(&t);
         }
 
-        mutex_enter_blocking(&epoch_mutex);
-        ntpEpochCopy = (uint32_t)rawTime;
-        mutex_exit(&epoch_mutex);
+        epochClock.set((uint32_t)rawTime);
     }
 }
 
-/** Logger astro-data for i dag til hardware.log. Kaldes fra core0 via FIFO-event. */
+/** Logger astro-data for i dag til hardware.log. Kaldes fra core0 ved astro_log_request. */
 static void logAstroLineForToday() {
     if (!lyslog) return;
 
     float lat, lon;
     int offSet, offRise;
-    String mode;
+    LysMode mode;
     bool astroEn;
 
     mutex_enter_blocking(&param_mutex);
@@ -273,7 +270,7 @@ static void logAstroLineForToday() {
     snprintf(datebuf, sizeof(datebuf), "%04d-%02d-%02d", rt.year, rt.month, rt.day);
 
     String line = "ASTRO day=" + String(datebuf);
-    line += " mode=" + mode;
+    line += " mode=" + String(lysModeName(mode));
     line += " enabled=" + String(astroEn ? "1" : "0");
     line += " lat=" + String(lat, 4) + " lon=" + String(lon, 4);
     line += " rise=" + hhmm(at.sunriseMin) + " set=" + hhmm(at.sunsetMin);
@@ -283,30 +280,64 @@ static void logAstroLineForToday() {
     lyslog->logHardware(line);
 }
 
-/** Behandler FIFO-logkøen. Kaldes fra loop() når queueDirty er sat. */
-static void checkforlog() {
-    queueDirty = false;
-
-    while (!logQueue.empty()) {
-        uint32_t code = logQueue.front();
-        logQueue.pop();
-
-        switch (code) {
-            case nataktivfalse:    if (lyslog) lyslog->logNatAktiv(false); break;
-            case nataktivtrue:     if (lyslog) lyslog->logNatAktiv(true);  break;
-            case pir1_detection:   if (lyslog) lyslog->logPIR("pir 1"); break;
-            case pir2_detection:   if (lyslog) lyslog->logPIR("pir 2"); break;
-            case hwsw_on:          if (lyslog) lyslog->logPIR("Kontakt on"); break;
-            case swsw_on:          if (lyslog) lyslog->logPIR("Software on"); break;
-            case hwsw_off:         if (lyslog) lyslog->logPIR("Kontakt off"); break;
-            case swsw_off:         if (lyslog) lyslog->logPIR("Software off"); break;
-            case wdt_reset:        if (lyslog) lyslog->logWatchdogReset(); break;
-            case i2c_reset_wire:   if (lyslog) lyslog->logI2CReset("Wire"); break;
-            case i2c_reset_wire1:  if (lyslog) lyslog->logI2CReset("Wire1"); break;
-            case astro_log_request: logAstroLineForToday(); break;
-            default: break;
-        }
+/** Log ét event fra core1 med det tidsstempel det fik på core1. */
+static void handleEvent(const LysEvent& ev) {
+    if (ev.event == astro_log_request) {
+        logAstroLineForToday();
+        return;
+    }
+    if (lyslog) lyslog->logEvent((uint8_t)ev.event, ev.arg, ev.epochMs);
+}
+
+/**
+ * Tøm EventRing fra core1. Kaldes fra loop(): ved dørklokke i FIFO'en, og hvert
+ * eventpollms som sikkerhedsnet (en dørklokke kan tabes når FIFO'en er fuld).
+ * Nye drops (ringen var fuld) logges i hardware.log.
+ */
+static void drainEvents() {
+    static uint32_t lastDrainMs = 0;
+    static uint32_t loggedDrops = 0;
+
+    bool rung = false;
+    uint32_t word;
+    while (rp2040.fifo.available()) {
+        rp2040.fifo.pop_nb(&word);
+        rung = true;
+    }
+    if (!rung && millis() - lastDrainMs < eventpollms) return;
+    lastDrainMs = millis();
+
+    LysEvent ev;
+    while (eventRing.pop(ev)) handleEvent(ev);
+
+    uint32_t drops = eventRing.dropped();
+    if (drops != loggedDrops) {
+        if (lyslog) lyslog->logEvent(event_dropped, drops - loggedDrops);
+        loggedDrops = drops;
+    }
+}
+
+/**
+ * Core1 publicerer status mindst hvert sekund. Står den stille i core1stallms,
+ * er watchdog'en (3 s) på vej – flush LysLog mens der er tid, så bufferede
+ * linjer ikke går tabt ved reset.
+ */
+static void flushLogIfCore1Stalled() {
+    static uint32_t lastVersion = 0;
+    static uint32_t lastChangeMs = 0;
+    static bool flushed = false;
+
+    uint32_t v = statusSnapshot.version();
+    uint32_t now = millis();
+    if (v != lastVersion) {
+        lastVersion = v;
+        lastChangeMs = now;
+        flushed = false;
+        return;
     }
+    if (v == 0 || flushed || now - lastChangeMs < core1stallms) return;
+    if (lyslog) lyslog->flush();
+    flushed = true;
 }
 
 /** Genopret WiFi-forbindelse ved tab. */
@@ -321,10 +352,7 @@ void setup() {
     Serial.begin(115200);
 
     mutex_init(&lys_mutex);
-    mutex_init(&nat_mutex);
     mutex_init(&param_mutex);
-    mutex_init(&pir_mutex);
-    mutex_init(&epoch_mutex);
 
     delay(1200);
 
@@ -350,9 +378,20 @@ void setup() {
     // Indlæs konfiguration fra SD-kort
     mitjason->loadWiFi(sd, "/wifi.json");
     mitjason->loadDefault(sd, &lysparam);
+    lyslog->setLogNatAktiv(lysparam.lognataktiv);
+    lyslog->setLogPIRAktiv(lysparam.logpirdetection);
+    lyslog->setBinary(lysparam.logbinary);
+    lyslog->setMaxMB(lysparam.logmaxmb);
+
+    // Hvor stod core1 da watchdog'en slog til? Skrives før core1 starter og overskriver sporet
+    if (watchdog_caused_reboot() && crashTrailValid()) {
+        crashTrailDump([](const char* text, uint32_t epoch) { lyslog->logHardware(text, epoch); });
+        lyslog->flush();
+    }
+    crashTrailReset();
 
     if (!setupWiFiAndNTP()) {
-        if (lyslog) lyslog->logBootReboot("WIFI_NOT_FOUND");
+        if (lyslog) lyslog->logBootReboot(BOOT_WIFI_NOT_FOUND);
         Serial.println("Netværks- eller NTP-fejl! Rebooter om 5 sek.");
         delay(5000);
         rp2040.reboot();
@@ -378,33 +417,20 @@ void loop() {
         int status = connectwifi();
         if (status == WL_CONNECTED) {
             Serial.println("[WiFi] Reconnected");
-            if (lyslog) lyslog->logWiFiReconnect(WiFi.localIP().toString());
+            wifiReconnects++;
+            if (lyslog) lyslog->logWiFiReconnect((uint32_t)WiFi.localIP());
         }
     }
 
     periodicNtpUpdate();
 
-    // Webserver
-    WiFiClient client = server.available();
-    if (client) {
-        String req = "";
-        unsigned long timeout = millis() + 2000;
-        while (client.connected() && millis() < timeout) {
-            if (client.available()) {
-                char c = client.read();
-                req += c;
-                if (req.endsWith("\r\n\r\n")) break;
-            }
-        }
-        if (req.length() > 0) {
-            webHandler->handle(client, req);
-        }
-        client.stop();
-    }
+    // Webserver (ikke-blokerende, flere samtidige forbindelser)
+    webEngine->poll();
 
-    // Behandl FIFO-events fra core1
-    fifoTimerCallback();
-    if (queueDirty) checkforlog();
+    // Log-events fra core1 + group commit af logfilerne
+    drainEvents();
+    if (lyslog) lyslog->poll();
+    flushLogIfCore1Stalled();
 
     delay(1);
 }
@@ -417,7 +443,6 @@ void loop() {
 #include "pirroutiner.h"
 #include "SimpleSoftwareTimer.h"
 #include "I2CBusRecover.h"
-#include "hardware/watchdog.h"
 
 // Sensorer
 VEML7700_PIO* veml = new VEML7700_PIO();
@@ -427,9 +452,10 @@ bool timer_tik = false;
 bool WEML7700_tilstede = false;
 bool BMP280_tilstede = false;
 
-// I2C fejltællere
+// I2C fejltællere + sprungne automatik-ticks (publiceres i StatusSnapshot)
 volatile uint32_t i2cWireResets = 0;
 volatile uint32_t i2cWire1Resets = 0;
+static uint32_t paramSkipCount = 0;
 static uint8_t bhNoVal = 0;
 static uint8_t bmpBad = 0;
 
@@ -454,10 +480,10 @@ void softlysIrq() {
     if (pirrou) pirrou->timerRoutine();
 }
 
-// Astro-log: én request per dag via FIFO til core0
+// Astro-log: én request per dag via EventRing til core0
 static int lastAstroReqY = -1, lastAstroReqM = -1, lastAstroReqD = -1;
 
-/** Sender astro_log_request via FIFO én gang pr. dag (kaldet fra core1). */
+/** Poster astro_log_request én gang pr. dag (kaldet fra core1). */
 static void requestAstroLogOncePerDay(time_t utcEpoch) {
     if (utcEpoch < 1700000000) return;
 
@@ -472,7 +498,31 @@ static void requestAstroLogOncePerDay(time_t utcEpoch) {
     if (y == lastAstroReqY && m == lastAstroReqM && d == lastAstroReqD) return;
     lastAstroReqY = y; lastAstroReqM = m; lastAstroReqD = d;
 
-    rp2040.fifo.push_nb(astro_log_request);
+    postEvent(astro_log_request);
+}
+
+/** Udfyld og publicér StatusSnapshot til webserveren på core0 (SeqLock, ingen mutex). */
+static void publishStatus() {
+    StatusSnapshot s;
+    s.epoch      = epochClock.now();
+    s.lux        = last_lux;
+    s.temp       = last_temp;
+    s.pressure   = last_pressure;
+    s.cpuTemp    = internaltemp;
+    s.lysprocent = (int16_t)last_lysprocent;
+    s.autoState  = automatik ? automatik->getAutoState() : AUTO_OFF;
+    s.nat        = automatik ? automatik->getNataktiv() : false;
+    s.forcedOn   = tvungeton;
+    s.hwsw       = hwaktiv;
+    if (pirrou) {
+        s.pir1Epoch = pirrou->getPIR1Epoch();
+        s.pir2Epoch = pirrou->getPIR2Epoch();
+        s.hwswEpoch = pirrou->getHWSWEpoch();
+    }
+    s.i2cWireResets  = i2cWireResets;
+    s.i2cWire1Resets = i2cWire1Resets;
+    s.paramSkips     = paramSkipCount;
+    statusSnapshot.publish(s);
 }
 
 /**
@@ -481,6 +531,7 @@ static void requestAstroLogOncePerDay(time_t utcEpoch) {
  * @return true hvis VEML7700 fundet og konfigureret.
  */
 bool setwire0() {
+    crumbI2C(I2C_BUS_RECOVER);
     I2CBusRecover::recover(5, 4);   // SCL=5, SDA=4
 
     Wire.setSDA(4);
@@ -492,6 +543,7 @@ bool setwire0() {
     Serial.println("Tester VEML7700 lyssensor (Wire)...");
     I2CBusRecover::scanTwoWire(Wire);
 
+    crumbI2C(I2C_VEML_BEGIN);
     if (veml->begin(&Wire)) {
         veml->setGain(VEML7700_PIO::GAIN_1);
         veml->setIntegrationTime(VEML7700_PIO::IT_100MS);
@@ -508,6 +560,7 @@ bool setwire0() {
  * @return true hvis BMP280 fundet.
  */
 bool setwire1() {
+    crumbI2C(I2C_BUS_RECOVER);
     I2CBusRecover::recover(10, 11);
 
     Wire1.setSDA(10);
@@ -516,6 +569,7 @@ bool setwire1() {
     Wire1.setClock(100000);
     Wire1.setTimeout(100);
 
+    crumbI2C(I2C_BMP_BEGIN);
     return bmp->begin(0x76);
 }
 
@@ -524,7 +578,7 @@ void setup1() {
     while (!ntpsat) delay(100);
 
     if (watchdog_caused_reboot()) {
-        rp2040.fifo.push_nb(wdt_reset);
+        postEvent(wdt_reset);
     }
 
     WEML7700_tilstede = setwire0();
@@ -532,7 +586,7 @@ void setup1() {
     pinMode(LED_BUILTIN, OUTPUT);
 
     automatik = new LysAutomatik(lysparam, dimmer);
-    pirrou = new pirroutiner(pir1def, pir2def, hwswdef, &sidste1pirtid, &sidste2pirtid, &sidstehwswtid, lysparam);
+    pirrou = new pirroutiner(pir1def, pir2def, hwswdef, lysparam);
 
     myTimer.setInterval(1000, blink);
     softlysTimer.setInterval(250, softlysIrq);
@@ -551,45 +605,54 @@ void setup1() {
 }
 
 // ==================== Core1 Loop ====================
-static uint32_t paramSkipCount = 0;
 static bool automatikInitDone = false;
+static int publishedLysprocent = -1;
 
 void loop1() {
+    crumbAt(STAGE_LOOP);
     watchdog_update();
     myTimer.run();
     softlysTimer.run();
 
+    bool publishDue = false;
+
     if (timer_tik) {
+        TIMING_SCOPE(LOOP1);
         timer_tik = false;
+        publishDue = true;
 
-        // Hent NTP epoch (UTC) fra core0
-        uint32_t ntpLocal;
-        mutex_enter_blocking(&epoch_mutex);
-        ntpLocal = ntpEpochCopy;
-        mutex_exit(&epoch_mutex);
+        // UTC epoch (NTP-sync fra core0 + millis)
+        uint32_t ntpLocal = epochClock.now();
+        crumbTick(ntpLocal);
 
         requestAstroLogOncePerDay((time_t)ntpLocal);
 
-        // Opdater nataktiv-kopi til web
-        mutex_enter_blocking(&nat_mutex);
-        kopinatstatus = automatik ? automatik->getNataktiv() : false;
-        mutex_exit(&nat_mutex);
+        // Målinger til sensorhistorikken (NAN = ingen gyldig måling dette sekund)
+        float histLux = NAN, histTemp = NAN, histPressure = NAN;
 
         // ---- VEML7700 læsning (Wire/I2C0) ----
         if (WEML7700_tilstede) {
             watchdog_update();
-            float ny_lux = veml->readLux();
+            crumb(STAGE_VEML);
+            crumbI2C(I2C_VEML_READLUX);
+            float ny_lux;
+            {
+                TIMING_SCOPE(VEML);
+                ny_lux = veml->readLux();
+            }
             if (isfinite(ny_lux) && ny_lux >= 0.0f && ny_lux <= 120000.0f) {
                 last_lux = ny_lux;
+                histLux = ny_lux;
                 bhNoVal = 0;
             } else {
                 if (++bhNoVal >= 8) {
+                    crumb(STAGE_VEML_RESET);
                     Serial.println("[VEML7700] Læsefejl – Wire reset");
                     Wire.end();
                     setwire0();
                     bhNoVal = 0;
                     i2cWireResets++;
-                    rp2040.fifo.push_nb(i2c_reset_wire);
+                    postEvent(i2c_reset_wire, i2cWireResets);
                 }
             }
         }
@@ -597,9 +660,11 @@ void loop1() {
         // ---- Boot init (kør én gang når NTP-tid er realistisk) ----
         if (!automatikInitDone && automatik && ntpLocal >= 1700000000UL) {
             float bootLux = last_lux;
+            crumb(STAGE_AUTOINIT);
 
             // Brug frisk VEML7700-værdi hvis tilgængelig
             if (WEML7700_tilstede) {
+                crumbI2C(I2C_VEML_READLUX);
                 float v = veml->readLux();
                 if (isfinite(v) && v >= 0.0f && v <= 20000.0f) bootLux = v;
                 bhNoVal = 0;
@@ -607,34 +672,46 @@ void loop1() {
 
             automatik->initFromNow(bootLux, (time_t)ntpLocal);
             automatikInitDone = true;
-
-            mutex_enter_blocking(&nat_mutex);
-            kopinatstatus = automatik->getNataktiv();
-            mutex_exit(&nat_mutex);
         }
 
         // ---- BMP280 læsning (Wire1/I2C1) ----
         if (BMP280_tilstede) {
-            float t = bmp->readTemperature();
-            float p = bmp->readPressure() / 100.0F;
+            crumb(STAGE_BMP280);
+            float t, p;
+            {
+                TIMING_SCOPE(BMP280);
+                crumbI2C(I2C_BMP_TEMP);
+                t = bmp->readTemperature();
+                crumbI2C(I2C_BMP_PRESSURE);
+                p = bmp->readPressure() / 100.0F;
+            }
             bool bad = isnan(t) || p < 300.0f || p > 1100.0f;
             if (bad) {
                 if (++bmpBad >= 3) {
+                    crumb(STAGE_BMP_RESET);
                     Serial.println("[BMP280] Dårlige læsninger – I2C recover (Wire1)");
                     Wire1.end();
                     setwire1();
                     bmpBad = 0;
                     i2cWire1Resets++;
-                    rp2040.fifo.push_nb(i2c_reset_wire1);
+                    postEvent(i2c_reset_wire1, i2cWire1Resets);
                 }
             } else {
                 last_temp = t;
                 last_pressure = p;
+                histTemp = t;
+                histPressure = p;
                 bmpBad = 0;
             }
         }
 
+        crumb(STAGE_HISTORY);
+        luxHistory.add(histLux, ntpLocal);
+        tempHistory.add(histTemp, ntpLocal);
+        pressureHistory.add(histPressure, ntpLocal);
+
         // ---- Tvungen on/off (hardware switch / software on) ----
+        crumb(STAGE_SWITCH);
         tvungeton = false;
         if (pirrou && pirrou->isHWSWBenLow()) hwaktiv = true;
         else if (hwaktiv) { hwaktiv = false; if (pirrou) pirrou->logHWSWOff(); }
@@ -657,6 +734,8 @@ void loop1() {
             }
 
             // Opdater automatik (kun hvis mutex er ledig – undgå deadlock)
+            TIMING_SCOPE(AUTOMATIK);
+            crumb(STAGE_AUTOMATIK);
             uint32_t owner = 0;
             if (mutex_try_enter(&param_mutex, &owner)) {
                 if (automatik) automatik->update(last_lux, pirstatus, (time_t)ntpLocal);
@@ -672,17 +751,34 @@ void loop1() {
             }
         }
 
-        internaltemp = analogReadTemp();
+        {
+            TIMING_SCOPE(CPUTEMP);
+            crumb(STAGE_CPUTEMP);
+            internaltemp = analogReadTemp();
+        }
     }
 
     // Opdater lysprocent hvis core0 har sat flag (fra web-slider)
-    mutex_enter_blocking(&lys_mutex);
-    if (updatelysprocent) {
-        updatelysprocent = false;
-        dimmer->setlysiprocentSoft(nyupdatevaerdi);
+    {
+        TIMING_SCOPE(LYS_MUTEX);
+        crumbAt(STAGE_LYS_MUTEX);
+        mutex_enter_blocking(&lys_mutex);
+        if (updatelysprocent) {
+            updatelysprocent = false;
+            dimmer->setlysiprocentSoft(nyupdatevaerdi);
+        }
+        mutex_exit(&lys_mutex);
     }
     last_lysprocent = dimmer->returneraktuelvaerdi();
-    mutex_exit(&lys_mutex);
+
+    // Status til web: hvert sekund og straks når lysprocent ændrer sig (softstart/slider)
+    if (publishDue || last_lysprocent != publishedLysprocent) {
+        publishedLysprocent = last_lysprocent;
+        TIMING_SCOPE(PUBLISH);
+        crumbAt(STAGE_PUBLISH);
+        publishStatus();
+    }
+    if (publishDue) TIMING_PUBLISH(millis());
 
     delay(5);
 }
@@ -9,6 +9,10 @@
  *
  * styringsvalg er bagudkompatibel: accepterer både string ("Tid"/"Klokken"/"Astro")
  * og bool (true=Klokken, false=Tid) fra ældre JSON-filer.
+ *
+ * Tillægssegmenter gemmes som array "segments" med start/slut som tekst
+ * ("22:00", "solnedgang+15", se formatSegTime). Ældre filer med seg2*/seg3*
+ * nøgler migreres til segment 2 og 3 ved indlæsning.
  */
 
 #include <ArduinoJson.h>
@@ -94,18 +98,15 @@ public:
             if (v.is<const char*>()) {
                 String mode = v.as<const char*>();
                 mode.trim();
-                if (mode == "Tid" || mode == "Klokken" || mode == "Astro") {
-                    param->styringsvalg = mode;
-                } else {
-                    param->styringsvalg = "Tid";
-                }
+                param->styringsvalg = MODE_TID;
+                parseLysMode(mode.c_str(), param->styringsvalg);
             } else if (v.is<bool>()) {
-                param->styringsvalg = v.as<bool>() ? "Klokken" : "Tid";
+                param->styringsvalg = v.as<bool>() ? MODE_KLOKKEN : MODE_TID;
             } else {
-                param->styringsvalg = "Tid";
+                param->styringsvalg = MODE_TID;
             }
         } else {
-            param->styringsvalg = "Tid";
+            param->styringsvalg = MODE_TID;
         }
 
         // Basis
@@ -123,25 +124,14 @@ public:
         param->slutKlokkeTimer    = d["slutKlokkeTimer"] | 22;
         param->slutKlokkeMinutter = d["slutKlokkeMinutter"] | 0;
 
-        // Segment 2
-        param->seg2Enabled       = d["seg2Enabled"] | false;
-        param->seg2StartTimer    = d["seg2StartTimer"] | 5;
-        param->seg2StartMinutter = d["seg2StartMinutter"] | 30;
-        param->seg2SlutTimer     = d["seg2SlutTimer"] | 7;
-        param->seg2SlutMinutter  = d["seg2SlutMinutter"] | 30;
-        param->seg2WeekMask      = (uint8_t)(d["seg2WeekMask"] | 127);
-
-        // Segment 3
-        param->seg3Enabled       = d["seg3Enabled"] | false;
-        param->seg3StartTimer    = d["seg3StartTimer"] | 0;
-        param->seg3StartMinutter = d["seg3StartMinutter"] | 0;
-        param->seg3SlutTimer     = d["seg3SlutTimer"] | 0;
-        param->seg3SlutMinutter  = d["seg3SlutMinutter"] | 0;
-        param->seg3WeekMask      = (uint8_t)(d["seg3WeekMask"] | 127);
+        // Tillægssegmenter
+        loadSegments(d, param);
 
         // Log
         param->lognataktiv        = d["lognataktiv"] | true;
         param->logpirdetection    = d["logpirdetection"] | true;
+        param->logbinary          = d["logbinary"] | false;
+        param->logmaxmb           = d["logmaxmb"] | 64;
         param->aktuelStepfrekvens = d["aktuelStepfrekvens"] | 5;
 
         // Astro
@@ -155,12 +145,52 @@ public:
         return true;
     }
 
+private:
+    /** "segments" → param->segs; uden array migreres seg2*/seg3* (klokkeslæt, niveau = pwmA). */
+    static void loadSegments(JsonObject d, LysParam* param) {
+        uint8_t n = 0;
+        JsonArray segs = d["segments"];
+        if (!segs.isNull()) {
+            for (JsonObject o : segs) {
+                if (n >= LYS_MAX_SEGMENTS) break;
+                LysSegment sg;
+                if (!parseSegTime(o["start"] | "", sg.start) || !parseSegTime(o["end"] | "", sg.end)) continue;
+                sg.enabled = o["enabled"] | false;
+                int mask = (o["weekMask"] | 127) & 0x7F;
+                sg.weekMask = mask ? (uint8_t)mask : (uint8_t)0x7F;
+                sg.level = (int8_t)constrain((int)(o["level"] | SEG_LEVEL_PWMA), -1, 100);
+                param->segs[n++] = sg;
+            }
+        } else {
+            static const char* const legacy[] = {"seg2", "seg3"};
+            for (const char* pre : legacy) {
+                char key[24];
+                snprintf(key, sizeof(key), "%sEnabled", pre);
+                if (!d.containsKey(key)) continue;
+                LysSegment sg;
+                sg.enabled = d[key] | false;
+                auto num = [&](const char* suffix, int def) {
+                    snprintf(key, sizeof(key), "%s%s", pre, suffix);
+                    return (int)(d[key] | def);
+                };
+                sg.start.min = (int16_t)(constrain(num("StartTimer", 0), 0, 23) * 60 + constrain(num("StartMinutter", 0), 0, 59));
+                sg.end.min   = (int16_t)(constrain(num("SlutTimer", 0), 0, 23) * 60 + constrain(num("SlutMinutter", 0), 0, 59));
+                int mask = num("WeekMask", 127) & 0x7F;
+                sg.weekMask = mask ? (uint8_t)mask : (uint8_t)0x7F;
+                param->segs[n++] = sg;
+            }
+        }
+        param->segCount = n;
+        for (uint8_t i = n; i < LYS_MAX_SEGMENTS; i++) param->segs[i] = LysSegment();
+    }
+
+public:
     /** Gem alle parametre fra LysParam til Default.json. */
     bool saveDefault(SdFat& sd, const LysParam* param) {
         JsonDocument doc;
         JsonObject d = doc["Default"].to<JsonObject>();
 
-        d["styringsvalg"]  = param->styringsvalg;
+        d["styringsvalg"]  = lysModeName(param->styringsvalg);
         d["luxstartvaerdi"] = param->luxstartvaerdi;
 
         d["TimerA"] = param->timerA;
@@ -177,22 +207,24 @@ public:
         d["slutKlokkeTimer"]    = param->slutKlokkeTimer;
         d["slutKlokkeMinutter"] = param->slutKlokkeMinutter;
 
-        d["seg2Enabled"]       = param->seg2Enabled;
-        d["seg2StartTimer"]    = param->seg2StartTimer;
-        d["seg2StartMinutter"] = param->seg2StartMinutter;
-        d["seg2SlutTimer"]     = param->seg2SlutTimer;
-        d["seg2SlutMinutter"]  = param->seg2SlutMinutter;
-        d["seg2WeekMask"]      = param->seg2WeekMask;
-
-        d["seg3Enabled"]       = param->seg3Enabled;
-        d["seg3StartTimer"]    = param->seg3StartTimer;
-        d["seg3StartMinutter"] = param->seg3StartMinutter;
-        d["seg3SlutTimer"]     = param->seg3SlutTimer;
-        d["seg3SlutMinutter"]  = param->seg3SlutMinutter;
-        d["seg3WeekMask"]      = param->seg3WeekMask;
+        JsonArray segs = d["segments"].to<JsonArray>();
+        for (uint8_t i = 0; i < param->segCount && i < LYS_MAX_SEGMENTS; i++) {
+            const LysSegment& sg = param->segs[i];
+            char buf[20];
+            JsonObject o = segs.add<JsonObject>();
+            o["enabled"] = sg.enabled;
+            formatSegTime(buf, sizeof(buf), sg.start);
+            o["start"] = buf;
+            formatSegTime(buf, sizeof(buf), sg.end);
+            o["end"] = buf;
+            o["weekMask"] = sg.weekMask;
+            o["level"] = sg.level;
+        }
 
         d["lognataktiv"]        = param->lognataktiv;
         d["logpirdetection"]    = param->logpirdetection;
+        d["logbinary"]          = param->logbinary;
+        d["logmaxmb"]           = param->logmaxmb;
         d["aktuelStepfrekvens"] = param->aktuelStepfrekvens;
 
         d["astroEnabled"]          = param->astroEnabled;
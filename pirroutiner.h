@@ -5,14 +5,15 @@
  *
  * Håndterer 2× PIR-indgange og 1× hardware switch (alle aktiv LOW med intern pull-up).
  * Debounce via tæller i timerRoutine() som kaldes 4 Hz (250 ms) fra softlysIrq().
- * Log-events sendes til core0 via FIFO. Tidsstempler beskyttes med pir_mutex.
+ * Log-events postes til core0 via EventRing. Tidsstempler (UTC-epoch fra EpochClock)
+ * ejes af core1 og deles med webserveren via StatusSnapshot.
  */
 
 #include <Arduino.h>
-#include "hardware/rtc.h"
 #include "LysParam.h"
+#include "EpochClock.h"
+#include "EventRing.h"
 
-extern mutex_t pir_mutex;
 extern mutex_t param_mutex;
 
 class pirroutiner {
@@ -37,9 +38,9 @@ private:
     uint8_t pir2_count = 0;
     uint8_t hwsw_count = 0;
 
-    String* pir1_tid;
-    String* pir2_tid;
-    String* hwsw_tid;
+    uint32_t pir1_epoch = 0;    // Sidste aktivering (UTC, 0 = aldrig)
+    uint32_t pir2_epoch = 0;
+    uint32_t hwsw_epoch = 0;
 
     LysParam& param;
 
@@ -59,28 +60,16 @@ private:
         }
     }
 
-    /** Hent tidsstempel fra RTC som string. */
-    String tidSomStrengFraRTC() {
-        datetime_t t;
-        rtc_get_datetime(&t);
-        char buf[20];
-        sprintf(buf, "%04d-%02d-%02d %02d:%02d:%02d", t.year, t.month, t.day, t.hour, t.min, t.sec);
-        return String(buf);
-    }
-
 public:
     /**
      * @brief Constructor.
      * @param pir1 GPIO til PIR1.
      * @param pir2 GPIO til PIR2.
      * @param hwsw GPIO til hardware switch.
-     * @param pir1txt Pointer til PIR1-tidsstempel (mutex-beskyttet).
-     * @param pir2txt Pointer til PIR2-tidsstempel (mutex-beskyttet).
-     * @param hwswtxt Pointer til HW-switch-tidsstempel (mutex-beskyttet).
      * @param p Reference til LysParam.
      */
-    pirroutiner(int pir1, int pir2, int hwsw, String* pir1txt, String* pir2txt, String* hwswtxt, LysParam& p)
-        : pir1_tid(pir1txt), pir2_tid(pir2txt), hwsw_tid(hwswtxt), param(p)
+    pirroutiner(int pir1, int pir2, int hwsw, LysParam& p)
+        : param(p)
     {
         this->pir1ben = pir1;
         this->pir2ben = pir2;
@@ -90,7 +79,7 @@ public:
 
     /**
      * @brief Debounce-rutine – kaldes 4 Hz fra softlysIrq().
-     *        Detekterer PIR/HW aktivering, opdaterer tidsstempler og sender FIFO-events.
+     *        Detekterer PIR/HW aktivering, opdaterer tidsstempler og poster events i EventRing.
      */
     void timerRoutine() {
         // PIR1 (aktiv LOW, debounce >= 3 samples = 750 ms)
@@ -102,13 +91,10 @@ public:
                     pir1_aktiv = true;
                     uint32_t owner = 0;
                     if (mutex_try_enter(&param_mutex, &owner)) {
-                        if (param.logpirdetection) rp2040.fifo.push_nb(pir1_detection);
+                        if (param.logpirdetection) postEvent(pir1_detection);
                         mutex_exit(&param_mutex);
                     }
-                    if (mutex_try_enter(&pir_mutex, &owner)) {
-                        *pir1_tid = tidSomStrengFraRTC();
-                        mutex_exit(&pir_mutex);
-                    }
+                    pir1_epoch = epochClock.now();
                 }
             } else {
                 pir1_count = 0;
@@ -125,13 +111,10 @@ public:
                     pir2_aktiv = true;
                     uint32_t owner = 0;
                     if (mutex_try_enter(&param_mutex, &owner)) {
-                        if (param.logpirdetection) rp2040.fifo.push_nb(pir2_detection);
+                        if (param.logpirdetection) postEvent(pir2_detection);
                         mutex_exit(&param_mutex);
                     }
-                    if (mutex_try_enter(&pir_mutex, &owner)) {
-                        *pir2_tid = tidSomStrengFraRTC();
-                        mutex_exit(&pir_mutex);
-                    }
+                    pir2_epoch = epochClock.now();
                 }
             } else {
                 pir2_count = 0;
@@ -147,13 +130,10 @@ public:
                     hwsw_aktiveret = true;
                     uint32_t owner = 0;
                     if (mutex_try_enter(&param_mutex, &owner)) {
-                        if (param.logpirdetection) rp2040.fifo.push_nb(hwsw_on);
+                        if (param.logpirdetection) postEvent(hwsw_on);
                         mutex_exit(&param_mutex);
                     }
-                    if (mutex_try_enter(&pir_mutex, &owner)) {
-                        *hwsw_tid = tidSomStrengFraRTC();
-                        mutex_exit(&pir_mutex);
-                    }
+                    hwsw_epoch = epochClock.now();
                 }
             } else {
                 hwsw_count = 0;
@@ -163,16 +143,12 @@ public:
         }
     }
 
-    /** Log hardware switch OFF event via FIFO (kald ved overgang aktiv → inaktiv). */
+    /** Log hardware switch OFF event via EventRing (kald ved overgang aktiv → inaktiv). */
     void logHWSWOff() {
         if (param.logpirdetection) {
-            rp2040.fifo.push_nb(hwsw_off);
-        }
-        uint32_t owner = 0;
-        if (mutex_try_enter(&pir_mutex, &owner)) {
-            *hwsw_tid = tidSomStrengFraRTC();
-            mutex_exit(&pir_mutex);
+            postEvent(hwsw_off);
         }
+        hwsw_epoch = epochClock.now();
     }
 
     bool isPIR1Activated() {
@@ -187,11 +163,11 @@ public:
         return wasActivated;
     }
 
-    /** Log software-on event via FIFO. */
+    /** Log software-on event via EventRing. */
     void setswswOn(void) {
         uint32_t owner = 0;
         if (mutex_try_enter(&param_mutex, &owner)) {
-            if (param.logpirdetection) rp2040.fifo.push_nb(swsw_on);
+            if (param.logpirdetection) postEvent(swsw_on);
             mutex_exit(&param_mutex);
         }
     }
@@ -200,10 +176,10 @@ public:
     bool isPIR2Present()  { return pir2_tilstede; }
     bool isPIR1BenLow()   { return pir1_aktiv; }
     bool isPIR2BenLow()   { return pir2_aktiv; }
-    String getPIR1Time()  { return *pir1_tid; }
-    String getPIR2Time()  { return *pir2_tid; }
+    uint32_t getPIR1Epoch() const { return pir1_epoch; }
+    uint32_t getPIR2Epoch() const { return pir2_epoch; }
 
     bool isHWSWPresent()  { return hwsw_tilstede; }
     bool isHWSWBenLow()   { return hwsw_aktiv; }
-    String getHWSWTime()  { return *hwsw_tid; }
+    uint32_t getHWSWEpoch() const { return hwsw_epoch; }
 };
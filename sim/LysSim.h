@@ -0,0 +1,178 @@
+#pragma once
+/**
+ * @file LysSim.h
+ * @brief Deterministisk host-simulering af core1's styringsløkke.
+ *
+ * Kører de rigtige headers (LysAutomatik, dimmerfunktion, pirroutiner, AstroSun)
+ * på et virtuelt ur i samme rækkefølge som loop1() i lysstyringV2.ino:
+ *  - hvert 250 ms: softstart/softsluk-step og PIR-debounce (softlysIrq)
+ *  - hvert sekund: initFromNow første gang, HW-kontakt/tvungen on, PIR-flag
+ *    og automatik->update(lux, pir, UTC)
+ *  - hvert 60. sekund: "NTP-sync" (epochClock.set), som core0 gør
+ *
+ * Én LysSim ad gangen (fakes og epochClock er globale). Intet afhænger af
+ * værtens ur, så samme input giver altid samme forløb.
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+
+#include "LysParam.h"
+#include "LysAutomatik.h"
+#include "Dimmerfunktion.h"
+#include "pirroutiner.h"
+#include "EpochClock.h"
+#include "EventRing.h"
+#include "StatusSnapshot.h"
+
+// Ben og PWM-grænser som lysstyringV2.ino
+#define SIM_DIMMER_START  14000
+#define SIM_DIMMER_MAX    48000
+#define SIM_RELAY_PIN     2
+#define SIM_PWM_PIN       0
+#define SIM_PIR1_PIN      14
+#define SIM_PIR2_PIN      15
+#define SIM_HWSW_PIN      13
+
+#define SIM_TZ "CET-1CEST,M3.5.0/2,M10.5.0/3"
+
+/** Indgange i ét sekund (holdes til næste sekund). PIR/kontakt: true = aktiv (ben LOW). */
+struct SimInput {
+    float lux = 0.0f;
+    bool  pir1 = false;
+    bool  pir2 = false;
+    bool  hwsw = false;
+};
+
+/** Tilstand efter ét sekund. */
+struct SimSample {
+    uint32_t epoch;     // UTC
+    uint8_t  state;     // AutoState
+    int      lys;       // Aktuel lysprocent (dimmer)
+    int      target;    // Dimmerens mål (setlysiprocentSoft) – skifter kun ved beslutninger, ikke ved ramper
+    int      pwm;       // Seneste analogWrite på dimmer-benet
+    bool     nat;       // nataktiv
+    bool     forced;    // Tvungen on (HW-kontakt)
+
+    bool sameAs(const SimSample& o) const {
+        return state == o.state && lys == o.lys && pwm == o.pwm && nat == o.nat && forced == o.forced;
+    }
+};
+
+class LysSim {
+public:
+    LysParam param;
+
+    /** Start uret på UTC-epoch (som efter første NTP-sync). */
+    explicit LysSim(const LysParam& p, uint32_t startEpoch)
+        : param(p),
+          dimmer(SIM_RELAY_PIN, SIM_PWM_PIN, SIM_DIMMER_START, SIM_DIMMER_MAX),
+          pir(SIM_PIR1_PIN, SIM_PIR2_PIN, SIM_HWSW_PIN, param),
+          automatik(param, &dimmer) {
+        setenv("TZ", SIM_TZ, 1);
+        tzset();
+        epoch = startEpoch;
+        epochClock.set(epoch);
+        lysparamRev++;      // Ny param-instans: DaySchedule oversættes forfra
+    }
+
+    /** Simulér ét sekund med in som indgange; returnerer tilstanden ved sekundets tick. */
+    SimSample step(const SimInput& in) {
+        setPin(SIM_PIR1_PIN, in.pir1);
+        setPin(SIM_PIR2_PIN, in.pir2);
+        setPin(SIM_HWSW_PIN, in.hwsw);
+
+        for (int q = 0; q < 4; q++) {       // softlysTimer 250 ms
+            fake::advanceMs(250);
+            if (dimmer.softstartAktiv()) dimmer.softstartStep();
+            if (dimmer.softslukAktiv())  dimmer.softslukStep();
+            pir.timerRoutine();
+        }
+        epoch++;
+        if (epoch % 60 == 0) epochClock.set(epoch);     // NTP hvert minut (og millis-wrap)
+        tick(in.lux);
+        drainEvents();
+
+        return SimSample{epoch, (uint8_t)automatik.getAutoState(), dimmer.returneraktuelvaerdi(),
+                         dimmer.returnersetvaerdi(), fake::pwm[SIM_PWM_PIN], automatik.getNataktiv(), forcedOn};
+    }
+
+    /** Param ændret "fra web": ny revision, planen oversættes ved næste tick. */
+    void paramChanged() { lysparamRev++; }
+
+    uint32_t now() const { return epoch; }
+    uint32_t events(uint8_t code) const { return code < LYSLOG_EVENT_COUNT ? eventCount[code] : 0; }
+
+    /** Tidtag hvert automatik.update() (benchmark); updateNs/updateCalls akkumuleres. */
+    bool     timeUpdate = false;
+    uint64_t updateNs = 0;
+    uint64_t updateCalls = 0;
+
+private:
+    dimmerfunktion dimmer;
+    pirroutiner    pir;
+    LysAutomatik   automatik;
+
+    uint32_t epoch = 0;
+    bool initDone = false;
+    bool hwaktiv = false;
+    bool hwaktivlocal = false;
+    bool forcedOn = false;
+    uint32_t eventCount[LYSLOG_EVENT_COUNT] = {};
+
+    static void setPin(int pin, bool active) { fake::pinLevel[pin] = active ? LOW : HIGH; }
+
+    /** Samme forløb som 1 Hz-delen af loop1() (uden sensorer/historik). */
+    void tick(float lux) {
+        uint32_t ntpLocal = epochClock.now();
+
+        if (!initDone && ntpLocal >= 1700000000UL) {
+            automatik.initFromNow(lux, (time_t)ntpLocal);
+            initDone = true;
+        }
+
+        bool tvungeton = false;
+        if (pir.isHWSWBenLow()) hwaktiv = true;
+        else if (hwaktiv) { hwaktiv = false; pir.logHWSWOff(); }
+        if (hwaktiv) tvungeton = true;
+
+        if (!tvungeton) {
+            if (hwaktivlocal) {
+                hwaktivlocal = false;
+                automatik.forceOff();
+            }
+            bool pirstatus = false;
+            if (pir.isPIR1Activated()) pirstatus = true;
+            if (pir.isPIR2Activated()) pirstatus = true;
+
+            uint32_t owner = 0;
+            if (mutex_try_enter(&param_mutex, &owner)) {
+                if (timeUpdate) {
+                    auto t0 = std::chrono::steady_clock::now();
+                    automatik.update(lux, pirstatus, (time_t)ntpLocal);
+                    auto t1 = std::chrono::steady_clock::now();
+                    updateNs += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+                    updateCalls++;
+                } else {
+                    automatik.update(lux, pirstatus, (time_t)ntpLocal);
+                }
+                mutex_exit(&param_mutex);
+            }
+        } else if (!hwaktivlocal) {
+            dimmer.taend();
+            hwaktivlocal = true;
+        }
+        forcedOn = tvungeton;
+    }
+
+    /** Core0's rolle: tøm EventRing (her kun optælling pr. kode). */
+    void drainEvents() {
+        LysEvent e;
+        while (eventRing.pop(e)) {
+            if (e.event < LYSLOG_EVENT_COUNT) eventCount[e.event]++;
+        }
+    }
+};
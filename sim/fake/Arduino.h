@@ -0,0 +1,106 @@
+#pragma once
+/**
+ * @file Arduino.h (host)
+ * @brief Tynd fake af Arduino-pico til host-build af styringslogikken (sim/).
+ *
+ * Kun det de header-only klasser (LysAutomatik, dimmerfunktion, pirroutiner,
+ * AstroSun, EpochClock, EventRing) faktisk bruger:
+ *  - millis()/micros()/delay() kører på et virtuelt ur (fake::nowUs), som
+ *    simulatoren stiller frem – intet læser værtens ur.
+ *  - analogWrite()/digitalWrite() gemmes pr. pin, digitalRead() læser samme
+ *    tabel (simulatoren sætter PIR/kontakt-indgange der). INPUT_PULLUP giver HIGH.
+ *  - mutex_t er en simpel lås (én tråd): try_enter lykkes når den er fri.
+ *  - rp2040.fifo tæller kun dørklokker.
+ *  - Serial skriver til stderr; String har kun det LysLog's overload bruger.
+ */
+
+#include <cmath>
+#include <math.h>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <string>
+
+#define LOW          0
+#define HIGH         1
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+
+#define FAKE_PINS 30
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+namespace fake {
+extern uint64_t nowUs;                  // Virtuelt ur: µs siden "boot"
+extern int      pinLevel[FAKE_PINS];    // digitalWrite / indgange sat af simulatoren
+extern int      pwm[FAKE_PINS];         // Seneste analogWrite pr. pin
+extern uint32_t analogWrites;           // Antal analogWrite-kald
+extern uint32_t doorbells;              // rp2040.fifo.push_nb
+
+inline void advanceMs(uint32_t ms) { nowUs += (uint64_t)ms * 1000u; }
+}
+
+inline uint32_t millis() { return (uint32_t)(fake::nowUs / 1000u); }     // 32 bit som på RP2040
+inline uint32_t micros() { return (uint32_t)fake::nowUs; }
+inline void delay(unsigned long ms) { fake::advanceMs((uint32_t)ms); }
+
+inline void pinMode(int pin, int mode) {
+    if (pin >= 0 && pin < FAKE_PINS && mode == INPUT_PULLUP) fake::pinLevel[pin] = HIGH;
+}
+inline void digitalWrite(int pin, int v) {
+    if (pin >= 0 && pin < FAKE_PINS) fake::pinLevel[pin] = v ? HIGH : LOW;
+}
+inline int digitalRead(int pin) { return (pin >= 0 && pin < FAKE_PINS) ? fake::pinLevel[pin] : LOW; }
+
+inline void analogWriteRange(uint32_t) {}
+inline void analogWriteFreq(uint32_t) {}
+inline void analogWrite(int pin, int v) {
+    if (pin >= 0 && pin < FAKE_PINS) fake::pwm[pin] = v;
+    fake::analogWrites++;
+}
+
+struct FakeSerial {
+    void printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        va_list ap;
+        va_start(ap, fmt);
+        vfprintf(stderr, fmt, ap);
+        va_end(ap);
+    }
+    void println(const char* s) { fprintf(stderr, "%s\n", s); }
+};
+extern FakeSerial Serial;
+
+class String {
+public:
+    String(const char* s = "") : s(s) {}
+    const char* c_str() const { return s.c_str(); }
+private:
+    std::string s;
+};
+
+// pico/mutex.h
+struct mutex_t {
+    bool locked = false;
+};
+inline void mutex_init(mutex_t* m) { m->locked = false; }
+inline void mutex_enter_blocking(mutex_t* m) { m->locked = true; }
+inline bool mutex_try_enter(mutex_t* m, uint32_t* owner) {
+    if (owner) *owner = 0;
+    if (m->locked) return false;
+    m->locked = true;
+    return true;
+}
+inline void mutex_exit(mutex_t* m) { m->locked = false; }
+
+// rp2040.fifo (kun dørklokke til core0)
+struct FakeFifo {
+    bool push_nb(uint32_t) { fake::doorbells++; return true; }
+};
+struct FakeRP2040 {
+    FakeFifo fifo;
+};
+extern FakeRP2040 rp2040;
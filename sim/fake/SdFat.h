@@ -0,0 +1,166 @@
+#pragma once
+/**
+ * @file SdFat.h (host)
+ * @brief Fake SdFat i RAM til host-check af LysLog (sim/logcheck.cpp).
+ *
+ * Stier er nøgler i fake::sdNodes; en fil er en delt byte-vektor, så et åbent
+ * håndtag læser videre efter rename/remove ligesom clusters på et rigtigt kort.
+ * write() lander straks i vektoren – "strømsvigt" simuleres ved at smide
+ * LysLog-objektet (og dets RAM-buffere) væk uden flush().
+ * fake::sdFailRename får rename() til at fejle (rotation uden arkiv).
+ */
+
+#include <fcntl.h>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct FakeSdNode {
+    bool dir = false;
+    std::shared_ptr<std::vector<uint8_t>> data;
+};
+
+namespace fake {
+extern std::map<std::string, FakeSdNode> sdNodes;
+extern bool sdFailRename;
+}
+
+class FsFile {
+public:
+    bool isOpen() const { return open_; }
+    explicit operator bool() const { return open_; }
+    bool isDir() const { return open_ && dir; }
+
+    bool close() {
+        open_ = false;
+        data.reset();
+        return true;
+    }
+    bool sync() { return open_; }
+
+    size_t write(const void* p, size_t n) {
+        if (!open_ || dir || (flags & O_ACCMODE) == O_RDONLY) return 0;
+        if (flags & O_APPEND) pos = data->size();
+        if (pos + n > data->size()) data->resize(pos + n);
+        memcpy(data->data() + pos, p, n);
+        pos += n;
+        return n;
+    }
+    int read(void* p, size_t n) {
+        if (!open_ || dir) return -1;
+        if (pos >= data->size()) return 0;
+        if (n > data->size() - pos) n = data->size() - pos;
+        memcpy(p, data->data() + pos, n);
+        pos += n;
+        return (int)n;
+    }
+    bool seekSet(uint64_t p) {
+        if (!open_ || dir || p > data->size()) return false;
+        pos = (size_t)p;
+        return true;
+    }
+    uint64_t fileSize() const { return open_ && !dir ? data->size() : 0; }
+    uint64_t curPosition() const { return pos; }
+    bool truncate() {
+        if (!open_ || dir) return false;
+        data->resize(pos);
+        return true;
+    }
+    bool preAllocate(uint64_t) { return open_; }
+    uint32_t firstSector() const { return open_ && !dir && !data->empty() ? (uint32_t)(uintptr_t)data.get() : 0; }
+
+    size_t getName(char* buf, size_t size) {
+        size_t slash = path.rfind('/');
+        snprintf(buf, size, "%s", path.c_str() + (slash == std::string::npos ? 0 : slash + 1));
+        return strlen(buf);
+    }
+
+    void rewind() { pos = 0; }
+
+    /** Næste entry i mappen dir (sorteret efter navn). */
+    bool openNext(FsFile* d, int oflag = O_RDONLY) {
+        if (!d || !d->isDir()) return false;
+        std::string prefix = d->path == "/" ? "/" : d->path + "/";
+        size_t i = 0;
+        for (auto& kv : fake::sdNodes) {
+            const std::string& k = kv.first;
+            if (k.size() <= prefix.size() || k.compare(0, prefix.size(), prefix) != 0) continue;
+            if (k.find('/', prefix.size()) != std::string::npos) continue;
+            if (i++ < d->pos) continue;
+            d->pos++;
+            return openNode(k, kv.second, oflag);
+        }
+        return false;
+    }
+
+private:
+    friend class SdFat;
+    bool open_ = false;
+    bool dir = false;
+    int flags = 0;
+    size_t pos = 0;
+    std::string path;
+    std::shared_ptr<std::vector<uint8_t>> data;
+
+    bool openNode(const std::string& p, const FakeSdNode& n, int oflag) {
+        open_ = true;
+        dir = n.dir;
+        flags = oflag;
+        pos = 0;
+        path = p;
+        data = n.data;
+        return true;
+    }
+};
+
+class SdFat {
+public:
+    FsFile open(const char* path, int oflag = O_RDONLY) {
+        FsFile f;
+        auto it = fake::sdNodes.find(path);
+        if (it == fake::sdNodes.end()) {
+            if (!(oflag & O_CREAT) || !parentExists(path)) return f;
+            FakeSdNode n;
+            n.data = std::make_shared<std::vector<uint8_t>>();
+            it = fake::sdNodes.emplace(path, n).first;
+        } else if (!it->second.dir && (oflag & O_TRUNC)) {
+            it->second.data = std::make_shared<std::vector<uint8_t>>();   // Nye "clusters"
+        }
+        f.openNode(it->first, it->second, oflag);
+        return f;
+    }
+    bool exists(const char* path) { return fake::sdNodes.count(path) != 0; }
+    bool mkdir(const char* path, bool = true) {
+        if (exists(path)) return false;
+        FakeSdNode n;
+        n.dir = true;
+        fake::sdNodes[path] = n;
+        return true;
+    }
+    bool remove(const char* path) {
+        auto it = fake::sdNodes.find(path);
+        if (it == fake::sdNodes.end() || it->second.dir) return false;
+        fake::sdNodes.erase(it);
+        return true;
+    }
+    bool rename(const char* from, const char* to) {
+        if (fake::sdFailRename || exists(to) || !parentExists(to)) return false;
+        auto it = fake::sdNodes.find(from);
+        if (it == fake::sdNodes.end()) return false;
+        FakeSdNode n = it->second;
+        fake::sdNodes.erase(it);
+        fake::sdNodes[to] = n;
+        return true;
+    }
+
+private:
+    bool parentExists(const char* path) {
+        const char* slash = strrchr(path, '/');
+        if (!slash || slash == path) return true;
+        auto it = fake::sdNodes.find(std::string(path, slash - path));
+        return it != fake::sdNodes.end() && it->second.dir;
+    }
+};
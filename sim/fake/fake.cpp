@@ -0,0 +1,30 @@
+/**
+ * @file fake.cpp
+ * @brief Tilstand for host-fakes + de globale objekter lysstyringV2.ino normalt definerer.
+ */
+
+#include <Arduino.h>
+#include <SdFat.h>
+
+#include "EpochClock.h"
+#include "EventRing.h"
+
+namespace fake {
+uint64_t nowUs = 0;
+int      pinLevel[FAKE_PINS] = {};
+int      pwm[FAKE_PINS] = {};
+uint32_t analogWrites = 0;
+uint32_t doorbells = 0;
+
+std::map<std::string, FakeSdNode> sdNodes;
+bool sdFailRename = false;
+}
+
+FakeRP2040 rp2040;
+FakeSerial Serial;
+
+// Fra lysstyringV2.ino
+EpochClock epochClock;
+EventRing  eventRing;
+mutex_t    param_mutex;
+uint32_t   lysparamRev = 0;
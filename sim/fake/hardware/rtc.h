@@ -0,0 +1,39 @@
+#pragma once
+/**
+ * @file hardware/rtc.h (host)
+ * @brief Fake RP2040-RTC: rtc_get_datetime() giver lokal tid (TZ) for EpochClock.
+ *
+ * På controlleren sætter core0 RTC'en ud fra NTP; her følger den simulatorens
+ * virtuelle ur, så kode der læser dato fra RTC'en ser samme dag som automatikken.
+ */
+
+#include <Arduino.h>
+#include <ctime>
+
+#include "EpochClock.h"
+
+struct datetime_t {
+    int16_t year;
+    int8_t  month;
+    int8_t  day;
+    int8_t  dotw;
+    int8_t  hour;
+    int8_t  min;
+    int8_t  sec;
+};
+
+inline void rtc_init() {}
+inline bool rtc_set_datetime(const datetime_t*) { return true; }     // Tiden ejes af epochClock
+inline bool rtc_get_datetime(datetime_t* t) {
+    time_t now = (time_t)epochClock.now();
+    tm ti;
+    if (now == 0 || !localtime_r(&now, &ti)) return false;
+    t->year  = (int16_t)(ti.tm_year + 1900);
+    t->month = (int8_t)(ti.tm_mon + 1);
+    t->day   = (int8_t)ti.tm_mday;
+    t->dotw  = (int8_t)ti.tm_wday;
+    t->hour  = (int8_t)ti.tm_hour;
+    t->min   = (int8_t)ti.tm_min;
+    t->sec   = (int8_t)ti.tm_sec;
+    return true;
+}
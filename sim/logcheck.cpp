@@ -0,0 +1,129 @@
+/**
+ * @file logcheck.cpp
+ * @brief Host-check af LysLog's dato-indeks og forespørgsler mod en SdFat-fake i RAM.
+ *
+ * Hvert scenarie starter med et tomt "kort" (fake::sdNodes) og skriver linjer til
+ * hardware.log med faste tidsstempler, så rotation og indeks-entries lander
+ * deterministisk. Exit-kode 1 hvis et check fejler.
+ *
+ * Brug:
+ *     logcheck
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+#include <SdFat.h>
+#include "lyslog.h"
+
+SdFat sd;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("%s  %s\n", ok ? "ok  " : "FEJL", what);
+    if (!ok) failures++;
+}
+
+/** Lokal tid (TZ) → UTC-epoch. */
+static uint32_t at(int y, int mo, int d, int h = 12) {
+    tm t = {};
+    t.tm_year = y - 1900;
+    t.tm_mon = mo - 1;
+    t.tm_mday = d;
+    t.tm_hour = h;
+    t.tm_isdst = -1;
+    return (uint32_t)mktime(&t);
+}
+
+static void resetCard() {
+    fake::sdNodes.clear();
+    fake::sdFailRename = false;
+}
+
+static uint32_t lineCount(const std::string& s) {
+    uint32_t n = 0;
+    for (char c : s) n += (c == '\n');
+    return n;
+}
+
+/** query() → de bytes der ville blive sendt; false hvis query() afviser. */
+static bool runQuery(LysLog& log, uint32_t from, uint32_t to, std::string& out, bool& more) {
+    FsFile f;
+    uint32_t len = 0;
+    more = false;
+    out.clear();
+    if (!log.query(LOG_HW, from, to, 0, f, len, more)) return false;
+    out.resize(len);
+    return len == 0 || f.read(&out[0], len) == (int)len;
+}
+
+/** Linjer i september (arkiveres) og oktober (aktiv fil). */
+static void checkQueryRanges() {
+    resetCard();
+    LysLog log(sd);
+    log.logHardware("sep05", at(2026, 9, 5));
+    log.logHardware("sep10", at(2026, 9, 10));
+    log.logHardware("sep20", at(2026, 9, 20));
+    log.logHardware("okt02", at(2026, 10, 2));
+    log.logHardware("okt15", at(2026, 10, 15));
+    log.flush();
+    check(sd.exists("/log/2026-09-hardware.log"), "september er arkiveret ved første oktober-linje");
+
+    std::string s;
+    bool more;
+    check(runQuery(log, 0, 20260910, s, more) && s.empty() && !more,
+          "to før den aktive fils første dato (ingen from) → tomt svar");
+    check(runQuery(log, 20260905, 20260910, s, more) && lineCount(s) == 2 && s.find("sep20") == std::string::npos &&
+              !more,
+          "from/to inden for arkivet → kun de to datoer");
+    check(runQuery(log, 20260915, 0, s, more) && lineCount(s) == 1 && s.find("sep20") != std::string::npos && more,
+          "from i arkivet uden to → resten af arkivet, more sat");
+    check(runQuery(log, 20261016, 20261020, s, more) == false, "from efter sidste dato → afvist");
+    check(runQuery(log, 0, 20261002, s, more) && lineCount(s) == 1 && s.find("okt02") != std::string::npos,
+          "to i den aktive fil → linjer til og med to");
+    check(runQuery(log, 20261001, 0, s, more) && lineCount(s) == 2 && !more, "from i den aktive fil → hele måneden");
+}
+
+/**
+ * Strømsvigt mens dagens sidste linjer ligger i RAM-bufferen: første linje på en ny dato
+ * skriver en indeks-entry. Efter "reboot" (nyt LysLog uden flush) skal entry'en stadig pege
+ * på en linjestart i filen, så from= finder dagens linjer.
+ */
+static void checkIndexAfterPowerLoss() {
+    resetCard();
+    LysLog* log = new LysLog(sd);
+    log->logHardware("okt01 a", at(2026, 10, 1, 8));
+    log->flush();
+    log->logHardware("okt01 b", at(2026, 10, 1, 9));      // Kun i RAM
+    log->logHardware("okt01 c", at(2026, 10, 1, 10));
+    log->logHardware("okt02 tabt", at(2026, 10, 2, 8));   // Ny dato → indeks-entry
+    delete log;                                           // Strømsvigt: ingen flush()
+
+    LysLog after(sd);
+    after.logHardware("okt02 efter reboot", at(2026, 10, 2, 9));
+    after.flush();
+
+    std::string s;
+    bool more;
+    check(runQuery(after, 20261002, 0, s, more) && s.compare(0, 12, "[2026-10-02 ") == 0 &&
+              s.find("efter reboot") != std::string::npos,
+          "indeks-entry efter strømsvigt peger på dagens første bevarede linje");
+    check(runQuery(after, 20261001, 20261001, s, more) && s.find("okt02") == std::string::npos,
+          "dagen før slutter hvor den nye dato begynder");
+}
+
+int main() {
+    setenv("TZ", "CET-1CEST,M3.5.0/2,M10.5.0/3", 1);
+    tzset();
+    epochClock.set(at(2026, 10, 17));
+
+    checkQueryRanges();
+    checkIndexAfterPowerLoss();
+
+    printf("%s\n", failures ? "logcheck: FEJL" : "logcheck: alle checks ok");
+    return failures ? 1 : 0;
+}
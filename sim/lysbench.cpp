@@ -0,0 +1,307 @@
+/**
+ * @file lysbench.cpp
+ * @brief Års-benchmark af styringslogikken + regression mod golden tidslinjer.
+ *
+ * Kører LysSim 365 døgn × 86400 tick pr. mode (Tid, Klokken, Astro med segmenter)
+ * med syntetisk lux (dagkurve fra AstroSun + deterministiske skyer) og PIR.
+ * Rapporterer pr. mode:
+ *  - ns/tick:        tid i automatik.update() (minus målt overhead for steady_clock)
+ *  - allocs/tick:    operator new under step() (skal være 0)
+ *  - localtime_r:    kald under step() i alt og pr. døgn (linket med --wrap=localtime_r)
+ *  - skift:          antal linjer i tidslinjen
+ *
+ * Tidslinjen er én linje pr. ændring af tilstand, dimmer-mål eller nataktiv
+ * ("YYYY-MM-DD HH:MM:SS STATE mål nat", lokal tid) og sammenlignes med
+ * sim/golden/<mode>.txt, så optimering af planlægningen ikke i stilhed flytter
+ * hvornår lyset skifter.
+ *
+ * Brug:
+ *     lysbench [--days N] [--golden DIR | --write-golden DIR] [--mode Tid|Klokken|Astro]
+ *
+ * Exit-kode 1 hvis en tidslinje afviger fra golden.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "LysSim.h"
+
+// ---------- Tællere: heap og localtime_r ----------
+static uint64_t allocCount = 0;
+static uint64_t localtimeCount = 0;
+
+void* operator new(size_t n) {
+    allocCount++;
+    void* p = malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+extern "C" {
+struct tm* __real_localtime_r(const time_t* t, struct tm* out);
+struct tm* __wrap_localtime_r(const time_t* t, struct tm* out) {
+    localtimeCount++;
+    return __real_localtime_r(t, out);
+}
+}
+
+// ---------- Syntetiske indgange ----------
+/** Deterministisk LCG (samme sekvens på alle platforme). */
+struct Lcg {
+    uint32_t s;
+    uint32_t next() { return s = s * 1664525u + 1013904223u; }
+    bool chance(uint32_t perMille) { return (next() >> 8) % 1000u < perMille; }
+};
+
+/**
+ * Lux over døgnet: 0.3 om natten, lineær rampe ±40 min om sol-tiderne til 300,
+ * dag op til ~2000. Skyer: pr. 10-min blok 6 % risiko for lux × 0.02 (giver
+ * skift omkring luxstart i skumringen). PIR1/PIR2: pr. 10-min blok 2 %/1 %,
+ * aktiv de første 5 sekunder.
+ */
+class SyntheticInput {
+public:
+    explicit SyntheticInput(const LysParam& p) : p(p) {}
+
+    SimInput at(uint32_t epoch) {
+        time_t t = (time_t)epoch;
+        tm lt;
+        localtime_r(&t, &lt);
+        if (lt.tm_yday != yday) newDay(lt);
+
+        int sec = lt.tm_hour * 3600 + lt.tm_min * 60 + lt.tm_sec;
+        int block = sec / 600;
+        SimInput in;
+        in.lux = dayLux(sec) * (cloud[block] ? 0.02f : 1.0f);
+        in.pir1 = pir1[block] && sec % 600 < 5;
+        in.pir2 = pir2[block] && sec % 600 < 5;
+        return in;
+    }
+
+private:
+    const LysParam& p;
+    int yday = -1;
+    int riseSec = 6 * 3600, setSec = 18 * 3600;
+    bool cloud[144], pir1[144], pir2[144];
+
+    void newDay(const tm& lt) {
+        yday = lt.tm_yday;
+        AstroTimes a = AstroSun::computeLocalTimes(lt.tm_year + 1900, lt.tm_mon + 1, lt.tm_mday, p.astroLat, p.astroLon);
+        if (a.valid()) {
+            riseSec = a.sunriseMin * 60;
+            setSec = a.sunsetMin * 60;
+        }
+        Lcg r{(uint32_t)((lt.tm_year + 1900) * 1000 + lt.tm_yday)};
+        for (int i = 0; i < 144; i++) {
+            cloud[i] = r.chance(60);
+            pir1[i] = r.chance(20);
+            pir2[i] = r.chance(10);
+        }
+    }
+
+    float dayLux(int sec) const {
+        const int ramp = 40 * 60;
+        if (sec < riseSec - ramp || sec >= setSec + ramp) return 0.3f;
+        if (sec < riseSec + ramp) return 0.3f + 300.0f * (sec - (riseSec - ramp)) / (2.0f * ramp);
+        if (sec >= setSec - ramp) return 0.3f + 300.0f * ((setSec + ramp) - sec) / (2.0f * ramp);
+        float mid = (riseSec + setSec) / 2.0f;
+        float half = (setSec - riseSec) / 2.0f - ramp;
+        float x = half > 0 ? 1.0f - fabsf(sec - mid) / half : 0.0f;
+        return 300.0f + 1700.0f * x;
+    }
+};
+
+// ---------- Modes ----------
+struct BenchMode {
+    const char* name;       // Også filnavn i golden/ (lowercase)
+    LysParam param;
+};
+
+static void addSeg(LysParam& p, const char* start, const char* end, uint8_t mask, int8_t level) {
+    LysSegment& sg = p.segs[p.segCount++];
+    sg.enabled = true;
+    parseSegTime(start, sg.start);
+    parseSegTime(end, sg.end);
+    sg.weekMask = mask;
+    sg.level = level;
+}
+
+static std::vector<BenchMode> benchModes() {
+    std::vector<BenchMode> m(3);
+
+    m[0].name = "tid";
+    m[0].param.styringsvalg = MODE_TID;
+
+    m[1].name = "klokken";
+    m[1].param.styringsvalg = MODE_KLOKKEN;
+    m[1].param.slutKlokkeTimer = 22;
+    m[1].param.slutKlokkeMinutter = 30;
+    addSeg(m[1].param, "05:30", "07:00", 0x3E, SEG_LEVEL_PWMA);        // Man–fre morgen
+
+    m[2].name = "astro";
+    m[2].param.styringsvalg = MODE_ASTRO;
+    m[2].param.astroEnabled = true;
+    m[2].param.astroSunsetOffsetMin = 10;
+    addSeg(m[2].param, "05:30", "solopgang", 0x3E, SEG_LEVEL_PWMA);    // Hverdagsmorgen til solopgang
+    addSeg(m[2].param, "solnedgang-15", "23:30", 0x41, 60);            // Weekend-aften, 60 %
+    addSeg(m[2].param, "06:00", "07:00", 0x7F, 40);                    // Overlapper segment 2 (lavere prioritet)
+    return m;
+}
+
+// ---------- Kørsel ----------
+struct BenchResult {
+    uint64_t ticks = 0;
+    double   nsPerTick = 0;
+    double   wallSec = 0;
+    uint64_t allocs = 0;
+    uint64_t localtimeCalls = 0;
+    std::vector<std::string> timeline;
+};
+
+/** Gennemsnitligt målt interval mellem to steady_clock::now() uden noget imellem (trækkes fra). */
+static double clockOverheadNs() {
+    const int n = 1000000;
+    uint64_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        auto a = std::chrono::steady_clock::now();
+        auto b = std::chrono::steady_clock::now();
+        sum += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count();
+    }
+    return (double)sum / n;
+}
+
+static BenchResult runMode(const BenchMode& m, uint32_t start, int days, double overheadNs) {
+    BenchResult r;
+    r.timeline.reserve(32768);
+    SyntheticInput input(m.param);
+    LysSim sim(m.param, start);
+    sim.timeUpdate = true;
+
+    SimSample last{};
+    bool first = true;
+    const uint64_t ticks = (uint64_t)days * 86400u;
+    auto w0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < ticks; i++) {
+        SimInput in = input.at(sim.now());
+
+        uint64_t a0 = allocCount, l0 = localtimeCount;
+        SimSample s = sim.step(in);
+        r.allocs += allocCount - a0;
+        r.localtimeCalls += localtimeCount - l0;
+
+        if (first || s.state != last.state || s.target != last.target || s.nat != last.nat) {
+            first = false;
+            last = s;
+            char ts[20], line[64];
+            EpochClock::formatLocal(s.epoch, ts, sizeof(ts));
+            snprintf(line, sizeof(line), "%s %s %d %d", ts, autoStateName(s.state), s.target, s.nat ? 1 : 0);
+            r.timeline.emplace_back(line);
+        }
+    }
+    auto w1 = std::chrono::steady_clock::now();
+
+    r.ticks = ticks;
+    double ns = sim.updateCalls ? (double)sim.updateNs / sim.updateCalls - overheadNs : 0;
+    r.nsPerTick = ns > 0 ? ns : 0;
+    r.wallSec = std::chrono::duration<double>(w1 - w0).count();
+    return r;
+}
+
+static std::string goldenPath(const char* dir, const char* name) { return std::string(dir) + "/" + name + ".txt"; }
+
+static bool writeGolden(const char* dir, const BenchMode& m, const BenchResult& r) {
+    std::string path = goldenPath(dir, m.name);
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) {
+        fprintf(stderr, "Kan ikke skrive %s\n", path.c_str());
+        return false;
+    }
+    for (const std::string& l : r.timeline) fprintf(f, "%s\n", l.c_str());
+    fclose(f);
+    return true;
+}
+
+/** Sammenlign med golden; skriv første afvigelser. true hvis ens. */
+static bool checkGolden(const char* dir, const BenchMode& m, const BenchResult& r) {
+    std::string path = goldenPath(dir, m.name);
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) {
+        fprintf(stderr, "%s: mangler golden %s\n", m.name, path.c_str());
+        return false;
+    }
+    std::vector<std::string> golden;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        golden.emplace_back(line);
+    }
+    fclose(f);
+
+    size_t n = golden.size() > r.timeline.size() ? golden.size() : r.timeline.size();
+    int shown = 0;
+    size_t diffs = 0;
+    for (size_t i = 0; i < n; i++) {
+        const char* g = i < golden.size() ? golden[i].c_str() : "<slut>";
+        const char* t = i < r.timeline.size() ? r.timeline[i].c_str() : "<slut>";
+        if (strcmp(g, t) == 0) continue;
+        diffs++;
+        if (shown++ < 10) fprintf(stderr, "%s:%zu\n  golden: %s\n  nu:     %s\n", m.name, i + 1, g, t);
+    }
+    if (diffs) fprintf(stderr, "%s: %zu linjer afviger fra %s\n", m.name, diffs, path.c_str());
+    return diffs == 0;
+}
+
+int main(int argc, char** argv) {
+    int days = 365;
+    const char* golden = nullptr;
+    const char* writeDir = nullptr;
+    const char* only = nullptr;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--days")) days = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--golden")) golden = argv[i + 1];
+        else if (!strcmp(argv[i], "--write-golden")) writeDir = argv[i + 1];
+        else if (!strcmp(argv[i], "--mode")) only = argv[i + 1];
+        else {
+            fprintf(stderr, "Brug: lysbench [--days N] [--golden DIR | --write-golden DIR] [--mode Tid|Klokken|Astro]\n");
+            return 2;
+        }
+    }
+    if (days < 1) days = 1;
+
+    setenv("TZ", SIM_TZ, 1);
+    tzset();
+    tm t0 = {};
+    t0.tm_year = 2026 - 1900;
+    t0.tm_mon = 0;
+    t0.tm_mday = 1;
+    t0.tm_isdst = -1;
+    uint32_t start = (uint32_t)mktime(&t0);
+
+    double overhead = clockOverheadNs();
+    printf("%-8s %12s %10s %12s %14s %12s %8s %8s\n", "mode", "ticks", "ns/tick", "allocs/tick", "localtime_r",
+           "pr. døgn", "skift", "sek");
+
+    bool ok = true;
+    for (const BenchMode& m : benchModes()) {
+        if (only && strcasecmp(only, m.name) != 0) continue;
+        BenchResult r = runMode(m, start, days, overhead);
+        printf("%-8s %12llu %10.1f %12.6f %14llu %12.1f %8zu %8.2f\n", m.name, (unsigned long long)r.ticks,
+               r.nsPerTick, (double)r.allocs / r.ticks, (unsigned long long)r.localtimeCalls,
+               (double)r.localtimeCalls / days, r.timeline.size(), r.wallSec);
+        fflush(stdout);
+        if (writeDir) ok = writeGolden(writeDir, m, r) && ok;
+        else if (golden) ok = checkGolden(golden, m, r) && ok;
+    }
+    return ok ? 0 : 1;
+}
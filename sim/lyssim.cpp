@@ -0,0 +1,208 @@
+/**
+ * @file lyssim.cpp
+ * @brief Afspil lux/PIR-forløb fra CSV gennem styringslogikken og skriv et trace pr. sekund.
+ *
+ * Byg (fra repo-roden):
+ *     cmake -S sim -B build-sim && cmake --build build-sim
+ *
+ * Brug:
+ *     lyssim [options] input.csv > trace.csv
+ *
+ * Input (CSV, '#' = kommentar, første linje må være en header):
+ *     time,lux,pir1,pir2[,hwsw]
+ *   time er UTC-epoch eller lokal tid "YYYY-MM-DD HH:MM:SS" (CET/CEST).
+ *   Værdierne holdes til næste række; pir/hwsw = 1 holder indgangen aktiv.
+ *   Simuleringen kører fra første til sidste rækkes tidspunkt.
+ *
+ * Output (CSV): epoch,local,state,lys,pwm,nat,forced – ét sekund pr. linje,
+ * eller kun linjer hvor noget ændrer sig med --changes.
+ *
+ * Options:
+ *     --mode Tid|Klokken|Astro    --klokken HH:MM (segment 1 slut)
+ *     --seg START,END[,MASK[,LEVEL]]  tillægssegment (gentages), fx --seg solnedgang+15,23:30,62,60
+ *     --lat N --lon N --sunset-offset MIN --sunrise-offset MIN
+ *     --pwm A,C,E,G --timer A,C,E --luxstart LUX --delay SEK
+ *     --changes
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include "LysSim.h"
+
+struct CsvRow {
+    uint32_t epoch;
+    SimInput in;
+};
+
+static bool parseTime(const char* s, uint32_t& out) {
+    int Y, M, D, h, m, sec;
+    if (sscanf(s, "%d-%d-%d %d:%d:%d", &Y, &M, &D, &h, &m, &sec) == 6) {
+        tm t = {};
+        t.tm_year = Y - 1900;
+        t.tm_mon = M - 1;
+        t.tm_mday = D;
+        t.tm_hour = h;
+        t.tm_min = m;
+        t.tm_sec = sec;
+        t.tm_isdst = -1;
+        time_t e = mktime(&t);
+        if (e == (time_t)-1) return false;
+        out = (uint32_t)e;
+        return true;
+    }
+    char* end;
+    unsigned long v = strtoul(s, &end, 10);
+    if (end == s) return false;
+    out = (uint32_t)v;
+    return true;
+}
+
+static bool readCsv(const char* path, std::vector<CsvRow>& rows) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Kan ikke åbne %s\n", path);
+        return false;
+    }
+    char line[256];
+    int lineNo = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+        char* p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+
+        char* f0 = strtok(p, ",\r\n");
+        char* f1 = strtok(nullptr, ",\r\n");
+        char* f2 = strtok(nullptr, ",\r\n");
+        char* f3 = strtok(nullptr, ",\r\n");
+        char* f4 = strtok(nullptr, ",\r\n");
+
+        CsvRow r;
+        if (!f0 || !parseTime(f0, r.epoch)) {
+            if (rows.empty()) continue;     // Header
+            fprintf(stderr, "%s:%d: ugyldig tid\n", path, lineNo);
+            fclose(f);
+            return false;
+        }
+        r.in.lux = f1 ? (float)atof(f1) : 0.0f;
+        r.in.pir1 = f2 && atoi(f2) != 0;
+        r.in.pir2 = f3 && atoi(f3) != 0;
+        r.in.hwsw = f4 && atoi(f4) != 0;
+        if (!rows.empty() && r.epoch < rows.back().epoch) {
+            fprintf(stderr, "%s:%d: tiden går baglæns\n", path, lineNo);
+            fclose(f);
+            return false;
+        }
+        rows.push_back(r);
+    }
+    fclose(f);
+    return !rows.empty();
+}
+
+/** "START,END[,MASK[,LEVEL]]" → næste ledige segment. */
+static bool addSegment(LysParam& p, const char* arg) {
+    if (p.segCount >= LYS_MAX_SEGMENTS) return false;
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%s", arg);
+    char* f[4] = {};
+    int n = 0;
+    for (char* tok = strtok(buf, ","); tok && n < 4; tok = strtok(nullptr, ",")) f[n++] = tok;
+    LysSegment sg;
+    if (n < 2 || !parseSegTime(f[0], sg.start) || !parseSegTime(f[1], sg.end)) return false;
+    sg.enabled = true;
+    if (n > 2) sg.weekMask = (uint8_t)(strtol(f[2], nullptr, 0) & 0x7F);
+    if (n > 3) sg.level = (int8_t)constrain(atoi(f[3]), -1, 100);
+    if (sg.weekMask == 0) sg.weekMask = 0x7F;
+    p.segs[p.segCount++] = sg;
+    return true;
+}
+
+static void usage() {
+    fprintf(stderr,
+            "Brug: lyssim [--mode Tid|Klokken|Astro] [--klokken HH:MM] [--seg START,END[,MASK[,LEVEL]]]...\n"
+            "             [--lat N] [--lon N] [--sunset-offset MIN] [--sunrise-offset MIN]\n"
+            "             [--pwm A,C,E,G] [--timer A,C,E] [--luxstart LUX] [--delay SEK] [--changes] input.csv\n");
+}
+
+int main(int argc, char** argv) {
+    LysParam p;
+    bool changesOnly = false;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool ok = true;
+        if (!strcmp(a, "--changes")) { changesOnly = true; continue; }
+        if (a[0] != '-') { path = a; continue; }
+        if (!v) { usage(); return 2; }
+        i++;
+        if (!strcmp(a, "--mode")) {
+            ok = parseLysMode(v, p.styringsvalg);
+            if (p.styringsvalg == MODE_ASTRO) p.astroEnabled = true;
+        } else if (!strcmp(a, "--klokken")) {
+            ok = sscanf(v, "%d:%d", &p.slutKlokkeTimer, &p.slutKlokkeMinutter) == 2;
+        } else if (!strcmp(a, "--seg")) {
+            ok = addSegment(p, v);
+        } else if (!strcmp(a, "--lat")) {
+            p.astroLat = (float)atof(v);
+        } else if (!strcmp(a, "--lon")) {
+            p.astroLon = (float)atof(v);
+        } else if (!strcmp(a, "--sunset-offset")) {
+            p.astroSunsetOffsetMin = atoi(v);
+        } else if (!strcmp(a, "--sunrise-offset")) {
+            p.astroSunriseOffsetMin = atoi(v);
+        } else if (!strcmp(a, "--pwm")) {
+            ok = sscanf(v, "%d,%d,%d,%d", &p.pwmA, &p.pwmC, &p.pwmE, &p.pwmG) == 4;
+        } else if (!strcmp(a, "--timer")) {
+            ok = sscanf(v, "%ld,%ld,%ld", &p.timerA, &p.timerC, &p.timerE) == 3;
+        } else if (!strcmp(a, "--luxstart")) {
+            p.luxstartvaerdi = (float)atof(v);
+        } else if (!strcmp(a, "--delay")) {
+            p.natdagdelay = atol(v);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "Ugyldig option: %s %s\n", a, v);
+            usage();
+            return 2;
+        }
+    }
+    if (!path) { usage(); return 2; }
+
+    setenv("TZ", SIM_TZ, 1);        // Lokal tid i CSV fortolkes som på controlleren
+    tzset();
+
+    std::vector<CsvRow> rows;
+    if (!readCsv(path, rows)) return 1;
+
+    LysSim sim(p, rows.front().epoch);
+    printf("epoch,local,state,lys,pwm,nat,forced\n");
+
+    SimSample last{};
+    bool first = true;
+    size_t next = 0;
+    SimInput in = rows.front().in;
+    while (sim.now() < rows.back().epoch) {
+        while (next < rows.size() && rows[next].epoch <= sim.now()) in = rows[next++].in;
+        SimSample s = sim.step(in);
+        if (changesOnly && !first && s.sameAs(last)) continue;
+        first = false;
+        last = s;
+        char local[20];
+        EpochClock::formatLocal(s.epoch, local, sizeof(local));
+        printf("%lu,%s,%s,%d,%d,%d,%d\n", (unsigned long)s.epoch, local, autoStateName(s.state), s.lys, s.pwm,
+               s.nat ? 1 : 0, s.forced ? 1 : 0);
+    }
+
+    fprintf(stderr, "lyssim: %lu sekunder, nat→dag %lu, dag→nat %lu, pir1 %lu, pir2 %lu\n",
+            (unsigned long)(rows.back().epoch - rows.front().epoch), (unsigned long)sim.events(nataktivfalse),
+            (unsigned long)sim.events(nataktivtrue), (unsigned long)sim.events(pir1_detection),
+            (unsigned long)sim.events(pir2_detection));
+    return 0;
+}
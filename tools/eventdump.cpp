@@ -0,0 +1,124 @@
+/**
+ * @file eventdump.cpp
+ * @brief Dekoder /events.bin (binær event-log) til tekstlog-format eller CSV på PC.
+ *
+ * Byg:
+ *     g++ -std=c++17 -O2 -o eventdump tools/eventdump.cpp
+ *
+ * Brug:
+ *     eventdump [--csv] [--utc] [--file nat|pir|hw] events.bin
+ *
+ * Tekst (standard) giver samme linjer som nataktiv.log / pir.log / hardware.log,
+ * tidsstemplet i dansk tid (CET/CEST) som på controlleren, eller UTC med --utc.
+ * --file vælger kun de events der ville være havnet i den pågældende tekstlog.
+ * CSV: epoch_ms,time,file,code,event,arg – én række pr. record.
+ *
+ * Ugyldige bytes (fx en halvt skrevet record ved strømsvigt) springes over ved
+ * at lede efter næste record med gyldig magic og kode; antallet skrives på stderr.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include "../EventRecord.h"
+
+static const char* logFileName(LogFileId f) {
+    switch (f) {
+        case LOG_NAT: return "nataktiv";
+        case LOG_PIR: return "pir";
+        case LOG_HW:  return "hardware";
+        default:      return "-";
+    }
+}
+
+static bool validAt(const std::vector<unsigned char>& data, size_t off, EventRecord& r) {
+    if (off + sizeof(EventRecord) > data.size()) return false;
+    memcpy(&r, data.data() + off, sizeof(r));
+    return r.magic == EVENT_RECORD_MAGIC && r.code < LYSLOG_EVENT_COUNT && r.ms < 1000 &&
+           eventLogFile(r.code) != LOG_NONE;
+}
+
+static void formatTime(uint32_t epoch, bool utc, char* buf, size_t size) {
+    time_t t = (time_t)epoch;
+    tm ti;
+    if (utc) gmtime_r(&t, &ti);
+    else localtime_r(&t, &ti);
+    strftime(buf, size, "%Y-%m-%d %H:%M:%S", &ti);
+}
+
+static int usage() {
+    fprintf(stderr, "Brug: eventdump [--csv] [--utc] [--file nat|pir|hw] events.bin\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    bool csv = false, utc = false;
+    int only = -1;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) csv = true;
+        else if (strcmp(argv[i], "--utc") == 0) utc = true;
+        else if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+            const char* f = argv[++i];
+            if (strcmp(f, "nat") == 0) only = LOG_NAT;
+            else if (strcmp(f, "pir") == 0) only = LOG_PIR;
+            else if (strcmp(f, "hw") == 0) only = LOG_HW;
+            else return usage();
+        } else if (argv[i][0] == '-') return usage();
+        else path = argv[i];
+    }
+    if (!path) return usage();
+
+    // Samme tidszone som controlleren (lysstyringV2.ino), medmindre --utc
+    if (!utc) {
+        setenv("TZ", "CET-1CEST,M3.5.0/2,M10.5.0/3", 1);
+        tzset();
+    }
+
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    std::vector<unsigned char> data;
+    unsigned char chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + n);
+    fclose(f);
+
+    if (csv) printf("epoch_ms,time,file,code,event,arg\n");
+
+    size_t off = 0, records = 0, skipped = 0;
+    char tbuf[24], text[96];
+    while (off + sizeof(EventRecord) <= data.size()) {
+        EventRecord r;
+        if (!validAt(data, off, r)) {
+            off++;
+            skipped++;
+            continue;
+        }
+        off += sizeof(EventRecord);
+        records++;
+
+        LogFileId lf = eventLogFile(r.code);
+        if (only >= 0 && lf != only) continue;
+
+        formatTime(r.epoch, utc, tbuf, sizeof(tbuf));
+        eventText(r.code, r.arg, text, sizeof(text));
+        if (csv) {
+            printf("%llu,%s,%s,%u,\"%s\",%lu\n",
+                   (unsigned long long)r.epoch * 1000ULL + r.ms, tbuf, logFileName(lf),
+                   (unsigned)r.code, text, (unsigned long)r.arg);
+        } else {
+            printf("[%s] %s\n", tbuf, text);
+        }
+    }
+    skipped += data.size() - off;
+
+    fprintf(stderr, "%zu records, %zu ugyldige bytes sprunget over\n", records, skipped);
+    return 0;
+}
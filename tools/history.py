@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""
+history.py – henter sensorhistorik fra controllerens /history og skriver CSV.
+
+Svaret er binært (SensorHistory.h): 16-byte header + 6-byte records
+(min, avg, max som 16-bit koder, ældste først). Koderne dekodes her med
+samme skala som histDecode() i firmwaren.
+
+Eksempler:
+    python3 tools/history.py 192.168.1.50                      # lux, 1 min opløsning
+    python3 tools/history.py 192.168.1.50 --sensor temp --res 15m
+    python3 tools/history.py 192.168.1.50 --res 1s -n 120 > lux.csv
+"""
+
+import argparse
+import datetime
+import http.client
+import struct
+import sys
+
+GAP = 0xFFFF
+SENSORS = {0: "lux", 1: "temp", 2: "pressure"}
+
+
+def decode(sensor, code):
+    if code == GAP:
+        return None
+    if sensor == 0:
+        return code / 10.0 if code < 10000 else 1000.0 + (code - 10000) * 4.0
+    if sensor == 1:
+        return code / 100.0 - 50.0
+    return code / 50.0 + 300.0
+
+
+def fmt(v):
+    return "" if v is None else "%.2f" % v
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("host")
+    ap.add_argument("--port", type=int, default=80)
+    ap.add_argument("--sensor", default="lux", choices=["lux", "temp", "pressure"])
+    ap.add_argument("--res", default="1m", choices=["1s", "1m", "15m"])
+    ap.add_argument("-n", type=int, default=None, help="kun de nyeste n records")
+    ap.add_argument("--utc", action="store_true", help="tid i UTC (ellers lokal tid)")
+    args = ap.parse_args()
+
+    path = "/history?sensor=%s&res=%s" % (args.sensor, args.res)
+    if args.n is not None:
+        path += "&n=%d" % args.n
+    conn = http.client.HTTPConnection(args.host, args.port, timeout=10)
+    conn.request("GET", path)
+    resp = conn.getresponse()
+    data = resp.read()
+    if resp.status != 200:
+        sys.exit("HTTP %d: %s" % (resp.status, data.decode(errors="replace").strip()))
+
+    magic, version, sensor, res, recsize, last, count = struct.unpack_from("<2sBBHHII", data, 0)
+    if magic != b"LH" or version != 1:
+        sys.exit("Ukendt format")
+
+    print("time,%s_min,%s_avg,%s_max" % ((SENSORS.get(sensor, "?"),) * 3))
+    for i in range(count):
+        off = 16 + i * recsize
+        if off + 6 > len(data):
+            break
+        lo, avg, hi = struct.unpack_from("<HHH", data, off)
+        epoch = last - (count - 1 - i) * res
+        if args.utc:
+            t = datetime.datetime.fromtimestamp(epoch, datetime.timezone.utc)
+        else:
+            t = datetime.datetime.fromtimestamp(epoch)
+        print("%s,%s,%s,%s" % (t.strftime("%Y-%m-%d %H:%M:%S"),
+                               fmt(decode(sensor, lo)), fmt(decode(sensor, avg)), fmt(decode(sensor, hi))))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""
+loadtest.py – måler requests/s mod controllerens webserver.
+
+Kører samme scriptede belastning (status-poll + slider-ændringer) to gange:
+  close      – ny TCP-forbindelse pr. request (som før keep-alive)
+  keepalive  – én persistent HTTP/1.1 forbindelse pr. klient
+
+Eksempel:
+    python3 tools/loadtest.py 192.168.1.50 --requests 300 --clients 2
+
+Med --download måles i stedet download-hastighed (KB/s) for en fil på SD,
+samt genoptagelse med Range (sidste halvdel hentes som 206 og sammenlignes):
+    python3 tools/loadtest.py 192.168.1.50 --download /pir.log
+"""
+
+import argparse
+import http.client
+import threading
+import time
+
+# Scriptet belastning: hvad index.htm gør når brugeren trækker i slideren
+SCRIPT = [
+    "/status.htm",
+    "/?value=40",
+    "/statusjson.htm",
+    "/?value=60",
+    "/index.htm",
+]
+
+
+def run_client(host, port, n, keepalive, result, idx):
+    ok = 0
+    err = 0
+    conn = None
+    for i in range(n):
+        path = SCRIPT[i % len(SCRIPT)]
+        try:
+            if conn is None:
+                conn = http.client.HTTPConnection(host, port, timeout=5)
+            headers = {"Accept-Encoding": "gzip"}
+            if not keepalive:
+                headers["Connection"] = "close"
+            conn.request("GET", path, headers=headers)
+            resp = conn.getresponse()
+            resp.read()
+            if resp.status in (200, 304):
+                ok += 1
+            else:
+                err += 1
+            if not keepalive or resp.will_close:
+                conn.close()
+                conn = None
+        except (OSError, http.client.HTTPException):
+            err += 1
+            if conn is not None:
+                conn.close()
+            conn = None
+    if conn is not None:
+        conn.close()
+    result[idx] = (ok, err)
+
+
+def run(host, port, requests, clients, keepalive):
+    per_client = max(1, requests // clients)
+    result = [None] * clients
+    threads = [threading.Thread(target=run_client,
+                                args=(host, port, per_client, keepalive, result, i))
+               for i in range(clients)]
+    t0 = time.monotonic()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    dt = time.monotonic() - t0
+    ok = sum(r[0] for r in result)
+    err = sum(r[1] for r in result)
+    return ok, err, dt
+
+
+def download(host, port, path):
+    """Hent path helt og derefter sidste halvdel via Range. Returnerer (bytes, sekunder)."""
+    conn = http.client.HTTPConnection(host, port, timeout=10)
+    t0 = time.monotonic()
+    conn.request("GET", "/download?path=" + path)
+    resp = conn.getresponse()
+    data = resp.read()
+    dt = time.monotonic() - t0
+    if resp.status != 200:
+        raise SystemExit("download: HTTP %d" % resp.status)
+    if resp.getheader("Accept-Ranges") != "bytes":
+        print("advarsel: ingen Accept-Ranges: bytes")
+
+    half = len(data) // 2
+    conn.request("GET", "/download?path=" + path, headers={"Range": "bytes=%d-" % half})
+    resp = conn.getresponse()
+    part = resp.read()
+    conn.close()
+    resumed = resp.status == 206 and part == data[half:]
+    print("range      %s (%s)" % ("ok" if resumed else "FEJL", resp.getheader("Content-Range")))
+    return len(data), dt
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("host")
+    ap.add_argument("--port", type=int, default=80)
+    ap.add_argument("--requests", type=int, default=200, help="requests pr. mode (i alt)")
+    ap.add_argument("--clients", type=int, default=1, help="samtidige klienter (max WEB_MAX_CONN - SSE)")
+    ap.add_argument("--mode", choices=["both", "close", "keepalive"], default="both")
+    ap.add_argument("--download", metavar="PATH", help="mål download KB/s for PATH (fx /pir.log)")
+    args = ap.parse_args()
+
+    if args.download:
+        n, dt = download(args.host, args.port, args.download)
+        print("download   %d bytes  %6.2f s  %7.1f KB/s" % (n, dt, n / 1024.0 / dt if dt > 0 else 0.0))
+        return
+
+    modes = ["close", "keepalive"] if args.mode == "both" else [args.mode]
+    for mode in modes:
+        ok, err, dt = run(args.host, args.port, args.requests, args.clients, mode == "keepalive")
+        print("%-10s %5d ok %4d fejl  %6.2f s  %7.1f req/s"
+              % (mode, ok, err, dt, ok / dt if dt > 0 else 0.0))
+
+
+if __name__ == "__main__":
+    main()
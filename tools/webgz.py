@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+webgz.py – pakker de statiske web-filer i web/ til WebStatic.h.
+
+Hver fil minificeres (indrykning fjernes), gzip'es (niveau 9, mtime=0 så
+output er reproducerbart) og skrives som et const byte-array (ligger i flash
+på RP2040) sammen med Content-Type og et ETag (FNV-1a 32 bit af de
+komprimerede bytes).
+
+Kør fra repo-roden efter ændringer i web/:
+    python3 tools/webgz.py
+"""
+
+import gzip
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+WEB_DIR = os.path.join(ROOT, "web")
+OUT = os.path.join(ROOT, "WebStatic.h")
+
+# (fil i web/, URL-path, Content-Type, C-identifier)
+FILES = [
+    ("index.htm",       "/index.htm",       "text/html; charset=utf-8",       "index_htm"),
+    ("filebrowser.htm", "/filebrowser.htm", "text/html; charset=utf-8",       "filebrowser_htm"),
+    ("opsaetning.css",  "/opsaetning.css",  "text/css; charset=utf-8",        "opsaetning_css"),
+    ("opsaetning.js",   "/opsaetning.js",   "application/javascript; charset=utf-8", "opsaetning_js"),
+]
+
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def minify(raw):
+    """Fjern indrykning og tomme linjer (sikkert for vores HTML/CSS/JS – ingen <pre>)."""
+    lines = [l.strip() for l in raw.decode("utf-8").split("\n")]
+    return "\n".join(l for l in lines if l).encode("utf-8")
+
+
+def c_array(name, data):
+    lines = []
+    for i in range(0, len(data), 16):
+        chunk = data[i:i + 16]
+        lines.append("    " + ", ".join("0x%02x" % b for b in chunk) + ",")
+    return "static const uint8_t webgz_%s[] PROGMEM = {\n%s\n};\n" % (name, "\n".join(lines))
+
+
+def main():
+    out = []
+    out.append("#pragma once\n")
+    out.append("/**\n")
+    out.append(" * @file WebStatic.h\n")
+    out.append(" * @brief Gzip-komprimerede statiske web-sider (GENERERET af tools/webgz.py – ret i web/).\n")
+    out.append(" *\n")
+    out.append(" * Serveres med Content-Encoding: gzip, Content-Length og ETag.\n")
+    out.append(" * Browseren revaliderer med If-None-Match og får 304 hvis intet er ændret.\n")
+    out.append(" */\n\n")
+    out.append("#include <Arduino.h>\n#include <cstdint>\n\n")
+    out.append("struct WebStaticFile {\n")
+    out.append("    const char*    path;\n")
+    out.append("    const char*    contentType;\n")
+    out.append("    const uint8_t* data;\n")
+    out.append("    uint32_t       len;\n")
+    out.append("    uint32_t       rawLen;\n")
+    out.append("    const char*    etag;\n")
+    out.append("};\n\n")
+
+    table = []
+    total_raw = 0
+    total_gz = 0
+    for fname, path, ctype, ident in FILES:
+        with open(os.path.join(WEB_DIR, fname), "rb") as f:
+            raw = f.read()
+        gz = gzip.compress(minify(raw), compresslevel=9, mtime=0)
+        etag = '"%08x"' % fnv1a(gz)
+        total_raw += len(raw)
+        total_gz += len(gz)
+        out.append("// %s: %d -> %d bytes\n" % (fname, len(raw), len(gz)))
+        out.append(c_array(ident, gz))
+        out.append("\n")
+        table.append('    { "%s", "%s", webgz_%s, %d, %d, "\\"%s\\"" },\n'
+                     % (path, ctype, ident, len(gz), len(raw), etag.strip('"')))
+
+    out.append("enum WebStaticId : uint8_t {\n")
+    for _, _, _, ident in FILES:
+        out.append("    WEBSTATIC_%s,\n" % ident.upper())
+    out.append("    WEBSTATIC_COUNT\n};\n\n")
+
+    out.append("static const WebStaticFile webStaticFiles[WEBSTATIC_COUNT] = {\n")
+    out.extend(table)
+    out.append("};\n")
+
+    with open(OUT, "w") as f:
+        f.write("".join(out))
+
+    print("WebStatic.h: %d filer, %d -> %d bytes (%.0f%% sparet)"
+          % (len(FILES), total_raw, total_gz, 100.0 * (1 - total_gz / float(total_raw))))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,44 @@
+function index() { location.replace('/index.htm'); }
+
+function modePreviewChanged(val) {
+  location.replace('/opsaetning.htm?previewMode=' + encodeURIComponent(val));
+}
+
+function updateValues() {
+  document.getElementById('val_pwma').textContent = pwma.value;
+  document.getElementById('val_pwmc').textContent = pwmc.value;
+  document.getElementById('val_pwme').textContent = pwme.value;
+  document.getElementById('val_pwmg').textContent = pwmg.value;
+  document.getElementById('val_luxstart').textContent = luxstart.value;
+  document.getElementById('val_delay').textContent = delay.value;
+  document.getElementById('val_stepfrekvens').textContent = stepfrekvens.value;
+}
+updateValues();
+
+// Tillægssegmenter: "22:00" → "2200", "solnedgang+15" → "s15", "solopgang-30" → "r-30"
+function segToken(v) {
+  v = v.trim().toLowerCase();
+  var m = v.match(/^(\d{1,2})[:.](\d{2})$/);
+  if (m) return ('0' + m[1]).slice(-2) + m[2];
+  m = v.match(/^sol(nedgang|opgang)\s*([+-]\d+)?$/);
+  if (m) return (m[1] == 'nedgang' ? 's' : 'r') + (m[2] ? parseInt(m[2], 10) : '');
+  return null;
+}
+
+// Pak segment-rækkerne i det skjulte felt "segs": on.mask.niveau.start.slut_… (rækker uden start/slut udelades)
+function packSegments() {
+  var out = document.getElementById('segs');
+  if (!out) return;
+  var rows = [];
+  document.querySelectorAll('.seg-row').forEach(function (r) {
+    var s = segToken(r.querySelector('.seg-start').value);
+    var e = segToken(r.querySelector('.seg-end').value);
+    if (s === null || e === null) return;
+    var mask = 0;
+    r.querySelectorAll('.seg-day:checked').forEach(function (d) { mask |= parseInt(d.value, 10); });
+    rows.push([r.querySelector('.seg-on').checked ? 1 : 0, mask,
+               r.querySelector('.seg-level').value.trim(), s, e].join('.'));
+  });
+  out.value = rows.join('_');
+}
+document.querySelector('form').addEventListener('submit', packSegments);